@@ -541,7 +541,7 @@ iwasm_main(int argc, char *argv[])
 
     /* initialize dyntype context and set callback dispatcher */
     dyn_ctx_t dyn_ctx = dyntype_context_init();
-    dyntype_set_callback_dispatcher(dyntype_callback_wasm_dispatcher);
+    dyntype_set_callback_dispatcher(dyn_ctx, dyntype_callback_wasm_dispatcher);
 
     /* Register APIs required by ts2wasm */
     NativeSymbol *native_symbols;
@@ -11,8 +11,8 @@ export namespace BuiltinNames {
     export const stackPointer = '__stack_pointer';
     export const heapBase = '__heap_base';
 
-    // wasm table
-    export const extrefTable = 'extref_table';
+    // wasm objects referred to by extrefs, rooted by this global
+    export const extrefSlots = 'extref_slots';
 
     // wasm default variable
     export const byteSize = 32;
@@ -21,7 +21,6 @@ export namespace BuiltinNames {
     export const memMaximumPages = 10;
     export const tableInitialPages = 1;
     export const tableMaximumPages = 10;
-    export const tableGrowDelta = 10;
     export const memoryReserveOffset = 0;
     export const memoryReserveMaxSize = 100;
 
@@ -58,6 +57,7 @@ export namespace BuiltinNames {
     export const globalInitFuncName = 'global|init|func';
     export const findPropertyFlagAndIndex = 'find_property_flag_and_index';
     export const findPropertyType = 'find_property_type';
+    export const metaVersion = 'meta_version';
     export const getInfcProperty = 'get_infc_property';
     export const getTupleField = 'get_tuple_field';
 
@@ -123,8 +123,6 @@ export namespace BuiltinNames {
     export const stringtrimFuncName = 'String|trim';
     export const anyrefCond = 'anyrefCond';
     export const newExtRef = 'newExtRef';
-    export const allocExtRefTableSlot = 'allocExtRefTableSlot';
-    export const extRefTableMaskArr = 'extRefTableMaskArr';
     export const getPropertyIfTypeIdMismatch =
         'get_property_if_typeid_mismatch';
     export const setPropertyIfTypeIdMismatch =
@@ -173,6 +171,8 @@ export namespace BuiltinNames {
     export const arrayShiftFuncNames = createGenericFuncNames('Array', 'shift');
     export const arraySliceFuncNames = createGenericFuncNames('Array', 'slice');
     export const arraySortFuncNames = createGenericFuncNames('Array', 'sort');
+    /* sort with the canonical (a, b) => a - b or b - a comparator */
+    export const arraySortNumericFuncName = 'Array|sort_numeric';
     export const arraySpliceFuncNames = createGenericFuncNames(
         'Array',
         'splice',
@@ -6,18 +6,307 @@
 #include "type.h"
 #include "pure_dynamic.h"
 
-static dyn_ctx_t g_dynamic_context = NULL;
+#ifndef os_thread_local_attribute
+#define os_thread_local_attribute __thread
+#endif
 
+/* Each context owns its own runtime, see dyntype_context_set_exec_env */
+static os_thread_local_attribute dyn_ctx_t tls_dynamic_context = NULL;
+
+extern int
+dynamic_extref_class_init(dyn_ctx_t ctx);
+
+static DynValueSlot *
+value_arena_grow(DynTypeContext *ctx)
+{
+    DynValueArena *arena = &ctx->value_arena;
+    DynValueSlotPage *page;
+    int i;
+
+    page = js_malloc_rt(ctx->js_rt, sizeof(DynValueSlotPage));
+    if (!page) {
+        return NULL;
+    }
+
+    for (i = DYN_VALUE_SLOTS_PER_PAGE - 1; i >= 0; i--) {
+        page->slots[i].next_free = arena->free_list;
+        arena->free_list = &page->slots[i];
+    }
+
+    page->next = arena->pages;
+    arena->pages = page;
+    arena->page_count++;
+
+    return arena->free_list;
+}
+
+/* Release the values of the boxes still in use, must be called before the
+ * JSContext is freed so that no object outlives it */
+static void
+value_arena_destroy(DynTypeContext *ctx)
+{
+    DynValueArena *arena = &ctx->value_arena;
+    DynValueSlotPage *page, *next;
+    DynValueSlot *slot, *next_free;
+    int i;
+
+    /* free slots hold a link instead of a value */
+    for (slot = arena->free_list; slot; slot = next_free) {
+        next_free = slot->next_free;
+        slot->value = JS_UNDEFINED;
+    }
+
+    /* finalizers may run, the pages are only freed once every value is */
+    for (page = arena->pages; page; page = page->next) {
+        for (i = 0; i < DYN_VALUE_SLOTS_PER_PAGE; i++) {
+            JS_FreeValueRT(ctx->js_rt, page->slots[i].value);
+            page->slots[i].value = JS_UNDEFINED;
+        }
+    }
+
+    for (page = arena->pages; page; page = next) {
+        next = page->next;
+        js_free_rt(ctx->js_rt, page);
+    }
+
+    memset(arena, 0, sizeof(DynValueArena));
+}
+
+/* Box a JSValue into a slot of the context arena, the reference held by
+ * value is transferred to the box */
 JSValue *
 dynamic_dup_value(JSContext *ctx, JSValue value)
 {
-    JSValue *ptr = js_malloc(ctx, sizeof(value));
+    DynTypeContext *dyn_ctx = JS_GetContextOpaque(ctx);
+    DynValueSlot *slot = dyn_ctx->value_arena.free_list;
 
-    if (!ptr) {
+    if (!slot && !(slot = value_arena_grow(dyn_ctx))) {
         return NULL;
     }
-    memcpy(ptr, &value, sizeof(value));
-    return ptr;
+
+    dyn_ctx->value_arena.free_list = slot->next_free;
+    slot->value = value;
+
+    return &slot->value;
+}
+
+/* Return a box to the arena, the boxed JSValue is not freed */
+void
+dynamic_free_box(JSContext *ctx, JSValue *ptr)
+{
+    DynTypeContext *dyn_ctx = JS_GetContextOpaque(ctx);
+    DynValueSlot *slot = (DynValueSlot *)ptr;
+
+    slot->next_free = dyn_ctx->value_arena.free_list;
+    dyn_ctx->value_arena.free_list = slot;
+}
+
+/******************* Atom cache *******************/
+
+#define ATOM_CACHE_INIT_SIZE 256
+
+/* Names resolved through the string based property APIs are cached up to
+ * this count, so computed keys can't grow the cache without bound. Atoms
+ * requested through dynamic_new_atom are always cached */
+#define ATOM_CACHE_MAX_COUNT 16384
+
+/* FNV-1a over the name bytes */
+static uint32_t
+atom_cache_hash(const char *name, uint32_t length)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/* Linear probing, entries are never removed so an empty entry terminates
+ * the probe sequence */
+static DynAtomCacheEntry *
+atom_cache_lookup(DynAtomCache *cache, const char *name, uint32_t hash)
+{
+    uint32_t mask = cache->capacity - 1;
+    uint32_t i = hash & mask;
+
+    while (cache->entries[i].name) {
+        DynAtomCacheEntry *entry = &cache->entries[i];
+
+        if (entry->hash == hash && strcmp(entry->name, name) == 0) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return &cache->entries[i];
+}
+
+static bool
+atom_cache_resize(DynTypeContext *ctx, uint32_t capacity)
+{
+    DynAtomCache *cache = &ctx->atom_cache;
+    DynAtomCacheEntry *old_entries = cache->entries;
+    uint32_t old_capacity = cache->capacity;
+    uint32_t i, mask = capacity - 1;
+    DynAtomCacheEntry *entries;
+
+    entries = js_mallocz_rt(ctx->js_rt, sizeof(DynAtomCacheEntry) * capacity);
+    if (!entries) {
+        return false;
+    }
+
+    for (i = 0; i < old_capacity; i++) {
+        uint32_t j;
+
+        if (!old_entries[i].name) {
+            continue;
+        }
+
+        j = old_entries[i].hash & mask;
+        while (entries[j].name) {
+            j = (j + 1) & mask;
+        }
+        entries[j] = old_entries[i];
+    }
+
+    if (old_entries) {
+        js_free_rt(ctx->js_rt, old_entries);
+    }
+    cache->entries = entries;
+    cache->capacity = capacity;
+
+    return true;
+}
+
+static bool
+atom_cache_grow(DynTypeContext *ctx)
+{
+    uint32_t capacity = ctx->atom_cache.capacity;
+
+    return atom_cache_resize(ctx,
+                             capacity ? capacity * 2 : ATOM_CACHE_INIT_SIZE);
+}
+
+/* Size the cache for count names, keeping the load factor below 3/4 */
+static bool
+atom_cache_reserve(DynTypeContext *ctx, uint32_t count)
+{
+    uint32_t capacity = ATOM_CACHE_INIT_SIZE;
+
+    if (count > ATOM_CACHE_MAX_COUNT) {
+        count = ATOM_CACHE_MAX_COUNT;
+    }
+
+    while (capacity * 3 < count * 4) {
+        capacity <<= 1;
+    }
+
+    return atom_cache_resize(ctx, capacity);
+}
+
+/* Return the cached atom of name, the reference is owned by the cache */
+static JSAtom
+atom_cache_get(DynTypeContext *ctx, const char *name, bool pin)
+{
+    DynAtomCache *cache = &ctx->atom_cache;
+    uint32_t length = (uint32_t)strlen(name);
+    uint32_t hash = atom_cache_hash(name, length);
+    DynAtomCacheEntry *entry = NULL;
+    char *copy;
+    JSAtom atom;
+
+    if (cache->entries) {
+        entry = atom_cache_lookup(cache, name, hash);
+        if (entry->name) {
+            return entry->atom;
+        }
+    }
+
+    if (!pin && cache->count >= ATOM_CACHE_MAX_COUNT) {
+        return JS_ATOM_NULL;
+    }
+
+    /* keep load factor below 3/4 */
+    if ((cache->count + 1) * 4 > cache->capacity * 3) {
+        if (!atom_cache_grow(ctx)) {
+            return JS_ATOM_NULL;
+        }
+        entry = atom_cache_lookup(cache, name, hash);
+    }
+
+    atom = JS_NewAtomLen(ctx->js_ctx, name, length);
+    if (atom == JS_ATOM_NULL) {
+        return JS_ATOM_NULL;
+    }
+
+    copy = js_malloc_rt(ctx->js_rt, length + 1);
+    if (!copy) {
+        JS_FreeAtom(ctx->js_ctx, atom);
+        return JS_ATOM_NULL;
+    }
+    memcpy(copy, name, length + 1);
+
+    entry->hash = hash;
+    entry->atom = atom;
+    entry->name = copy;
+    cache->count++;
+
+    return atom;
+}
+
+static void
+atom_cache_destroy(DynTypeContext *ctx)
+{
+    DynAtomCache *cache = &ctx->atom_cache;
+    uint32_t i;
+
+    for (i = 0; i < cache->capacity; i++) {
+        if (cache->entries[i].name) {
+            JS_FreeAtom(ctx->js_ctx, cache->entries[i].atom);
+            js_free_rt(ctx->js_rt, cache->entries[i].name);
+        }
+    }
+
+    if (cache->entries) {
+        js_free_rt(ctx->js_rt, cache->entries);
+    }
+    memset(cache, 0, sizeof(DynAtomCache));
+}
+
+/* Resolve a property name, the returned reference must be released with
+ * JS_FreeAtom */
+JSAtom
+dynamic_acquire_atom(dyn_ctx_t ctx, const char *name)
+{
+    JSAtom atom = atom_cache_get(ctx, name, false);
+
+    if (atom != JS_ATOM_NULL) {
+        return JS_DupAtom(ctx->js_ctx, atom);
+    }
+
+    return JS_NewAtom(ctx->js_ctx, name);
+}
+
+dyn_atom_t
+dynamic_new_atom(dyn_ctx_t ctx, const char *name)
+{
+    return atom_cache_get(ctx, name, true);
+}
+
+const char *
+dynamic_atom_to_cstring(dyn_ctx_t ctx, dyn_atom_t atom)
+{
+    return JS_AtomToCString(ctx->js_ctx, atom);
+}
+
+void
+dynamic_free_atom_cstring(dyn_ctx_t ctx, const char *str)
+{
+    JS_FreeCString(ctx->js_ctx, str);
 }
 
 /******************* Initialization and destroy *****************/
@@ -25,12 +314,13 @@ dynamic_dup_value(JSContext *ctx, JSValue value)
 dyn_ctx_t
 dynamic_context_init()
 {
-    JSClassID class_id;
-    dyn_ctx_t ctx = NULL;
+    return dynamic_context_init_with_opt(NULL);
+}
 
-    if (g_dynamic_context) {
-        return g_dynamic_context;
-    }
+dyn_ctx_t
+dynamic_context_init_with_opt(dyn_options_t *options)
+{
+    dyn_ctx_t ctx = NULL;
 
     ctx = malloc(sizeof(DynTypeContext));
     if (!ctx) {
@@ -42,10 +332,24 @@ dynamic_context_init()
     if (!ctx->js_rt) {
         goto fail;
     }
+
+    if (options) {
+        if (options->memory_limit) {
+            JS_SetMemoryLimit(ctx->js_rt, (size_t)options->memory_limit);
+        }
+        if (options->gc_threshold) {
+            JS_SetGCThreshold(ctx->js_rt, (size_t)options->gc_threshold);
+        }
+        if (options->max_stack_size) {
+            JS_SetMaxStackSize(ctx->js_rt, (size_t)options->max_stack_size);
+        }
+    }
     ctx->js_ctx = JS_NewContext(ctx->js_rt);
     if (!ctx->js_ctx) {
         goto fail;
     }
+    JS_SetContextOpaque(ctx->js_ctx, ctx);
+    JS_SetRuntimeOpaque(ctx->js_rt, ctx);
 
     ctx->js_undefined = dynamic_dup_value(ctx->js_ctx, JS_UNDEFINED);
     if (!ctx->js_undefined) {
@@ -57,12 +361,18 @@ dynamic_context_init()
         goto fail;
     }
 
-    class_id = 0;
-    ctx->extref_class_id = JS_NewClassID(&class_id);
+    if (dynamic_extref_class_init(ctx) != DYNTYPE_SUCCESS) {
+        goto fail;
+    }
 
-    (void)class_id;
+    if (options && options->property_table_size
+        && !atom_cache_reserve(ctx, options->property_table_size)) {
+        goto fail;
+    }
 
-    g_dynamic_context = ctx;
+    if (!tls_dynamic_context) {
+        tls_dynamic_context = ctx;
+    }
     return ctx;
 
 fail:
@@ -70,24 +380,20 @@ fail:
     return NULL;
 }
 
-dyn_ctx_t
-dynamic_context_init_with_opt(dyn_options_t *options)
-{
-    // TODO
-    return NULL;
-}
-
 void
 dynamic_context_destroy(dyn_ctx_t ctx)
 {
     if (ctx) {
-        if (ctx->js_undefined) {
-            js_free(ctx->js_ctx, ctx->js_undefined);
-        }
-        if (ctx->js_null) {
-            js_free(ctx->js_ctx, ctx->js_null);
-        }
+        /* js_undefined and js_null live in the arena */
+        value_arena_destroy(ctx);
         if (ctx->js_ctx) {
+            atom_cache_destroy(ctx);
+            if (JS_IsObject(ctx->extref_proto)) {
+                JS_FreeValue(ctx->js_ctx, ctx->extref_proto);
+            }
+            if (JS_IsObject(ctx->extref_func_proto)) {
+                JS_FreeValue(ctx->js_ctx, ctx->extref_func_proto);
+            }
             JS_FreeContext(ctx->js_ctx);
         }
         if (ctx->js_rt) {
@@ -96,11 +402,25 @@ dynamic_context_destroy(dyn_ctx_t ctx)
         free(ctx);
     }
 
-    g_dynamic_context = NULL;
+    if (tls_dynamic_context == ctx) {
+        tls_dynamic_context = NULL;
+    }
+}
+
+DynHostData *
+dynamic_get_host_data(dyn_ctx_t ctx)
+{
+    return &ctx->host;
+}
+
+void
+dynamic_set_context(dyn_ctx_t ctx)
+{
+    tls_dynamic_context = ctx;
 }
 
 dyn_ctx_t
 dynamic_get_context()
 {
-    return g_dynamic_context;
+    return tls_dynamic_context;
 }
@@ -5,10 +5,18 @@
 #include "quickjs-wamr.h"
 #include "libdyntype_export.h"
 #include "type.h"
+#include "extref/extref.h"
+#include <pthread.h>
 
 extern JSValue *
 dynamic_dup_value(JSContext *ctx, JSValue value);
 
+extern void
+dynamic_free_box(JSContext *ctx, JSValue *ptr);
+
+extern JSAtom
+dynamic_acquire_atom(dyn_ctx_t ctx, const char *name);
+
 /******************* builtin type compare *******************/
 static inline bool
 number_cmp(double lhs, double rhs, cmp_operator operator_kind)
@@ -178,75 +186,311 @@ quickjs_type_to_dyn_type(int quickjs_tag)
     return DynUnknown;
 }
 
+/* Callbacks with up to this number of arguments don't allocate the boxed
+ * argument array */
+#define CALLBACK_INLINE_ARGS 8
+
 static JSValue
-WasmCallBackDataForJS(JSContext *ctx, JSValueConst this_obj, int argc,
-                      JSValueConst *argv, int magic, JSValue *func_data)
+call_wasm_callback(JSContext *ctx, JSValueConst this_obj, int argc,
+                   JSValueConst *argv, void *vfunc, void *exec_env)
 {
     JSValue ret;
-    void *vfunc = JS_GetOpaque(func_data[0], JS_CLASS_OBJECT);
-    void *exec_env = JS_GetOpaque(func_data[1], JS_CLASS_OBJECT);
-    dyn_ctx_t dyntype_ctx = JS_GetOpaque(func_data[2], JS_CLASS_OBJECT);
-    dyn_value_t *args = NULL;
+    dyn_ctx_t dyntype_ctx = JS_GetContextOpaque(ctx);
+    dyn_value_t args_buf[CALLBACK_INLINE_ARGS];
+    dyn_value_t *args = args_buf;
     dyn_value_t this_dyn_obj = NULL;
     uint64_t total_size;
     dyntype_callback_dispatcher_t cb_dispatcher = NULL;
 
-    total_size = sizeof(dyn_value_t) * argc;
-    args = malloc(total_size);
+    if (argc > CALLBACK_INLINE_ARGS) {
+        total_size = sizeof(dyn_value_t) * argc;
+        args = malloc(total_size);
 
-    if (!args) {
-        return JS_NULL;
+        if (!args) {
+            return JS_NULL;
+        }
     }
 
+    /* argv and this_obj are borrowed, the boxes only live during the call */
     for (int i = 0; i < argc; i++) {
         args[i] = dynamic_dup_value(ctx, *(argv + i));
     }
     this_dyn_obj = dynamic_dup_value(ctx, this_obj);
 
-    cb_dispatcher = dyntype_get_callback_dispatcher();
+    cb_dispatcher = dyntype_get_callback_dispatcher(dyntype_ctx);
     if (cb_dispatcher) {
         dyn_value_t res_boxed = cb_dispatcher(
             exec_env, dyntype_ctx, vfunc, this_dyn_obj, argc, args);
         ret = *(JSValue *)(res_boxed);
         if (res_boxed != dyntype_ctx->js_undefined
             && res_boxed != dyntype_ctx->js_null) {
-            js_free(dyntype_ctx->js_ctx, res_boxed);
+            dynamic_free_box(ctx, res_boxed);
         }
     }
     else {
         ret = JS_ThrowInternalError(
             ctx, "external callback dispatcher not registered");
     }
-    if (args) {
-        for (int i = 0; i < argc; i++) {
-            js_free(ctx, args[i]);
+
+    /* release in reverse order of allocation, so the boxes are reused in the
+     * same order by the next callback */
+    if (this_dyn_obj) {
+        dynamic_free_box(ctx, this_dyn_obj);
+    }
+    for (int i = argc - 1; i >= 0; i--) {
+        if (args[i]) {
+            dynamic_free_box(ctx, args[i]);
         }
+    }
+    if (args != args_buf) {
         free(args);
     }
 
-    if (this_dyn_obj) {
-        js_free(ctx, this_dyn_obj);
-    }
     return ret;
 }
 
+/******************* Extref class *******************/
+
+static DynExtref *
+get_extref(DynTypeContext *dyn_ctx, JSValueConst obj)
+{
+    DynExtref *extref = JS_GetOpaque(obj, dyn_ctx->extref_class_id);
+
+    if (!extref) {
+        extref = JS_GetOpaque(obj, dyn_ctx->extref_func_class_id);
+    }
+
+    return extref;
+}
+
+static JSValueConst
+get_extref_proto(DynTypeContext *dyn_ctx, DynExtref *extref)
+{
+    return extref->tag == ExtFunc ? dyn_ctx->extref_func_proto
+                                  : dyn_ctx->extref_proto;
+}
+
+/* Return the name of a string keyed property, or NULL for symbols and if
+ * the static fields can't be accessed */
+static const char *
+get_field_name(JSContext *ctx, JSAtom atom)
+{
+    JSValue name;
+    const char *str = NULL;
+
+    /* the static fields are read through the bound wasm instance */
+    if (!dyntype_context_get_exec_env(JS_GetContextOpaque(ctx))) {
+        return NULL;
+    }
+
+    name = JS_AtomToValue(ctx, atom);
+    if (JS_IsString(name)) {
+        str = JS_ToCString(ctx, name);
+    }
+    JS_FreeValue(ctx, name);
+
+    return str;
+}
+
+/* Static fields are looked up before the prototype chain, properties not
+ * declared by the static type are ordinary properties of the object */
 static JSValue
-new_function_wrapper(dyn_ctx_t ctx, void *vfunc, void *opaque)
-{
-    JSValue data_hold[3];
-    data_hold[0] = JS_NewObject(ctx->js_ctx);
-    JS_SetOpaque(data_hold[0], vfunc);
-    data_hold[1] = JS_NewObject(ctx->js_ctx);
-    JS_SetOpaque(data_hold[1], opaque);
-    data_hold[2] = JS_NewObject(ctx->js_ctx);
-    JS_SetOpaque(data_hold[2], ctx);
-    JSValue func =
-        JS_NewCFunctionData(ctx->js_ctx, WasmCallBackDataForJS, 0, 0, 3,
-                            data_hold); // data will be dup inside qjs
-    JS_FreeValue(ctx->js_ctx, data_hold[0]);
-    JS_FreeValue(ctx->js_ctx, data_hold[1]);
-    JS_FreeValue(ctx->js_ctx, data_hold[2]);
-    return func;
+extref_get_property_handler(JSContext *ctx, JSValueConst obj, JSAtom atom,
+                            JSValueConst receiver)
+{
+    DynTypeContext *dyn_ctx = JS_GetContextOpaque(ctx);
+    DynExtref *extref = get_extref(dyn_ctx, obj);
+    dyn_value_t field_value = NULL;
+    const char *name;
+    JSValue *obj_box, ret;
+    int found = DYNTYPE_FALSE;
+
+    if ((name = get_field_name(ctx, atom))) {
+        /* borrowed, the box doesn't hold a reference */
+        if ((obj_box = dynamic_dup_value(ctx, obj))) {
+            found = extref_get_field(dyn_ctx, obj_box, name, &field_value);
+            dynamic_free_box(ctx, obj_box);
+        }
+        JS_FreeCString(ctx, name);
+    }
+
+    if (found == DYNTYPE_TRUE) {
+        if (!field_value) {
+            return JS_UNDEFINED;
+        }
+        ret = *(JSValue *)field_value;
+        if (field_value != dyn_ctx->js_undefined
+            && field_value != dyn_ctx->js_null) {
+            dynamic_free_box(ctx, field_value);
+        }
+        return ret;
+    }
+
+    return JS_GetPropertyInternal(ctx, get_extref_proto(dyn_ctx, extref), atom,
+                                  receiver, FALSE);
+}
+
+static int
+extref_set_property_handler(JSContext *ctx, JSValueConst obj, JSAtom atom,
+                            JSValueConst value, JSValueConst receiver,
+                            int flags)
+{
+    DynTypeContext *dyn_ctx = JS_GetContextOpaque(ctx);
+    const char *name;
+    JSValue *obj_box, *value_box;
+    int found = DYNTYPE_FALSE;
+
+    if ((name = get_field_name(ctx, atom))) {
+        obj_box = dynamic_dup_value(ctx, obj);
+        value_box = dynamic_dup_value(ctx, value);
+        if (obj_box && value_box) {
+            found = extref_set_field(dyn_ctx, obj_box, name, value_box);
+        }
+        if (obj_box) {
+            dynamic_free_box(ctx, obj_box);
+        }
+        if (value_box) {
+            dynamic_free_box(ctx, value_box);
+        }
+        JS_FreeCString(ctx, name);
+    }
+
+    if (found == DYNTYPE_TRUE) {
+        return TRUE;
+    }
+
+    return JS_DefinePropertyValue(ctx, obj, atom, JS_DupValue(ctx, value),
+                                  JS_PROP_C_W_E | (flags & JS_PROP_THROW));
+}
+
+static int
+extref_has_property_handler(JSContext *ctx, JSValueConst obj, JSAtom atom)
+{
+    DynTypeContext *dyn_ctx = JS_GetContextOpaque(ctx);
+    DynExtref *extref = get_extref(dyn_ctx, obj);
+    const char *name;
+    JSValue *obj_box;
+    int res = DYNTYPE_FALSE;
+
+    if ((name = get_field_name(ctx, atom))) {
+        if ((obj_box = dynamic_dup_value(ctx, obj))) {
+            res = extref_has_field(dyn_ctx, obj_box, name);
+            dynamic_free_box(ctx, obj_box);
+        }
+        JS_FreeCString(ctx, name);
+    }
+
+    if (res == DYNTYPE_TRUE) {
+        return TRUE;
+    }
+
+    res = JS_GetOwnProperty(ctx, NULL, obj, atom);
+    if (res != 0) {
+        return res;
+    }
+
+    return JS_HasProperty(ctx, get_extref_proto(dyn_ctx, extref), atom);
+}
+
+static JSValue
+extref_call_handler(JSContext *ctx, JSValueConst func_obj,
+                    JSValueConst this_val, int argc, JSValueConst *argv,
+                    int flags)
+{
+    DynTypeContext *dyn_ctx = JS_GetContextOpaque(ctx);
+    DynExtref *extref = JS_GetOpaque(func_obj, dyn_ctx->extref_func_class_id);
+
+    if (!extref) {
+        return JS_ThrowTypeError(ctx, "not a function");
+    }
+
+    return call_wasm_callback(ctx, this_val, argc, argv, extref->ref,
+                              extref->opaque);
+}
+
+static void
+extref_finalizer(JSRuntime *rt, JSValue val)
+{
+    DynTypeContext *dyn_ctx = JS_GetRuntimeOpaque(rt);
+    DynExtref *extref = get_extref(dyn_ctx, val);
+    dyntype_extref_release_t release =
+        dyntype_get_extref_release_callback(dyn_ctx);
+
+    if (release) {
+        release(dyn_ctx, extref->ref, extref->tag);
+    }
+    js_free_rt(rt, extref);
+}
+
+static JSClassExoticMethods extref_exotic_methods = {
+    .get_property = extref_get_property_handler,
+    .set_property = extref_set_property_handler,
+    .has_property = extref_has_property_handler,
+};
+
+static JSClassDef extref_class_def = {
+    .class_name = "ExtRef",
+    .finalizer = extref_finalizer,
+    .exotic = &extref_exotic_methods,
+};
+
+/* Same as extref_class_def but callable, so that QuickJS treats wrapped
+ * closures as functions */
+static JSClassDef extref_func_class_def = {
+    .class_name = "ExtRefFunction",
+    .finalizer = extref_finalizer,
+    .call = extref_call_handler,
+    .exotic = &extref_exotic_methods,
+};
+
+static JSValue
+get_global_prototype(JSContext *ctx, const char *name)
+{
+    JSValue global = JS_GetGlobalObject(ctx);
+    JSValue ctor = JS_GetPropertyStr(ctx, global, name);
+    JSValue proto = JS_GetPropertyStr(ctx, ctor, "prototype");
+
+    JS_FreeValue(ctx, ctor);
+    JS_FreeValue(ctx, global);
+
+    return proto;
+}
+
+/* Class ids are process wide, every context registers the classes under the
+ * same ids in its own runtime */
+static JSClassID g_extref_class_id = 0;
+static JSClassID g_extref_func_class_id = 0;
+static pthread_once_t g_extref_class_once = PTHREAD_ONCE_INIT;
+
+static void
+extref_class_id_init()
+{
+    JS_NewClassID(&g_extref_class_id);
+    JS_NewClassID(&g_extref_func_class_id);
+}
+
+int
+dynamic_extref_class_init(dyn_ctx_t ctx)
+{
+    pthread_once(&g_extref_class_once, extref_class_id_init);
+    ctx->extref_class_id = g_extref_class_id;
+    ctx->extref_func_class_id = g_extref_func_class_id;
+
+    if (JS_NewClass(ctx->js_rt, ctx->extref_class_id, &extref_class_def) < 0
+        || JS_NewClass(ctx->js_rt, ctx->extref_func_class_id,
+                       &extref_func_class_def)
+               < 0) {
+        return -DYNTYPE_EXCEPTION;
+    }
+
+    ctx->extref_proto = get_global_prototype(ctx->js_ctx, "Object");
+    ctx->extref_func_proto = get_global_prototype(ctx->js_ctx, "Function");
+    if (!JS_IsObject(ctx->extref_proto)
+        || !JS_IsObject(ctx->extref_func_proto)) {
+        return -DYNTYPE_EXCEPTION;
+    }
+
+    return DYNTYPE_SUCCESS;
 }
 
 /******************* Field access *******************/
@@ -391,27 +635,36 @@ end:
 dyn_value_t
 dynamic_new_extref(dyn_ctx_t ctx, void *ptr, external_ref_tag tag, void *opaque)
 {
-    JSValue tag_v, ref_v, v;
+    DynExtref *extref;
+    JSValue v;
 
     if (tag != ExtObj && tag != ExtFunc && tag != ExtArray) {
         return NULL;
     }
 
+    extref = js_malloc(ctx->js_ctx, sizeof(DynExtref));
+    if (!extref) {
+        return NULL;
+    }
+    extref->tag = (int32_t)tag;
+    extref->ref = ptr;
+    extref->opaque = opaque;
+
     if (tag == ExtFunc) {
-        v = new_function_wrapper(ctx, ptr, opaque);
+        v = JS_NewObjectProtoClass(ctx->js_ctx, ctx->extref_func_proto,
+                                   ctx->extref_func_class_id);
     }
     else {
-        v = JS_NewObject(ctx->js_ctx);
+        v = JS_NewObjectProtoClass(ctx->js_ctx, ctx->extref_proto,
+                                   ctx->extref_class_id);
     }
 
     if (JS_IsException(v)) {
+        js_free(ctx->js_ctx, extref);
         return NULL;
     }
 
-    tag_v = JS_NewInt32(ctx->js_ctx, (int)tag);
-    ref_v = JS_NewInt32(ctx->js_ctx, (int32_t)(uintptr_t)ptr);
-    JS_DefinePropertyValueStr(ctx->js_ctx, v, "@tag", tag_v, 0);
-    JS_DefinePropertyValueStr(ctx->js_ctx, v, "@ref", ref_v, 0);
+    JS_SetOpaque(v, extref);
     return dynamic_dup_value(ctx->js_ctx, v);
 }
 
@@ -437,6 +690,34 @@ dynamic_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem)
     return DYNTYPE_SUCCESS;
 }
 
+int
+dynamic_add_elem(dyn_ctx_t ctx, dyn_value_t obj, dyn_value_t elem)
+{
+    JSValue *obj_ptr = (JSValue *)obj;
+    JSValue *elem_ptr = (JSValue *)elem;
+    JSValue length_value;
+    int64_t length;
+
+    if (!JS_IsArray(ctx->js_ctx, *obj_ptr)) {
+        return -DYNTYPE_TYPEERR;
+    }
+
+    length_value = JS_GetPropertyStr(ctx->js_ctx, *obj_ptr, "length");
+    if (JS_ToInt64(ctx->js_ctx, &length, length_value) < 0) {
+        JS_FreeValue(ctx->js_ctx, length_value);
+        return -DYNTYPE_EXCEPTION;
+    }
+    JS_FreeValue(ctx->js_ctx, length_value);
+
+    if (JS_SetPropertyInt64(ctx->js_ctx, *obj_ptr, length,
+                            JS_DupValue(ctx->js_ctx, *elem_ptr))
+        < 0) {
+        return -DYNTYPE_EXCEPTION;
+    }
+
+    return DYNTYPE_SUCCESS;
+}
+
 dyn_value_t
 dynamic_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index)
 {
@@ -455,8 +736,8 @@ dynamic_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index)
 }
 
 int
-dynamic_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
-                     dyn_value_t value)
+dynamic_set_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom,
+                          dyn_value_t value)
 {
     int ret;
     JSValue *val;
@@ -466,13 +747,34 @@ dynamic_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
         return -DYNTYPE_TYPEERR;
     }
     val = (JSValue *)value;
-    ret = JS_SetPropertyStr(ctx->js_ctx, *obj_ptr, prop,
-                            JS_DupValue(ctx->js_ctx, *val))
+    ret = JS_SetProperty(ctx->js_ctx, *obj_ptr, atom,
+                         JS_DupValue(ctx->js_ctx, *val))
               ? DYNTYPE_SUCCESS
               : -DYNTYPE_EXCEPTION;
     return ret;
 }
 
+int
+dynamic_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
+                     dyn_value_t value)
+{
+    int ret;
+    JSAtom atom;
+
+    if (!JS_IsObject(*(JSValue *)obj)) {
+        return -DYNTYPE_TYPEERR;
+    }
+
+    atom = dynamic_acquire_atom(ctx, prop);
+    if (atom == JS_ATOM_NULL) {
+        return -DYNTYPE_EXCEPTION;
+    }
+    ret = dynamic_set_property_atom(ctx, obj, atom, value);
+    JS_FreeAtom(ctx->js_ctx, atom);
+
+    return ret;
+}
+
 int
 dynamic_define_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
                         dyn_value_t desc)
@@ -490,7 +792,7 @@ dynamic_define_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
         return -DYNTYPE_TYPEERR;
     }
 
-    atom = JS_NewAtom(ctx->js_ctx, prop);
+    atom = dynamic_acquire_atom(ctx, prop);
     if (atom == JS_ATOM_NULL) {
         return -DYNTYPE_EXCEPTION;
     }
@@ -503,7 +805,7 @@ dynamic_define_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
 }
 
 dyn_value_t
-dynamic_get_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+dynamic_get_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom)
 {
     JSValue *obj_ptr = (JSValue *)obj;
     JSValue *ptr = NULL;
@@ -513,7 +815,7 @@ dynamic_get_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
         return ctx->js_undefined;
     }
 
-    val = JS_GetPropertyStr(ctx->js_ctx, *obj_ptr, prop);
+    val = JS_GetProperty(ctx->js_ctx, *obj_ptr, atom);
     if (JS_IsException(val)) {
         return NULL;
     }
@@ -523,23 +825,38 @@ dynamic_get_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
     return ptr;
 }
 
+dyn_value_t
+dynamic_get_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+{
+    JSValue *obj_ptr = (JSValue *)obj;
+    dyn_value_t res;
+    JSAtom atom;
+
+    if (!JS_IsObject(*obj_ptr) && !JS_IsString(*obj_ptr)) {
+        return ctx->js_undefined;
+    }
+
+    atom = dynamic_acquire_atom(ctx, prop);
+    if (atom == JS_ATOM_NULL) {
+        return NULL;
+    }
+    res = dynamic_get_property_atom(ctx, obj, atom);
+    JS_FreeAtom(ctx->js_ctx, atom);
+
+    return res;
+}
+
 int
-dynamic_has_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+dynamic_has_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom)
 {
     int res;
-    JSAtom atom;
     JSValue *obj_ptr = (JSValue *)obj;
 
     if (!JS_IsObject(*obj_ptr)) {
         return -DYNTYPE_TYPEERR;
     }
 
-    atom = JS_NewAtom(ctx->js_ctx, prop);
-    if (atom == JS_ATOM_NULL) {
-        return -DYNTYPE_EXCEPTION;
-    }
     res = JS_HasProperty(ctx->js_ctx, *obj_ptr, atom);
-    JS_FreeAtom(ctx->js_ctx, atom);
     if (res == -1) {
         return -DYNTYPE_EXCEPTION;
     }
@@ -547,28 +864,58 @@ dynamic_has_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
 }
 
 int
-dynamic_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+dynamic_has_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
 {
-    JSValue *obj_ptr = (JSValue *)obj;
+    int res;
     JSAtom atom;
 
-    if (dynamic_has_property(ctx, obj, prop) != DYNTYPE_TRUE) {
-        return -DYNTYPE_FALSE;
+    if (!JS_IsObject(*(JSValue *)obj)) {
+        return -DYNTYPE_TYPEERR;
     }
 
-    atom = JS_NewAtom(ctx->js_ctx, prop);
+    atom = dynamic_acquire_atom(ctx, prop);
     if (atom == JS_ATOM_NULL) {
         return -DYNTYPE_EXCEPTION;
     }
-
-    int res = JS_DeleteProperty(ctx->js_ctx, *obj_ptr, atom, 0);
+    res = dynamic_has_property_atom(ctx, obj, atom);
     JS_FreeAtom(ctx->js_ctx, atom);
+
+    return res;
+}
+
+int
+dynamic_delete_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom)
+{
+    JSValue *obj_ptr = (JSValue *)obj;
+    int res;
+
+    if (dynamic_has_property_atom(ctx, obj, atom) != DYNTYPE_TRUE) {
+        return -DYNTYPE_FALSE;
+    }
+
+    res = JS_DeleteProperty(ctx->js_ctx, *obj_ptr, atom, 0);
     if (res == -1) {
         return -DYNTYPE_EXCEPTION;
     }
     return res == 0 ? DYNTYPE_FALSE : DYNTYPE_TRUE;
 }
 
+int
+dynamic_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+{
+    int res;
+    JSAtom atom;
+
+    atom = dynamic_acquire_atom(ctx, prop);
+    if (atom == JS_ATOM_NULL) {
+        return -DYNTYPE_EXCEPTION;
+    }
+    res = dynamic_delete_property_atom(ctx, obj, atom);
+    JS_FreeAtom(ctx->js_ctx, atom);
+
+    return res;
+}
+
 dyn_value_t
 dynamic_get_keys(dyn_ctx_t ctx, dyn_value_t obj)
 {
@@ -692,34 +1039,21 @@ dynamic_is_array(dyn_ctx_t ctx, dyn_value_t obj)
 bool
 dynamic_is_extref(dyn_ctx_t ctx, dyn_value_t obj)
 {
-    if (!dynamic_is_object(ctx, obj)) {
-        return false;
-    }
-    return dynamic_has_property(ctx, obj, "@tag") == DYNTYPE_TRUE ? true
-                                                                  : false;
+    return get_extref(ctx, *(JSValue *)obj) != NULL;
 }
 
 int
 dynamic_to_extref(dyn_ctx_t ctx, dyn_value_t obj, void **pres)
 {
-    JSValue *ref_v;
-    JSValue *tag_v;
-    int tag;
+    DynExtref *extref = get_extref(ctx, *(JSValue *)obj);
 
-    if (dynamic_is_extref(ctx, obj) == DYNTYPE_FALSE) {
+    if (!extref) {
         return -DYNTYPE_TYPEERR;
     }
 
-    tag_v = dynamic_get_property(ctx, obj, "@tag");
-    ref_v = dynamic_get_property(ctx, obj, "@ref");
-    *pres = (void *)(uintptr_t)JS_VALUE_GET_INT(*ref_v);
+    *pres = extref->ref;
 
-    tag = JS_VALUE_GET_INT(*tag_v);
-
-    js_free(ctx->js_ctx, tag_v);
-    js_free(ctx->js_ctx, ref_v);
-
-    return tag;
+    return extref->tag;
 }
 
 bool
@@ -947,7 +1281,7 @@ dynamic_get_own_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
     if (JS_VALUE_GET_TAG(*obj_ptr) != JS_TAG_OBJECT) {
         return NULL;
     }
-    JSAtom atom = JS_NewAtom(ctx->js_ctx, prop);
+    JSAtom atom = dynamic_acquire_atom(ctx, prop);
     if (atom == JS_ATOM_NULL) {
         return NULL;
     }
@@ -1033,6 +1367,17 @@ dynamic_dump_error(dyn_ctx_t ctx)
     }
 }
 
+void
+dynamic_dump_memory_usage(dyn_ctx_t ctx)
+{
+    JSMemoryUsage stats;
+
+    JS_ComputeMemoryUsage(ctx->js_rt, &stats);
+    JS_DumpMemoryUsage(stdout, &stats, ctx->js_rt);
+    printf("value box arena: %u pages of %u slots\n",
+           ctx->value_arena.page_count, DYN_VALUE_SLOTS_PER_PAGE);
+}
+
 /******************* Garbage collection *******************/
 
 dyn_value_t
@@ -1056,7 +1401,22 @@ dynamic_release(dyn_ctx_t ctx, dyn_value_t obj)
     JSValue *ptr = (JSValue *)(obj);
     JS_FreeValue(ctx->js_ctx, *ptr);
     if (obj != ctx->js_undefined && obj != ctx->js_null) {
-        js_free(ctx->js_ctx, obj);
+        dynamic_free_box(ctx->js_ctx, obj);
+    }
+}
+
+dyn_value_t
+dynamic_new_weak_ref(dyn_ctx_t ctx, dyn_value_t obj)
+{
+    /* a box of its own without a reference count */
+    return dynamic_dup_value(ctx->js_ctx, *(JSValue *)obj);
+}
+
+void
+dynamic_free_weak_ref(dyn_ctx_t ctx, dyn_value_t ref)
+{
+    if (ref) {
+        dynamic_free_box(ctx->js_ctx, ref);
     }
 }
 
@@ -1066,6 +1426,13 @@ dynamic_collect(dyn_ctx_t ctx)
     // TODO
 }
 
+bool
+dynamic_is_immediate(dyn_ctx_t ctx, dyn_value_t obj)
+{
+    /* every value is a boxed JSValue */
+    return false;
+}
+
 /******************* Exception *******************/
 
 dyn_value_t
@@ -1096,7 +1463,7 @@ dynamic_get_array_length(dyn_ctx_t ctx, dyn_value_t obj)
                  ? JS_VALUE_GET_INT(*(JSValue *)length_value)
                  : -DYNTYPE_TYPEERR;
     if (length_value) {
-        js_free(ctx->js_ctx, length_value);
+        dynamic_free_box(ctx->js_ctx, length_value);
     }
 
     return length;
@@ -40,15 +40,36 @@ int
 dynamic_dump_value_buffer(dyn_ctx_t ctx, dyn_value_t obj, void *buffer,
                           int len);
 
+void
+dynamic_dump_memory_usage(dyn_ctx_t ctx);
+
 dyn_value_t
 dynamic_hold(dyn_ctx_t ctx, dyn_value_t obj);
 
 void
 dynamic_release(dyn_ctx_t ctx, dyn_value_t obj);
 
+/* A reference which doesn't keep obj alive, dynamic_hold on it gives back a
+ * held value until obj is freed */
+dyn_value_t
+dynamic_new_weak_ref(dyn_ctx_t ctx, dyn_value_t obj);
+
+void
+dynamic_free_weak_ref(dyn_ctx_t ctx, dyn_value_t ref);
+
 void
 dynamic_collect(dyn_ctx_t ctx);
 
+bool
+dynamic_is_immediate(dyn_ctx_t ctx, dyn_value_t obj);
+
+DynHostData *
+dynamic_get_host_data(dyn_ctx_t ctx);
+
+/* Make ctx the context of the calling thread */
+void
+dynamic_set_context(dyn_ctx_t ctx);
+
 /********************************************/
 /*     APIs exposed to wasm application     */
 /********************************************/
@@ -94,6 +115,9 @@ dynamic_new_extref(dyn_ctx_t ctx, void *ptr, external_ref_tag tag, void* opaque)
 int
 dynamic_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem);
 
+int
+dynamic_add_elem(dyn_ctx_t ctx, dyn_value_t obj, dyn_value_t elem);
+
 dyn_value_t
 dynamic_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index);
 
@@ -117,6 +141,28 @@ dynamic_has_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop);
 int
 dynamic_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop);
 
+dyn_atom_t
+dynamic_new_atom(dyn_ctx_t ctx, const char *prop);
+
+const char *
+dynamic_atom_to_cstring(dyn_ctx_t ctx, dyn_atom_t atom);
+
+void
+dynamic_free_atom_cstring(dyn_ctx_t ctx, const char *str);
+
+int
+dynamic_set_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom,
+                          dyn_value_t value);
+
+dyn_value_t
+dynamic_get_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom);
+
+int
+dynamic_has_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom);
+
+int
+dynamic_delete_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom);
+
 bool
 dynamic_is_number(dyn_ctx_t ctx, dyn_value_t obj);
 int
@@ -8,11 +8,61 @@
 #include "quickjs.h"
 #include <string.h>
 
+/* Number of JSValue boxes carved from each arena page */
+#define DYN_VALUE_SLOTS_PER_PAGE 256
+
+/* Values handed out as dyn_value_t are boxed JSValues, free boxes are linked
+ * through their storage */
+typedef union DynValueSlot {
+    JSValue value;
+    union DynValueSlot *next_free;
+} DynValueSlot;
+
+typedef struct DynValueSlotPage {
+    struct DynValueSlotPage *next;
+    DynValueSlot slots[DYN_VALUE_SLOTS_PER_PAGE];
+} DynValueSlotPage;
+
+typedef struct DynValueArena {
+    DynValueSlotPage *pages;
+    DynValueSlot *free_list;
+    uint32_t page_count;
+} DynValueArena;
+
+/* Opaque of extref objects, tag is an external_ref_tag and ref the table
+ * index of the static object, ref and opaque are passed to the callback
+ * dispatcher when an ExtFunc is called */
+typedef struct DynExtref {
+    int32_t tag;
+    void *ref;
+    void *opaque;
+} DynExtref;
+
+/* Property names resolved to atoms, the cache holds a reference to each atom
+ * until the context is destroyed */
+typedef struct DynAtomCacheEntry {
+    uint32_t hash;
+    JSAtom atom;
+    char *name;
+} DynAtomCacheEntry;
+
+typedef struct DynAtomCache {
+    uint32_t capacity;
+    uint32_t count;
+    DynAtomCacheEntry *entries;
+} DynAtomCache;
+
 typedef struct DynTypeContext {
     JSRuntime *js_rt;
     JSContext *js_ctx;
     JSValue *js_undefined;
     JSValue *js_null;
     JSClassID extref_class_id;
-    JSValue *extref_class;
+    /* callable extrefs (ExtFunc) */
+    JSClassID extref_func_class_id;
+    JSValue extref_proto;
+    JSValue extref_func_proto;
+    DynValueArena value_arena;
+    DynAtomCache atom_cache;
+    DynHostData host;
 } DynTypeContext;
@@ -4,31 +4,187 @@
  */
 
 #include "pure_dynamic.h"
+#include "type.h"
+#include "class/dyn_class.h"
+#include <pthread.h>
 
-/* We don't need a context for simple libdyntype implementation, but we return a
- * non-zero value to make the system work */
-static dyn_ctx_t g_dynamic_context = (dyn_ctx_t)(uintptr_t)0xffff;
+#define INIT_ATOM_TABLE_SIZE 256
+#define INIT_STRING_TABLE_SIZE 256
+#define MAX_PROPERTY_TABLE_HINT (1 << 24)
+
+#ifndef os_thread_local_attribute
+#define os_thread_local_attribute __thread
+#endif
+
+/* Contexts are independent, values of a context must only be used with it.
+ * New values are created in the context of the calling thread, and are
+ * released into the context recorded in them. */
+static os_thread_local_attribute DynTypeContext *tls_dynamic_context = NULL;
+
+/* Live contexts indexed by their id, slot 0 is never used */
+static DynTypeContext *g_contexts[DYN_CONTEXT_MAX_NUM + 1];
+static pthread_mutex_t g_contexts_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool
+context_register(DynTypeContext *ctx)
+{
+    uint32_t i;
+
+    pthread_mutex_lock(&g_contexts_lock);
+    for (i = 1; i <= DYN_CONTEXT_MAX_NUM; i++) {
+        if (!g_contexts[i]) {
+            g_contexts[i] = ctx;
+            ctx->id = (uint8_t)i;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_contexts_lock);
+
+    if (!ctx->id) {
+        LOG_ERROR("libdyntype: more than %d live contexts",
+                  DYN_CONTEXT_MAX_NUM);
+        return false;
+    }
+
+    return true;
+}
+
+static void
+context_unregister(DynTypeContext *ctx)
+{
+    if (!ctx->id) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_contexts_lock);
+    g_contexts[ctx->id] = NULL;
+    pthread_mutex_unlock(&g_contexts_lock);
+}
+
+DynTypeContext *
+dynamic_context_from_id(uint8_t id)
+{
+    return g_contexts[id];
+}
 
 /******************* Initialization and destroy *****************/
 
 dyn_ctx_t
 dynamic_context_init()
 {
-    return g_dynamic_context;
+    return dynamic_context_init_with_opt(NULL);
 }
 
 dyn_ctx_t
 dynamic_context_init_with_opt(dyn_options_t *options)
 {
-    return g_dynamic_context;
+    uint64_t memory_limit = options ? options->memory_limit : 0;
+    uint32_t gc_threshold = DYN_GC_ROOT_THRESHOLD;
+    uint32_t atom_table_size = INIT_ATOM_TABLE_SIZE;
+    DynTypeContext *ctx;
+
+    if (options && options->gc_threshold) {
+        gc_threshold = options->gc_threshold > UINT32_MAX
+                           ? UINT32_MAX
+                           : (uint32_t)options->gc_threshold;
+    }
+
+    /* the atom table keeps its load factor below 3/4 */
+    if (options && options->property_table_size) {
+        uint32_t hint = options->property_table_size;
+
+        if (hint > MAX_PROPERTY_TABLE_HINT) {
+            hint = MAX_PROPERTY_TABLE_HINT;
+        }
+        atom_table_size = hint / 3 * 4 + 4;
+    }
+
+    if (!dyn_class_init()) {
+        return NULL;
+    }
+
+    ctx = (DynTypeContext *)wasm_runtime_malloc(sizeof(DynTypeContext));
+    if (!ctx) {
+        return NULL;
+    }
+    memset(ctx, 0, sizeof(DynTypeContext));
+
+    if (!dyn_allocator_init(&ctx->allocator, memory_limit)) {
+        wasm_runtime_free(ctx);
+        return NULL;
+    }
+
+    if (!dyn_gc_init(&ctx->gc, gc_threshold)) {
+        dyn_allocator_destroy(&ctx->allocator);
+        wasm_runtime_free(ctx);
+        return NULL;
+    }
+
+    if (!(ctx->atom_table = dyn_atom_table_create(atom_table_size))) {
+        goto fail;
+    }
+
+    if (!(ctx->string_table = dyn_string_table_create(INIT_STRING_TABLE_SIZE))) {
+        goto fail;
+    }
+
+    if (!(ctx->root_shape = dyn_shape_new_root())) {
+        goto fail;
+    }
+
+    if (!context_register(ctx)) {
+        goto fail;
+    }
+
+    if (!tls_dynamic_context) {
+        tls_dynamic_context = ctx;
+    }
+    return ctx;
+
+fail:
+    dyn_shape_destroy_tree(ctx->root_shape);
+    dyn_string_table_destroy(ctx->string_table);
+    dyn_atom_table_destroy(ctx->atom_table);
+    dyn_gc_destroy(&ctx->gc);
+    dyn_allocator_destroy(&ctx->allocator);
+    wasm_runtime_free(ctx);
+    return NULL;
 }
 
 void
 dynamic_context_destroy(dyn_ctx_t ctx)
-{}
+{
+    if (!ctx) {
+        return;
+    }
+
+    /* strings still alive are not interned anymore */
+    dyn_string_table_destroy(ctx->string_table);
+    dyn_gc_destroy(&ctx->gc);
+    dyn_allocator_destroy(&ctx->allocator);
+    dyn_shape_destroy_tree(ctx->root_shape);
+    dyn_atom_table_destroy(ctx->atom_table);
+    context_unregister(ctx);
+    if (tls_dynamic_context == ctx) {
+        tls_dynamic_context = NULL;
+    }
+    wasm_runtime_free(ctx);
+}
+
+DynHostData *
+dynamic_get_host_data(dyn_ctx_t ctx)
+{
+    return &ctx->host;
+}
+
+void
+dynamic_set_context(dyn_ctx_t ctx)
+{
+    tls_dynamic_context = ctx;
+}
 
 dyn_ctx_t
 dynamic_get_context()
 {
-    return g_dynamic_context;
+    return tls_dynamic_context;
 }
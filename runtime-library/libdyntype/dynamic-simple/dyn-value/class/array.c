@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "dyn_class.h"
+
+/* Constructor (new Array(), new Array(len)) */
+DynValue *
+array_constructor(int argc, DynValue *argv[])
+{
+    int len = 0;
+
+    if (argc == 1 && dyn_value_type(argv[0]) == DynNumber) {
+        len = (int)dyn_value_get_number(argv[0]);
+    }
+
+    return dyn_value_new_array(len);
+}
+
+DynValue *
+array_push(DynValue *this_val, int argc, DynValue *argv[])
+{
+    DyntypeArray *dyn_array = (DyntypeArray *)this_val;
+    int i;
+
+    if (!dyn_array_reserve(dyn_array, dyn_array->length + argc)) {
+        return NULL;
+    }
+
+    for (i = 0; i < argc; i++) {
+        dyn_array_push(dyn_array, argv[i]);
+    }
+
+    return dyn_value_new_number(dyn_array->length);
+}
+
+DynValue *
+array_pop(DynValue *this_val, int argc, DynValue *argv[])
+{
+    return dyn_array_pop((DyntypeArray *)this_val);
+}
+
+/* Array.prototype.xxx */
+ClassMethod array_inst_methods[] = {
+    { "push", array_push },
+    { "pop", array_pop },
+    /* TODO: add more methods */
+};
+
+ClassMeta array_class_meta = {
+    .constructor = array_constructor,
+    .parent_class_id = DynClassObject,
+    .inst_method_num = sizeof(array_inst_methods) / sizeof(ClassMethod),
+    .inst_methods = array_inst_methods,
+    .name = "Array"
+};
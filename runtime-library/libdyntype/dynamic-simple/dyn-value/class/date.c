@@ -58,22 +58,22 @@ DynValue *
 date_constructor(int argc, DynValue *argv[])
 {
     DyntypeDate *dyn_obj =
-        (DyntypeDate *)wasm_runtime_malloc(sizeof(DyntypeDate));
+        (DyntypeDate *)dyn_value_alloc(DynClassDate, sizeof(DyntypeDate));
     if (!dyn_obj) {
         return NULL;
     }
 
     if (!init_dyn_object((DyntypeObject *)dyn_obj, DynClassDate)) {
-        wasm_runtime_free(dyn_obj);
+        dyn_value_free(dyn_obj, DynClassDate, sizeof(DyntypeDate));
         return NULL;
     }
 
     if (argc == 0) {
         dyn_obj->time = time(NULL);
     }
-    else if (argc == 1 && argv[0]->class_id == DynClassString) {
-        DyntypeString *str = (DyntypeString *)argv[0];
-        if (strtotime(str->data, &dyn_obj->time) != 0) {
+    else if (argc == 1 && dyn_value_class_id(argv[0]) == DynClassString) {
+        uint8_t *data = dyn_string_data((DyntypeString *)argv[0]);
+        if (!data || strtotime((char *)data, &dyn_obj->time) != 0) {
             return NULL;
         }
     }
@@ -177,7 +177,8 @@ DyntypeClass date_class = {
         .header = {
             .type = DynObject,
             .class_id = DynClassConstructor,
-            .ref_count = 1,
+            /* never freed, nor traversed by the cycle collector */
+            .ref_count = DYN_REF_COUNT_MAX,
         },
         .properties = NULL,
     },
@@ -4,6 +4,7 @@
  */
 
 #include "dyn_class.h"
+#include <pthread.h>
 
 /* How to add new class? */
 /*
@@ -20,6 +21,7 @@
 /* Class meta (mandatory) */
 extern ClassMeta object_class_meta;
 extern ClassMeta string_class_meta;
+extern ClassMeta array_class_meta;
 extern ClassMeta date_class_meta;
 
 ClassMeta *class_meta_array[DynClassEnd] = {
@@ -28,7 +30,7 @@ ClassMeta *class_meta_array[DynClassEnd] = {
     [DynClassBoolean] = NULL,
     [DynClassString] = &string_class_meta,
     [DynClassObject] = &object_class_meta,
-    [DynClassArray] = NULL,
+    [DynClassArray] = &array_class_meta,
     [DynClassExtref] = NULL,
 
     [DynClassDate] = &date_class_meta,
@@ -43,83 +45,256 @@ GlobalObjectEntry global_object_array[]  = {
     { "Date", &date_class },
 };
 
-/* Utilities */
-static DynClassMethodCallback
-find_inst_method_by_classid(uint32_t class_id, const char *name)
+/* Method dispatch */
+/*
+ * Method names are resolved to selectors, every distinct name used by any
+ * class gets one. Each class has a dispatch table indexed by selector with
+ * the methods of its parent classes flattened in, so invoking a method costs
+ * one hash of its name instead of a strcmp per method and parent class.
+ * Tables are process wide and built once, by the first context initialized
+ * or the first lookup, class metas are static so they never change.
+ */
+#define DYN_CLASS_MAX_SELECTORS 64
+/* power of 2 and at least twice the entry count, so probing terminates */
+#define NAME_TABLE_SIZE 128
+
+typedef struct NameEntry {
+    const char *name;
+    uint32_t hash;
+    int32_t value;
+} NameEntry;
+
+static NameEntry selector_table[NAME_TABLE_SIZE];
+static NameEntry class_name_table[NAME_TABLE_SIZE];
+static NameEntry global_object_table[NAME_TABLE_SIZE];
+static uint32_t selector_num = 0;
+
+static DynClassMethodCallback inst_dispatch[DynClassEnd][DYN_CLASS_MAX_SELECTORS];
+static DynClassMethodCallback class_dispatch[DynClassEnd][DYN_CLASS_MAX_SELECTORS];
+static bool dispatch_ready = false;
+static pthread_once_t dispatch_once = PTHREAD_ONCE_INIT;
+
+static NameEntry *
+name_table_slot(NameEntry *table, const char *name, uint32_t hash)
 {
-    ClassMeta *meta = NULL;
-    int i;
+    uint32_t i = hash & (NAME_TABLE_SIZE - 1);
 
-    if (class_id >= sizeof(class_meta_array)) {
-        return NULL;
+    while (table[i].name) {
+        if (table[i].hash == hash && !strcmp(table[i].name, name)) {
+            break;
+        }
+        i = (i + 1) & (NAME_TABLE_SIZE - 1);
     }
 
-    meta = class_meta_array[class_id];
+    return &table[i];
+}
 
-    if (!meta)
-        return NULL;
+static int32_t
+name_table_find(NameEntry *table, const char *name)
+{
+    NameEntry *slot =
+        name_table_slot(table, name, dyn_atom_hash(name, strlen(name)));
 
-    for (i = 0; i < meta->inst_method_num; i++) {
-        if (!strcmp(meta->inst_methods[i].name, name))
-            return meta->inst_methods[i].func;
+    return slot->name ? slot->value : -1;
+}
+
+static void
+name_table_insert(NameEntry *table, const char *name, int32_t value)
+{
+    uint32_t hash = dyn_atom_hash(name, strlen(name));
+    NameEntry *slot = name_table_slot(table, name, hash);
+
+    if (!slot->name) {
+        slot->name = name;
+        slot->hash = hash;
+        slot->value = value;
+    }
+}
+
+static int32_t
+register_selector(const char *name)
+{
+    int32_t selector = name_table_find(selector_table, name);
+
+    if (selector >= 0) {
+        return selector;
+    }
+
+    if (selector_num >= DYN_CLASS_MAX_SELECTORS) {
+        return -1;
+    }
+
+    name_table_insert(selector_table, name, (int32_t)selector_num);
+    return (int32_t)selector_num++;
+}
+
+static bool
+fill_dispatch_table(DynClassMethodCallback *table, ClassMethod *methods,
+                    uint32_t method_num)
+{
+    uint32_t i;
+
+    for (i = 0; i < method_num; i++) {
+        int32_t selector = register_selector(methods[i].name);
+
+        if (selector < 0) {
+            return false;
+        }
+        table[selector] = methods[i].func;
+    }
+
+    return true;
+}
+
+/* Parents are filled first so that methods of the class override them */
+static bool
+build_inst_dispatch(uint32_t class_id, bool *built)
+{
+    ClassMeta *meta = class_meta_array[class_id];
+
+    if (built[class_id] || !meta) {
+        return true;
     }
 
-    /* Search parent inst method */
     if (meta->parent_class_id != DynClassNone) {
-        return find_inst_method_by_classid(meta->parent_class_id, name);
+        bh_assert(meta->parent_class_id < DynClassEnd);
+
+        if (!build_inst_dispatch(meta->parent_class_id, built)) {
+            return false;
+        }
+        bh_memcpy_s(inst_dispatch[class_id], sizeof(inst_dispatch[class_id]),
+                    inst_dispatch[meta->parent_class_id],
+                    sizeof(inst_dispatch[class_id]));
+    }
+
+    built[class_id] = true;
+
+    return fill_dispatch_table(inst_dispatch[class_id], meta->inst_methods,
+                               meta->inst_method_num);
+}
+
+static bool
+build_dispatch_tables()
+{
+    bool built[DynClassEnd] = { false };
+    uint32_t i;
+
+    for (i = 0; i < DynClassEnd; i++) {
+        ClassMeta *meta = class_meta_array[i];
+
+        if (!meta) {
+            continue;
+        }
+
+        assert(meta->name != NULL);
+        name_table_insert(class_name_table, meta->name, (int32_t)i);
+
+        if (!build_inst_dispatch(i, built)
+            || !fill_dispatch_table(class_dispatch[i], meta->class_methods,
+                                    meta->class_method_num)) {
+            /* DYN_CLASS_MAX_SELECTORS is too small */
+            bh_assert(0);
+            return false;
+        }
     }
 
-    return NULL;
+    for (i = 0; i < sizeof(global_object_array) / sizeof(GlobalObjectEntry);
+         i++) {
+        name_table_insert(global_object_table, global_object_array[i].name,
+                          (int32_t)i);
+    }
+
+    return true;
+}
+
+static void
+dispatch_tables_init()
+{
+    dispatch_ready = build_dispatch_tables();
+}
+
+bool
+dyn_class_init()
+{
+    pthread_once(&dispatch_once, dispatch_tables_init);
+    return dispatch_ready;
+}
+
+/* Utilities */
+int32_t
+find_selector(const char *name)
+{
+    if (!dyn_class_init()) {
+        return -1;
+    }
+
+    return name_table_find(selector_table, name);
 }
 
 DynClassMethodCallback
-find_inst_method(DynValue *obj, const char *name)
+find_inst_method_by_selector(DynValue *obj, int32_t selector)
 {
-    if (obj->class_id == DynClassConstructor) {
-        uint32_t i;
+    uint32_t class_id = dyn_value_class_id(obj);
+
+    if (selector < 0 || selector >= (int32_t)selector_num) {
+        return NULL;
+    }
+
+    if (class_id == DynClassConstructor) {
         ClassMeta *meta = ((DyntypeClass *)obj)->meta;
-        if (!meta)
+        uint32_t i;
+
+        if (!meta) {
             return NULL;
+        }
 
-        for (i = 0; i < meta->class_method_num; i++) {
-            if (!strcmp(meta->class_methods[i].name, name))
-                return meta->class_methods[i].func;
+        for (i = 0; i < DynClassEnd; i++) {
+            if (class_meta_array[i] == meta) {
+                if (class_dispatch[i][selector]) {
+                    return class_dispatch[i][selector];
+                }
+                break;
+            }
         }
     }
 
-    return find_inst_method_by_classid(obj->class_id, name);
+    if (class_id >= DynClassEnd) {
+        return NULL;
+    }
+
+    return inst_dispatch[class_id][selector];
+}
+
+DynClassMethodCallback
+find_inst_method(DynValue *obj, const char *name)
+{
+    return find_inst_method_by_selector(obj, find_selector(name));
 }
 
 DynClassConstructorCallback
 find_class_constructor(const char *name)
 {
-    ClassMeta *meta = NULL;
-    int i;
-
-    for (i = 0; i < DynClassEnd; i++) {
-        meta = class_meta_array[i];
-        if (!meta)
-            continue;
-
-        assert(meta->name != NULL);
+    int32_t class_id;
 
-        if (!strcmp(meta->name, name))
-            return meta->constructor;
+    if (!dyn_class_init()) {
+        return NULL;
     }
 
-    return NULL;
+    class_id = name_table_find(class_name_table, name);
+
+    return class_id >= 0 ? class_meta_array[class_id]->constructor : NULL;
 }
 
 DynValue *
 find_global_object(const char *name)
 {
-    int i;
+    int32_t index;
 
-    for (i = 0; i < sizeof(global_object_array) / sizeof(GlobalObjectEntry);
-         i++) {
-        if (!strcmp(global_object_array[i].name, name))
-            return (DynValue *)global_object_array[i].value;
+    if (!dyn_class_init()) {
+        return NULL;
     }
 
-    return NULL;
+    index = name_table_find(global_object_table, name);
+
+    return index >= 0 ? (DynValue *)global_object_array[index].value : NULL;
 }
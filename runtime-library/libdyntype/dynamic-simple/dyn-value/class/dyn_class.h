@@ -35,6 +35,18 @@ typedef struct GlobalObjectEntry {
     DyntypeClass *value;
 } GlobalObjectEntry;
 
+/* Build the method dispatch tables shared by all contexts, safe to call from
+ * any thread */
+bool
+dyn_class_init();
+
+/* Return the selector of a method name, or -1 if no class has such method */
+int32_t
+find_selector(const char *name);
+
+DynClassMethodCallback
+find_inst_method_by_selector(DynValue *obj, int32_t selector);
+
 DynClassMethodCallback
 find_inst_method(DynValue *obj, const char *name);
 
@@ -35,7 +35,8 @@ DyntypeClass object_class = {
         .header = {
             .type = DynObject,
             .class_id = DynClassConstructor,
-            .ref_count = 1,
+            /* never freed, nor traversed by the cycle collector */
+            .ref_count = DYN_REF_COUNT_MAX,
         },
         .properties = NULL,
     },
@@ -7,42 +7,22 @@
 
 DynValue *string_concat(DynValue *this_val, int argc, DynValue *argv[])
 {
-    uint32_t i;
-    DyntypeString *res, *this_str = (DyntypeString *)this_val;
-    uint64_t total_string_len = this_str->length;
-    uint64_t total_size;
+    int i;
+    DyntypeString *res, *tmp;
 
-    for (i = 0; i < argc; i++) {
-        total_string_len += ((DyntypeString *)argv[i])->length;
-    }
-    total_size = total_string_len + offsetof(DyntypeString, data) + 1;
-
-    if (total_size >= UINT32_MAX) {
-        return NULL;
-    }
-
-    res = (DyntypeString *)wasm_runtime_malloc(total_size);
-    if (!res) {
-        return NULL;
-    }
-    memset(res, 0, total_size);
-
-    res->header.type = DynString;
-    res->header.ref_count = 1;
-    res->header.class_id = DynClassString;
-    res->length = this_str->length;
-
-    bh_memcpy_s(res->data, res->length, this_str->data, this_str->length);
+    /* each step creates a rope node, the bytes are copied only when the
+     * result is flattened */
+    res = (DyntypeString *)dyn_value_hold(this_val);
 
     for (i = 0; i < argc; i++) {
-        DyntypeString *str = (DyntypeString *)argv[i];
-        bh_memcpy_s(res->data + res->length, str->length, str->data,
-                    str->length);
-        res->length += str->length;
+        tmp = dyn_string_concat(res, (DyntypeString *)argv[i]);
+        dyn_value_release((DynValue *)res);
+        if (!tmp) {
+            return NULL;
+        }
+        res = tmp;
     }
 
-    assert(res->length == total_string_len);
-
     return (DynValue *)res;
 }
 
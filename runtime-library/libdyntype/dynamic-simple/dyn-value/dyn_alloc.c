@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "dyn_value.h"
+
+#ifndef os_thread_local_attribute
+#define os_thread_local_attribute __thread
+#endif
+
+#define DYN_SLAB_PAGE_SIZE (16 * 1024)
+/* Max number of free chunks kept by a thread for each size class, half of
+ * them are returned to the shared list when the limit is reached */
+#define DYN_SLAB_CACHE_MAX 128
+
+/* Size classes matching the value structures, see DynValue and its
+ * subtypes. Larger requests go to wasm_runtime_malloc directly. */
+static const uint32_t slab_class_size[DYN_SLAB_CLASS_NUM] = {
+    16, 32, 48, 64, 80, 96, 128, 256
+};
+
+typedef struct DynSlabChunk {
+    struct DynSlabChunk *next;
+} DynSlabChunk;
+
+typedef struct DynSlabPage {
+    struct DynSlabPage *next;
+} DynSlabPage;
+
+/* Per-thread view of an allocator, registered in the allocator so that it
+ * can be released and accounted for by the owner */
+typedef struct DynSlabCache {
+    struct DynSlabCache *next;
+    /* the tls_slab of the owning thread, identifies the thread */
+    void *owner;
+    DynSlabChunk *free_list[DYN_SLAB_CLASS_NUM];
+    uint32_t free_count[DYN_SLAB_CLASS_NUM];
+    /* counters are only written by the owning thread, and may become
+     * negative if values are released on another thread */
+    int64_t live_count[DynClassEnd];
+    int64_t live_bytes[DynClassEnd];
+    int64_t chunk_bytes;
+    int64_t large_bytes;
+} DynSlabCache;
+
+typedef struct DynSlabTLS {
+    DynAllocator *allocator;
+    uint32_t generation;
+    DynSlabCache *cache;
+} DynSlabTLS;
+
+static os_thread_local_attribute DynSlabTLS tls_slab;
+
+static uint32_t g_allocator_generation = 0;
+
+static inline int32_t
+slab_class_index(uint32_t size)
+{
+    int32_t i;
+
+    for (i = 0; i < DYN_SLAB_CLASS_NUM; i++) {
+        if (size <= slab_class_size[i]) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+bool
+dyn_allocator_init(DynAllocator *allocator, uint64_t memory_limit)
+{
+    memset(allocator, 0, sizeof(DynAllocator));
+    allocator->memory_limit = memory_limit;
+
+    if (os_mutex_init(&allocator->lock) != 0) {
+        return false;
+    }
+
+    allocator->generation = ++g_allocator_generation;
+
+    return true;
+}
+
+void
+dyn_allocator_destroy(DynAllocator *allocator)
+{
+    DynSlabPage *page, *next_page;
+    DynSlabCache *cache, *next_cache;
+
+    for (page = allocator->pages; page; page = next_page) {
+        next_page = page->next;
+        wasm_runtime_free(page);
+    }
+
+    for (cache = allocator->caches; cache; cache = next_cache) {
+        next_cache = cache->next;
+        wasm_runtime_free(cache);
+    }
+
+    if (tls_slab.allocator == allocator) {
+        memset(&tls_slab, 0, sizeof(DynSlabTLS));
+    }
+
+    os_mutex_destroy(&allocator->lock);
+    /* invalidate thread caches still pointing to this address */
+    allocator->generation = 0;
+}
+
+/* Only the last used allocator is cached in tls_slab, the thread may have
+ * registered a cache in this allocator before switching to another one, in
+ * which case that cache is reused */
+static DynSlabCache *
+get_thread_cache(DynAllocator *allocator)
+{
+    DynSlabCache *cache;
+
+    if (tls_slab.allocator == allocator
+        && tls_slab.generation == allocator->generation) {
+        return tls_slab.cache;
+    }
+
+    os_mutex_lock(&allocator->lock);
+    for (cache = allocator->caches; cache; cache = cache->next) {
+        if (cache->owner == &tls_slab) {
+            break;
+        }
+    }
+
+    if (!cache) {
+        cache = (DynSlabCache *)wasm_runtime_malloc(sizeof(DynSlabCache));
+        if (!cache) {
+            os_mutex_unlock(&allocator->lock);
+            return NULL;
+        }
+        memset(cache, 0, sizeof(DynSlabCache));
+        cache->owner = &tls_slab;
+        cache->next = allocator->caches;
+        allocator->caches = cache;
+    }
+    os_mutex_unlock(&allocator->lock);
+
+    tls_slab.allocator = allocator;
+    tls_slab.generation = allocator->generation;
+    tls_slab.cache = cache;
+
+    return cache;
+}
+
+/* Heap values must lie below the encoded immediate numbers, see
+ * dyn_value_is_immediate. A value allocated above them would be read as a
+ * number, so the allocation fails instead. */
+static bool
+check_value_address(void *ptr)
+{
+#if DYN_IMMEDIATE_NUMBER != 0
+    if ((uintptr_t)ptr >= DYN_NUMBER_ENCODE_OFFSET) {
+        LOG_ERROR("libdyntype: heap address %p overlaps immediate numbers, "
+                  "rebuild with DYN_IMMEDIATE_NUMBER=0",
+                  ptr);
+        return false;
+    }
+#endif
+    return true;
+}
+
+/* Move chunks from the shared list to the thread cache, carve a new page if
+ * the shared list is empty, must be called with the lock held */
+static bool
+refill_cache(DynAllocator *allocator, DynSlabCache *cache, int32_t index)
+{
+    uint32_t chunk_size = slab_class_size[index];
+    uint32_t moved = 0;
+    DynSlabPage *page;
+    uint8_t *p, *end;
+
+    while (allocator->free_list[index] && moved < DYN_SLAB_CACHE_MAX / 2) {
+        DynSlabChunk *chunk = allocator->free_list[index];
+
+        allocator->free_list[index] = chunk->next;
+        chunk->next = cache->free_list[index];
+        cache->free_list[index] = chunk;
+        moved++;
+    }
+
+    if (moved > 0) {
+        cache->free_count[index] += moved;
+        return true;
+    }
+
+    if (allocator->memory_limit
+        && (uint64_t)(allocator->page_count + 1) * DYN_SLAB_PAGE_SIZE
+                   + allocator->large_total
+               > allocator->memory_limit) {
+        return false;
+    }
+
+    page = (DynSlabPage *)wasm_runtime_malloc(DYN_SLAB_PAGE_SIZE);
+    if (!page) {
+        return false;
+    }
+
+    if (!check_value_address((uint8_t *)page + DYN_SLAB_PAGE_SIZE - 1)) {
+        wasm_runtime_free(page);
+        return false;
+    }
+
+    page->next = allocator->pages;
+    allocator->pages = page;
+    allocator->page_count++;
+
+    /* keep chunks 8-byte aligned, the low bits of values are used as tags */
+    p = (uint8_t *)page + ((sizeof(DynSlabPage) + 7) & ~(uintptr_t)7);
+    end = (uint8_t *)page + DYN_SLAB_PAGE_SIZE;
+
+    for (; p + chunk_size <= end; p += chunk_size) {
+        DynSlabChunk *chunk = (DynSlabChunk *)p;
+
+        chunk->next = cache->free_list[index];
+        cache->free_list[index] = chunk;
+        cache->free_count[index]++;
+    }
+
+    return true;
+}
+
+/* Account a large block against the memory limit, the slab pages are
+ * checked when they are carved, see refill_cache */
+static bool
+reserve_large(DynAllocator *allocator, uint32_t size)
+{
+    bool ret = false;
+
+    os_mutex_lock(&allocator->lock);
+    if ((uint64_t)allocator->page_count * DYN_SLAB_PAGE_SIZE
+            + allocator->large_total + size
+        <= allocator->memory_limit) {
+        allocator->large_total += size;
+        ret = true;
+    }
+    os_mutex_unlock(&allocator->lock);
+
+    return ret;
+}
+
+static void
+release_large(DynAllocator *allocator, uint32_t size)
+{
+    os_mutex_lock(&allocator->lock);
+    allocator->large_total -= size;
+    os_mutex_unlock(&allocator->lock);
+}
+
+void *
+dyn_allocator_alloc(DynAllocator *allocator, uint8_t class_id, uint32_t size)
+{
+    DynSlabCache *cache;
+    DynSlabChunk *chunk;
+    int32_t index = slab_class_index(size);
+
+    if (!allocator) {
+        void *ptr;
+
+        /* round up to the size class, the block may be released to a slab
+         * later */
+        ptr = wasm_runtime_malloc(index >= 0 ? slab_class_size[index] : size);
+        if (ptr && !check_value_address(ptr)) {
+            wasm_runtime_free(ptr);
+            return NULL;
+        }
+        return ptr;
+    }
+
+    if (!(cache = get_thread_cache(allocator))) {
+        return NULL;
+    }
+
+    if (index < 0) {
+        void *ptr;
+
+        if (allocator->memory_limit && !reserve_large(allocator, size)) {
+            return NULL;
+        }
+
+        ptr = wasm_runtime_malloc(size);
+        if (ptr && !check_value_address(ptr)) {
+            wasm_runtime_free(ptr);
+            ptr = NULL;
+        }
+        if (!ptr && allocator->memory_limit) {
+            release_large(allocator, size);
+        }
+        if (ptr) {
+            cache->live_count[class_id]++;
+            cache->live_bytes[class_id] += size;
+            cache->large_bytes += size;
+        }
+        return ptr;
+    }
+
+    if (!cache->free_list[index]) {
+        bool ret;
+
+        os_mutex_lock(&allocator->lock);
+        ret = refill_cache(allocator, cache, index);
+        os_mutex_unlock(&allocator->lock);
+
+        if (!ret) {
+            return NULL;
+        }
+    }
+
+    chunk = cache->free_list[index];
+    cache->free_list[index] = chunk->next;
+    cache->free_count[index]--;
+
+    cache->live_count[class_id]++;
+    cache->live_bytes[class_id] += size;
+    cache->chunk_bytes += slab_class_size[index];
+
+    return chunk;
+}
+
+void
+dyn_allocator_free(DynAllocator *allocator, void *ptr, uint8_t class_id,
+                   uint32_t size)
+{
+    DynSlabCache *cache;
+    DynSlabChunk *chunk = (DynSlabChunk *)ptr;
+    int32_t index = slab_class_index(size);
+
+    if (!allocator) {
+        wasm_runtime_free(ptr);
+        return;
+    }
+
+    if (!(cache = get_thread_cache(allocator))) {
+        /* out of memory, slab chunks are kept by their page */
+        if (index < 0) {
+            if (allocator->memory_limit) {
+                release_large(allocator, size);
+            }
+            wasm_runtime_free(ptr);
+        }
+        return;
+    }
+
+    cache->live_count[class_id]--;
+    cache->live_bytes[class_id] -= size;
+
+    if (index < 0) {
+        cache->large_bytes -= size;
+        if (allocator->memory_limit) {
+            release_large(allocator, size);
+        }
+        wasm_runtime_free(ptr);
+        return;
+    }
+
+    cache->chunk_bytes -= slab_class_size[index];
+
+    chunk->next = cache->free_list[index];
+    cache->free_list[index] = chunk;
+    cache->free_count[index]++;
+
+    if (cache->free_count[index] > DYN_SLAB_CACHE_MAX) {
+        os_mutex_lock(&allocator->lock);
+        while (cache->free_count[index] > DYN_SLAB_CACHE_MAX / 2) {
+            chunk = cache->free_list[index];
+            cache->free_list[index] = chunk->next;
+            cache->free_count[index]--;
+
+            chunk->next = allocator->free_list[index];
+            allocator->free_list[index] = chunk;
+        }
+        os_mutex_unlock(&allocator->lock);
+    }
+}
+
+void
+dyn_allocator_get_usage(DynAllocator *allocator, DynAllocUsage *usage)
+{
+    DynSlabCache *cache;
+    int64_t chunk_bytes = 0, large_bytes = 0, live_bytes = 0;
+    uint32_t i;
+
+    memset(usage, 0, sizeof(DynAllocUsage));
+
+    os_mutex_lock(&allocator->lock);
+    for (cache = allocator->caches; cache; cache = cache->next) {
+        for (i = 0; i < DynClassEnd; i++) {
+            usage->live_count[i] += cache->live_count[i];
+            usage->live_bytes[i] += cache->live_bytes[i];
+        }
+        chunk_bytes += cache->chunk_bytes;
+        large_bytes += cache->large_bytes;
+    }
+    os_mutex_unlock(&allocator->lock);
+
+    for (i = 0; i < DynClassEnd; i++) {
+        live_bytes += usage->live_bytes[i];
+    }
+
+    usage->total_live_bytes = live_bytes > 0 ? (uint64_t)live_bytes : 0;
+    usage->slab_chunk_bytes = chunk_bytes > 0 ? (uint64_t)chunk_bytes : 0;
+    usage->large_bytes = large_bytes > 0 ? (uint64_t)large_bytes : 0;
+    usage->reserved_bytes =
+        (uint64_t)allocator->page_count * DYN_SLAB_PAGE_SIZE
+        + usage->large_bytes;
+
+    /* share of reserved memory not holding live value data, this includes
+     * size class rounding and free chunks */
+    if (usage->reserved_bytes > 0
+        && usage->reserved_bytes > usage->total_live_bytes) {
+        usage->fragmentation =
+            1.0
+            - (double)usage->total_live_bytes / (double)usage->reserved_bytes;
+    }
+}
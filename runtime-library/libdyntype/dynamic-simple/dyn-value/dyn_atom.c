@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "dyn_value.h"
+
+#define MIN_ATOM_TABLE_CAPACITY 64
+
+/* FNV-1a over the key bytes */
+uint32_t
+dyn_atom_hash(const char *str, uint32_t length)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static uint32_t
+round_up_pow2(uint32_t n)
+{
+    uint32_t cap = MIN_ATOM_TABLE_CAPACITY;
+
+    while (cap < n) {
+        cap <<= 1;
+    }
+
+    return cap;
+}
+
+DynAtomTable *
+dyn_atom_table_create(uint32_t init_capacity)
+{
+    DynAtomTable *table;
+    uint32_t capacity = round_up_pow2(init_capacity);
+    uint64_t slots_size = (uint64_t)sizeof(DynAtom *) * capacity;
+
+    if (slots_size > UINT32_MAX) {
+        return NULL;
+    }
+
+    table = (DynAtomTable *)wasm_runtime_malloc(sizeof(DynAtomTable));
+    if (!table) {
+        return NULL;
+    }
+
+    table->slots = (DynAtom **)wasm_runtime_malloc((uint32_t)slots_size);
+    if (!table->slots) {
+        wasm_runtime_free(table);
+        return NULL;
+    }
+    memset(table->slots, 0, (uint32_t)slots_size);
+
+    table->capacity = capacity;
+    table->count = 0;
+    table->atoms = NULL;
+    table->atoms_capacity = 0;
+
+    return table;
+}
+
+void
+dyn_atom_table_destroy(DynAtomTable *table)
+{
+    uint32_t i;
+
+    if (!table) {
+        return;
+    }
+
+    for (i = 0; i < table->capacity; i++) {
+        if (table->slots[i]) {
+            wasm_runtime_free(table->slots[i]);
+        }
+    }
+
+    if (table->atoms) {
+        wasm_runtime_free(table->atoms);
+    }
+    wasm_runtime_free(table->slots);
+    wasm_runtime_free(table);
+}
+
+/* Linear probing, the table never shrinks and atoms are never removed, so an
+ * empty slot always terminates the probe sequence */
+static DynAtom **
+atom_table_lookup_slot(DynAtomTable *table, const char *str, uint32_t length,
+                       uint32_t hash)
+{
+    uint32_t mask = table->capacity - 1;
+    uint32_t i = hash & mask;
+
+    while (table->slots[i]) {
+        DynAtom *atom = table->slots[i];
+
+        if (atom->hash == hash && atom->length == length
+            && memcmp(atom->str, str, length) == 0) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return &table->slots[i];
+}
+
+static bool
+atom_table_grow(DynAtomTable *table)
+{
+    DynAtom **old_slots = table->slots;
+    uint32_t old_capacity = table->capacity;
+    uint64_t slots_size = (uint64_t)sizeof(DynAtom *) * old_capacity * 2;
+    uint32_t i, mask;
+
+    if (slots_size > UINT32_MAX) {
+        return false;
+    }
+
+    table->slots = (DynAtom **)wasm_runtime_malloc((uint32_t)slots_size);
+    if (!table->slots) {
+        table->slots = old_slots;
+        return false;
+    }
+    memset(table->slots, 0, (uint32_t)slots_size);
+    table->capacity = old_capacity * 2;
+    mask = table->capacity - 1;
+
+    for (i = 0; i < old_capacity; i++) {
+        DynAtom *atom = old_slots[i];
+        uint32_t j;
+
+        if (!atom) {
+            continue;
+        }
+
+        j = atom->hash & mask;
+        while (table->slots[j]) {
+            j = (j + 1) & mask;
+        }
+        table->slots[j] = atom;
+    }
+
+    wasm_runtime_free(old_slots);
+    return true;
+}
+
+DynAtom *
+dyn_atom_find(DynAtomTable *table, const char *str)
+{
+    uint32_t length = (uint32_t)strlen(str);
+    uint32_t hash = dyn_atom_hash(str, length);
+
+    return *atom_table_lookup_slot(table, str, length, hash);
+}
+
+DynAtom *
+dyn_atom_get(DynAtomTable *table, uint32_t id)
+{
+    if (id == 0 || id > table->count) {
+        return NULL;
+    }
+
+    return table->atoms[id - 1];
+}
+
+DynAtom *
+dyn_atom_new(DynAtomTable *table, const char *str)
+{
+    uint32_t length = (uint32_t)strlen(str);
+    uint32_t hash = dyn_atom_hash(str, length);
+    DynAtom **slot = atom_table_lookup_slot(table, str, length, hash);
+    DynAtom *atom;
+
+    if (*slot) {
+        return *slot;
+    }
+
+    /* keep load factor below 3/4 */
+    if ((table->count + 1) * 4 > table->capacity * 3) {
+        if (!atom_table_grow(table)) {
+            return NULL;
+        }
+        slot = atom_table_lookup_slot(table, str, length, hash);
+    }
+
+    if (table->count == table->atoms_capacity) {
+        uint32_t atoms_capacity = table->capacity;
+        DynAtom **atoms;
+
+        /* the table is at most 3/4 full, so this always leaves room */
+        atoms = (DynAtom **)wasm_runtime_realloc(
+            table->atoms, (uint32_t)(sizeof(DynAtom *) * atoms_capacity));
+        if (!atoms) {
+            return NULL;
+        }
+        table->atoms = atoms;
+        table->atoms_capacity = atoms_capacity;
+    }
+
+    atom = (DynAtom *)wasm_runtime_malloc(offsetof(DynAtom, str) + length + 1);
+    if (!atom) {
+        return NULL;
+    }
+
+    atom->hash = hash;
+    atom->length = length;
+    bh_memcpy_s(atom->str, length + 1, str, length + 1);
+
+    *slot = atom;
+    table->atoms[table->count++] = atom;
+    atom->id = table->count;
+
+    return atom;
+}
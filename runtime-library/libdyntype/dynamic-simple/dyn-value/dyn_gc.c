@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "pure_dynamic.h"
+#include "type.h"
+
+/*
+ * Synchronous trial deletion cycle collector (Bacon and Rajan, "Concurrent
+ * Cycle Collection in Reference Counted Systems")
+ *
+ * Objects and arrays whose reference count drops to a non-zero value may be
+ * the last externally referenced member of a cycle, they are colored purple
+ * and recorded in the possible roots buffer. A collection:
+ *   1. removes roots referenced again (black) and frees the buffered values
+ *      whose count dropped to zero meanwhile
+ *   2. colors everything reachable from the remaining roots gray, subtracting
+ *      the internal references from the counts
+ *   3. colors black (and restores the counts of) everything still
+ *      referenced from outside the gray subgraph, the rest becomes white
+ *   4. frees the white values: their internal references are restored, they
+ *      are cleared, so children are released normally, and then released
+ *
+ * Values with a saturated count are never traversed, they are treated as
+ * externally referenced. Graph traversals use an explicit stack and fall back
+ * to recursion if it can't grow.
+ */
+
+#define GC_STACK_INIT_SIZE 64
+
+typedef struct DynGCStack {
+    uint32_t count;
+    uint32_t capacity;
+    DynValue **items;
+} DynGCStack;
+
+static inline uint8_t
+gc_color(DynValue *value)
+{
+    return value->gc_flags & DYN_GC_COLOR_MASK;
+}
+
+static inline void
+gc_set_color(DynValue *value, uint8_t color)
+{
+    value->gc_flags = (value->gc_flags & ~DYN_GC_COLOR_MASK) | color;
+}
+
+static bool
+gc_stack_push(DynGCStack *stack, DynValue *value)
+{
+    if (stack->count == stack->capacity) {
+        uint32_t capacity =
+            stack->capacity ? stack->capacity * 2 : GC_STACK_INIT_SIZE;
+        DynValue **items;
+
+        if ((uint64_t)capacity * sizeof(DynValue *) > UINT32_MAX) {
+            return false;
+        }
+
+        items = (DynValue **)wasm_runtime_realloc(
+            stack->items, (uint32_t)(capacity * sizeof(DynValue *)));
+        if (!items) {
+            return false;
+        }
+        stack->items = items;
+        stack->capacity = capacity;
+    }
+
+    stack->items[stack->count++] = value;
+    return true;
+}
+
+static void
+gc_stack_destroy(DynGCStack *stack)
+{
+    if (stack->items) {
+        wasm_runtime_free(stack->items);
+    }
+    memset(stack, 0, sizeof(DynGCStack));
+}
+
+bool
+dyn_gc_init(DynGC *gc, uint32_t threshold)
+{
+    memset(gc, 0, sizeof(DynGC));
+    gc->threshold = threshold;
+
+    return true;
+}
+
+void
+dyn_gc_destroy(DynGC *gc)
+{
+    /* values still buffered are released with the allocator */
+    if (gc->roots) {
+        wasm_runtime_free(gc->roots);
+    }
+    memset(gc, 0, sizeof(DynGC));
+}
+
+void
+dyn_gc_possible_root(DynValue *value)
+{
+    DynTypeContext *ctx;
+    DynGC *gc;
+
+    if (gc_color(value) == DYN_GC_PURPLE
+        || (value->gc_flags & DYN_GC_FLAG_GARBAGE)) {
+        return;
+    }
+
+    gc_set_color(value, DYN_GC_PURPLE);
+
+    if ((value->gc_flags & DYN_GC_FLAG_BUFFERED)
+        || !(ctx = dyn_value_owner(value))) {
+        return;
+    }
+    gc = &ctx->gc;
+
+    if (gc->root_count == gc->root_capacity) {
+        uint32_t capacity =
+            gc->root_capacity ? gc->root_capacity * 2 : GC_STACK_INIT_SIZE;
+        DynValue **roots;
+
+        if ((uint64_t)capacity * sizeof(DynValue *) > UINT32_MAX) {
+            return;
+        }
+
+        roots = (DynValue **)wasm_runtime_realloc(
+            gc->roots, (uint32_t)(capacity * sizeof(DynValue *)));
+        if (!roots) {
+            /* not buffered, the value may leak if it is part of a cycle */
+            return;
+        }
+        gc->roots = roots;
+        gc->root_capacity = capacity;
+    }
+
+    value->gc_flags |= DYN_GC_FLAG_BUFFERED;
+    gc->roots[gc->root_count++] = value;
+}
+
+void
+dyn_gc_maybe_collect()
+{
+    DynTypeContext *ctx = dynamic_get_context();
+
+    if (ctx && ctx->gc.threshold > 0
+        && ctx->gc.root_count >= ctx->gc.threshold) {
+        dyn_gc_collect(&ctx->gc);
+    }
+}
+
+/* Mark gray */
+static void
+gray_node(DynGCStack *stack, DynValue *value);
+
+static void
+gray_child(DynValue *child, void *user_data)
+{
+    DynGCStack *stack = (DynGCStack *)user_data;
+
+    if (child->ref_count == DYN_REF_COUNT_MAX) {
+        return;
+    }
+
+    child->ref_count--;
+    if (!gc_stack_push(stack, child)) {
+        gray_node(stack, child);
+    }
+}
+
+static void
+gray_node(DynGCStack *stack, DynValue *value)
+{
+    if (gc_color(value) != DYN_GC_GRAY) {
+        gc_set_color(value, DYN_GC_GRAY);
+        dyn_value_visit_children(value, gray_child, stack);
+    }
+}
+
+static void
+mark_gray(DynGCStack *stack, DynValue *root)
+{
+    uint32_t base = stack->count;
+
+    gray_node(stack, root);
+    while (stack->count > base) {
+        gray_node(stack, stack->items[--stack->count]);
+    }
+}
+
+/* Scan black, value must already be black */
+static void
+black_node(DynGCStack *stack, DynValue *value);
+
+static void
+black_child(DynValue *child, void *user_data)
+{
+    DynGCStack *stack = (DynGCStack *)user_data;
+
+    if (child->ref_count == DYN_REF_COUNT_MAX) {
+        return;
+    }
+
+    child->ref_count++;
+    if (gc_color(child) != DYN_GC_BLACK) {
+        gc_set_color(child, DYN_GC_BLACK);
+        if (!gc_stack_push(stack, child)) {
+            black_node(stack, child);
+        }
+    }
+}
+
+static void
+black_node(DynGCStack *stack, DynValue *value)
+{
+    dyn_value_visit_children(value, black_child, stack);
+}
+
+static void
+scan_black(DynGCStack *stack, DynValue *root)
+{
+    uint32_t base = stack->count;
+
+    gc_set_color(root, DYN_GC_BLACK);
+    black_node(stack, root);
+    while (stack->count > base) {
+        black_node(stack, stack->items[--stack->count]);
+    }
+}
+
+/* Scan */
+static void
+scan_node(DynGCStack *stack, DynValue *value);
+
+static void
+scan_child(DynValue *child, void *user_data)
+{
+    DynGCStack *stack = (DynGCStack *)user_data;
+
+    if (child->ref_count == DYN_REF_COUNT_MAX) {
+        return;
+    }
+
+    if (!gc_stack_push(stack, child)) {
+        scan_node(stack, child);
+    }
+}
+
+static void
+scan_node(DynGCStack *stack, DynValue *value)
+{
+    if (gc_color(value) != DYN_GC_GRAY) {
+        return;
+    }
+
+    if (value->ref_count > 0) {
+        scan_black(stack, value);
+    }
+    else {
+        gc_set_color(value, DYN_GC_WHITE);
+        dyn_value_visit_children(value, scan_child, stack);
+    }
+}
+
+static void
+scan(DynGCStack *stack, DynValue *root)
+{
+    uint32_t base = stack->count;
+
+    scan_node(stack, root);
+    while (stack->count > base) {
+        scan_node(stack, stack->items[--stack->count]);
+    }
+}
+
+/* Collect white */
+typedef struct WhiteCollector {
+    DynGCStack stack;
+    DynGCStack whites;
+    /* some white value couldn't be recorded */
+    bool failed;
+} WhiteCollector;
+
+static void
+white_node(WhiteCollector *collector, DynValue *value);
+
+static void
+white_child(DynValue *child, void *user_data)
+{
+    WhiteCollector *collector = (WhiteCollector *)user_data;
+
+    if (gc_color(child) != DYN_GC_WHITE
+        || (child->gc_flags & DYN_GC_FLAG_GARBAGE)) {
+        return;
+    }
+
+    if (!gc_stack_push(&collector->stack, child)) {
+        white_node(collector, child);
+    }
+}
+
+static void
+white_node(WhiteCollector *collector, DynValue *value)
+{
+    if (gc_color(value) != DYN_GC_WHITE
+        || (value->gc_flags & DYN_GC_FLAG_GARBAGE)) {
+        return;
+    }
+
+    if (!gc_stack_push(&collector->whites, value)) {
+        collector->failed = true;
+        return;
+    }
+
+    value->gc_flags |= DYN_GC_FLAG_GARBAGE;
+    dyn_value_visit_children(value, white_child, collector);
+}
+
+static void
+collect_white(WhiteCollector *collector, DynValue *root)
+{
+    uint32_t base = collector->stack.count;
+
+    white_node(collector, root);
+    while (collector->stack.count > base) {
+        white_node(collector,
+                   collector->stack.items[--collector->stack.count]);
+    }
+}
+
+static void
+restore_child(DynValue *child, void *user_data)
+{
+    if (child->ref_count != DYN_REF_COUNT_MAX) {
+        child->ref_count++;
+    }
+}
+
+void
+dyn_gc_collect(DynGC *gc)
+{
+    WhiteCollector collector;
+    DynValue **roots = gc->roots;
+    uint32_t i, root_count = gc->root_count, kept = 0;
+
+    if (gc->collecting || root_count == 0) {
+        return;
+    }
+
+    memset(&collector, 0, sizeof(WhiteCollector));
+    gc->collecting = true;
+
+    /* values released during the collection go to a new buffer */
+    gc->roots = NULL;
+    gc->root_count = gc->root_capacity = 0;
+
+    for (i = 0; i < root_count; i++) {
+        DynValue *value = roots[i];
+
+        if (gc_color(value) == DYN_GC_PURPLE && value->ref_count > 0) {
+            roots[kept++] = value;
+            continue;
+        }
+
+        value->gc_flags &= ~DYN_GC_FLAG_BUFFERED;
+        if (gc_color(value) == DYN_GC_BLACK && value->ref_count == 0) {
+            /* already destroyed, see dyn_value_destroy */
+            dyn_value_free(value, value->class_id, dyn_value_size(value));
+        }
+    }
+
+    for (i = 0; i < kept; i++) {
+        mark_gray(&collector.stack, roots[i]);
+    }
+
+    for (i = 0; i < kept; i++) {
+        scan(&collector.stack, roots[i]);
+    }
+
+    for (i = 0; i < kept; i++) {
+        roots[i]->gc_flags &= ~DYN_GC_FLAG_BUFFERED;
+        collect_white(&collector, roots[i]);
+    }
+
+    if (collector.failed) {
+        /* out of memory, keep everything and restore the counts, the cycles
+         * are found again by a later collection once they become roots */
+        for (i = 0; i < collector.whites.count; i++) {
+            collector.whites.items[i]->gc_flags &= ~DYN_GC_FLAG_GARBAGE;
+        }
+        for (i = 0; i < kept; i++) {
+            if (gc_color(roots[i]) != DYN_GC_BLACK) {
+                scan_black(&collector.stack, roots[i]);
+            }
+        }
+        collector.whites.count = 0;
+    }
+
+    /* white values have no external reference, give back the references
+     * they hold to each other and to live values, then hold them so that
+     * clearing doesn't free any of them */
+    for (i = 0; i < collector.whites.count; i++) {
+        dyn_value_visit_children(collector.whites.items[i], restore_child,
+                                 NULL);
+    }
+    for (i = 0; i < collector.whites.count; i++) {
+        collector.whites.items[i]->ref_count++;
+    }
+
+    for (i = 0; i < collector.whites.count; i++) {
+        dyn_value_clear(collector.whites.items[i]);
+    }
+
+    for (i = 0; i < collector.whites.count; i++) {
+        DynValue *value = collector.whites.items[i];
+
+        value->gc_flags = 0;
+        dyn_value_release(value);
+    }
+
+    gc_stack_destroy(&collector.stack);
+    gc_stack_destroy(&collector.whites);
+
+    /* values recorded during the collection stay in the new buffer */
+    if (roots) {
+        wasm_runtime_free(roots);
+    }
+
+    gc->collecting = false;
+}
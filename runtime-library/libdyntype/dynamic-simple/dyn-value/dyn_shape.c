@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "dyn_value.h"
+
+static DynShape *
+shape_new(DynShape *parent, DynAtom *key)
+{
+    uint32_t prop_count = parent ? parent->prop_count + 1 : 0;
+    uint32_t total_size =
+        offsetof(DynShape, keys) + sizeof(DynAtom *) * (prop_count + 1);
+    DynShape *shape = (DynShape *)wasm_runtime_malloc(total_size);
+
+    if (!shape) {
+        return NULL;
+    }
+    memset(shape, 0, total_size);
+
+    shape->parent = parent;
+    shape->prop_count = prop_count;
+
+    if (parent) {
+        /* keys of the parent keep their slot index, the new key takes the
+         * next one */
+        bh_memcpy_s(shape->keys, sizeof(DynAtom *) * prop_count, parent->keys,
+                    sizeof(DynAtom *) * parent->prop_count);
+        shape->keys[prop_count - 1] = key;
+    }
+
+    return shape;
+}
+
+DynShape *
+dyn_shape_new_root()
+{
+    return shape_new(NULL, NULL);
+}
+
+void
+dyn_shape_destroy_tree(DynShape *shape)
+{
+    DynShape *child, *next;
+
+    if (!shape) {
+        return;
+    }
+
+    /* depth is bounded by DYN_SHAPE_MAX_PROPS */
+    child = shape->first_child;
+    while (child) {
+        next = child->next_sibling;
+        dyn_shape_destroy_tree(child);
+        child = next;
+    }
+
+    wasm_runtime_free(shape);
+}
+
+DynShape *
+dyn_shape_add_key(DynShape *shape, DynAtom *key)
+{
+    DynShape *child;
+
+    for (child = shape->first_child; child; child = child->next_sibling) {
+        if (child->keys[child->prop_count - 1] == key) {
+            return child;
+        }
+    }
+
+    /* Too many properties or too many distinct transitions means the object
+     * is used as a dictionary, let the caller fall back to a hash map */
+    if (shape->prop_count >= DYN_SHAPE_MAX_PROPS
+        || shape->child_count >= DYN_SHAPE_MAX_TRANSITIONS) {
+        return NULL;
+    }
+
+    child = shape_new(shape, key);
+    if (!child) {
+        return NULL;
+    }
+
+    child->next_sibling = shape->first_child;
+    shape->first_child = child;
+    shape->child_count++;
+
+    return child;
+}
+
+int32_t
+dyn_shape_find_key(DynShape *shape, DynAtom *key)
+{
+    int32_t i;
+
+    for (i = (int32_t)shape->prop_count - 1; i >= 0; i--) {
+        if (shape->keys[i] == key) {
+            return i;
+        }
+    }
+
+    return -1;
+}
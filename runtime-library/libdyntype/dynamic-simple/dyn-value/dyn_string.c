@@ -0,0 +1,629 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "pure_dynamic.h"
+#include "type.h"
+
+#define ROPE_LEAF_INIT_NUM 16
+#define MIN_STRING_TABLE_CAPACITY 64
+
+static inline bool
+string_is_flat(DyntypeString *dyn_str)
+{
+    return dyn_str->data == dyn_str->u.inline_data ? true : false;
+}
+
+static inline uint32_t
+string_depth(DyntypeString *dyn_str)
+{
+    return dyn_str->data ? 0 : dyn_str->depth;
+}
+
+DyntypeString *
+dyn_string_new_flat(uint32_t length)
+{
+    uint64_t total_size = DYN_STRING_FLAT_SIZE((uint64_t)length);
+    DyntypeString *dyn_str;
+
+    if (total_size > UINT32_MAX) {
+        return NULL;
+    }
+
+    dyn_str =
+        (DyntypeString *)dyn_value_alloc(DynClassString, (uint32_t)total_size);
+    if (!dyn_str) {
+        return NULL;
+    }
+    memset(dyn_str, 0, (uint32_t)total_size);
+
+    dyn_str->header.type = DynString;
+    dyn_str->header.class_id = DynClassString;
+    dyn_str->header.ctx_id = dyn_value_current_ctx_id();
+    dyn_str->header.ref_count = 1;
+    dyn_str->length = length;
+    dyn_str->data = dyn_str->u.inline_data;
+
+    return dyn_str;
+}
+
+/* Create a rope node, the references of left and right are taken over */
+static DyntypeString *
+rope_new(DyntypeString *left, DyntypeString *right)
+{
+    uint32_t left_depth = string_depth(left);
+    uint32_t right_depth = string_depth(right);
+    DyntypeString *dyn_str = (DyntypeString *)dyn_value_alloc(
+        DynClassString, sizeof(DyntypeString));
+
+    if (!dyn_str) {
+        dyn_value_release((DynValue *)left);
+        dyn_value_release((DynValue *)right);
+        return NULL;
+    }
+    memset(dyn_str, 0, sizeof(DyntypeString));
+
+    dyn_str->header.type = DynString;
+    dyn_str->header.class_id = DynClassString;
+    dyn_str->header.ctx_id = dyn_value_current_ctx_id();
+    dyn_str->header.ref_count = 1;
+    dyn_str->length = left->length + right->length;
+    dyn_str->depth =
+        (uint16_t)((left_depth > right_depth ? left_depth : right_depth) + 1);
+    dyn_str->u.rope.left = left;
+    dyn_str->u.rope.right = right;
+
+    return dyn_str;
+}
+
+/* Copy the bytes of a string to buf without flattening it, the explicit
+ * stack never holds more than depth + 1 nodes */
+static void
+rope_copy(DyntypeString *dyn_str, uint8_t *buf)
+{
+    DyntypeString *stack[DYN_ROPE_MAX_DEPTH + 1];
+    uint32_t top = 0, offset = 0;
+
+    stack[top++] = dyn_str;
+
+    while (top > 0) {
+        DyntypeString *node = stack[--top];
+
+        if (node->data) {
+            bh_memcpy_s(buf + offset, node->length, node->data, node->length);
+            offset += node->length;
+        }
+        else {
+            bh_assert(top + 2 <= DYN_ROPE_MAX_DEPTH + 1);
+            stack[top++] = node->u.rope.right;
+            stack[top++] = node->u.rope.left;
+        }
+    }
+}
+
+static DyntypeString *
+flat_concat(DyntypeString *dyn_str1, DyntypeString *dyn_str2)
+{
+    DyntypeString *dyn_str =
+        dyn_string_new_flat(dyn_str1->length + dyn_str2->length);
+
+    if (!dyn_str) {
+        return NULL;
+    }
+
+    rope_copy(dyn_str1, dyn_str->data);
+    rope_copy(dyn_str2, dyn_str->data + dyn_str1->length);
+
+    return dyn_str;
+}
+
+typedef struct RopeLeaves {
+    uint32_t count;
+    uint32_t capacity;
+    DyntypeString **leaves;
+} RopeLeaves;
+
+static bool
+rope_leaves_append(RopeLeaves *list, DyntypeString *leaf)
+{
+    if (list->count == list->capacity) {
+        uint32_t capacity =
+            list->capacity ? list->capacity * 2 : ROPE_LEAF_INIT_NUM;
+        DyntypeString **leaves = (DyntypeString **)wasm_runtime_realloc(
+            list->leaves, sizeof(DyntypeString *) * capacity);
+
+        if (!leaves) {
+            return false;
+        }
+        list->leaves = leaves;
+        list->capacity = capacity;
+    }
+
+    list->leaves[list->count++] = leaf;
+    return true;
+}
+
+/* Collect the leaves of a string in order, leaves are borrowed */
+static bool
+rope_collect_leaves(DyntypeString *dyn_str, RopeLeaves *list)
+{
+    DyntypeString *stack[DYN_ROPE_MAX_DEPTH + 1];
+    uint32_t top = 0;
+
+    stack[top++] = dyn_str;
+
+    while (top > 0) {
+        DyntypeString *node = stack[--top];
+
+        if (node->data) {
+            if (!rope_leaves_append(list, node)) {
+                return false;
+            }
+        }
+        else {
+            stack[top++] = node->u.rope.right;
+            stack[top++] = node->u.rope.left;
+        }
+    }
+
+    return true;
+}
+
+/* Build a balanced rope over leaves[0, count), count must not be zero */
+static DyntypeString *
+rope_build(DyntypeString **leaves, uint32_t count)
+{
+    DyntypeString *left, *right;
+
+    if (count == 1) {
+        return (DyntypeString *)dyn_value_hold((DynValue *)leaves[0]);
+    }
+
+    if (!(left = rope_build(leaves, count / 2))) {
+        return NULL;
+    }
+
+    if (!(right = rope_build(leaves + count / 2, count - count / 2))) {
+        dyn_value_release((DynValue *)left);
+        return NULL;
+    }
+
+    return rope_new(left, right);
+}
+
+/* Concatenate two strings whose rope would exceed DYN_ROPE_MAX_DEPTH: runs of
+ * short leaves are merged into flat strings and a balanced tree is built over
+ * the result */
+static DyntypeString *
+rope_rebalance(DyntypeString *dyn_str1, DyntypeString *dyn_str2)
+{
+    RopeLeaves list = { 0 }, merged = { 0 };
+    DyntypeString *res = NULL;
+    uint32_t i = 0, j, run_length;
+
+    if (!rope_collect_leaves(dyn_str1, &list)
+        || !rope_collect_leaves(dyn_str2, &list)) {
+        goto done;
+    }
+
+    while (i < list.count) {
+        DyntypeString *leaf;
+
+        run_length = list.leaves[i]->length;
+        for (j = i + 1; j < list.count
+                        && run_length + list.leaves[j]->length
+                               <= DYN_ROPE_LEAF_LENGTH;
+             j++) {
+            run_length += list.leaves[j]->length;
+        }
+
+        if (j - i == 1) {
+            leaf = (DyntypeString *)dyn_value_hold((DynValue *)list.leaves[i]);
+        }
+        else {
+            uint32_t offset = 0;
+
+            if (!(leaf = dyn_string_new_flat(run_length))) {
+                goto done;
+            }
+            for (; i < j; i++) {
+                bh_memcpy_s(leaf->data + offset, list.leaves[i]->length,
+                            list.leaves[i]->data, list.leaves[i]->length);
+                offset += list.leaves[i]->length;
+            }
+        }
+
+        if (!rope_leaves_append(&merged, leaf)) {
+            dyn_value_release((DynValue *)leaf);
+            goto done;
+        }
+        i = j;
+    }
+
+    res = rope_build(merged.leaves, merged.count);
+
+done:
+    for (i = 0; i < merged.count; i++) {
+        dyn_value_release((DynValue *)merged.leaves[i]);
+    }
+    if (merged.leaves) {
+        wasm_runtime_free(merged.leaves);
+    }
+    if (list.leaves) {
+        wasm_runtime_free(list.leaves);
+    }
+
+    return res;
+}
+
+static DynStringTable *
+current_string_table()
+{
+    DynTypeContext *ctx = dynamic_get_context();
+
+    return ctx ? ctx->string_table : NULL;
+}
+
+DynStringTable *
+dyn_string_table_create(uint32_t init_capacity)
+{
+    DynStringTable *table;
+    uint32_t capacity = MIN_STRING_TABLE_CAPACITY;
+    uint64_t slots_size;
+
+    while (capacity < init_capacity) {
+        capacity <<= 1;
+    }
+
+    slots_size = (uint64_t)sizeof(DyntypeString *) * capacity;
+    if (slots_size > UINT32_MAX) {
+        return NULL;
+    }
+
+    table = (DynStringTable *)wasm_runtime_malloc(sizeof(DynStringTable));
+    if (!table) {
+        return NULL;
+    }
+
+    table->slots = (DyntypeString **)wasm_runtime_malloc((uint32_t)slots_size);
+    if (!table->slots) {
+        wasm_runtime_free(table);
+        return NULL;
+    }
+    memset(table->slots, 0, (uint32_t)slots_size);
+
+    table->capacity = capacity;
+    table->count = 0;
+
+    return table;
+}
+
+void
+dyn_string_table_destroy(DynStringTable *table)
+{
+    uint32_t i;
+
+    if (!table) {
+        return;
+    }
+
+    /* the table doesn't own its strings */
+    for (i = 0; i < table->capacity; i++) {
+        if (table->slots[i]) {
+            table->slots[i]->flags &= ~DYN_STRING_FLAG_INTERNED;
+        }
+    }
+
+    wasm_runtime_free(table->slots);
+    wasm_runtime_free(table);
+}
+
+/* Linear probing, removal shifts entries back so that an empty slot always
+ * terminates the probe sequence. Interned strings are always flat. */
+static DyntypeString **
+string_table_lookup_slot(DynStringTable *table, const uint8_t *buf,
+                         uint32_t length, uint32_t hash)
+{
+    uint32_t mask = table->capacity - 1;
+    uint32_t i = hash & mask;
+
+    while (table->slots[i]) {
+        DyntypeString *dyn_str = table->slots[i];
+
+        if (dyn_str->hash == hash && dyn_str->length == length
+            && memcmp(dyn_str->data, buf, length) == 0) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return &table->slots[i];
+}
+
+static bool
+string_table_grow(DynStringTable *table)
+{
+    DyntypeString **old_slots = table->slots;
+    uint32_t old_capacity = table->capacity;
+    uint64_t slots_size = (uint64_t)sizeof(DyntypeString *) * old_capacity * 2;
+    uint32_t i, j, mask;
+
+    if (slots_size > UINT32_MAX) {
+        return false;
+    }
+
+    table->slots = (DyntypeString **)wasm_runtime_malloc((uint32_t)slots_size);
+    if (!table->slots) {
+        table->slots = old_slots;
+        return false;
+    }
+    memset(table->slots, 0, (uint32_t)slots_size);
+    table->capacity = old_capacity * 2;
+    mask = table->capacity - 1;
+
+    for (i = 0; i < old_capacity; i++) {
+        if (!old_slots[i]) {
+            continue;
+        }
+
+        j = old_slots[i]->hash & mask;
+        while (table->slots[j]) {
+            j = (j + 1) & mask;
+        }
+        table->slots[j] = old_slots[i];
+    }
+
+    wasm_runtime_free(old_slots);
+    return true;
+}
+
+static void
+string_table_remove(DynStringTable *table, DyntypeString *dyn_str)
+{
+    uint32_t mask, i, j, k;
+
+    if (!table) {
+        return;
+    }
+
+    mask = table->capacity - 1;
+    i = dyn_str->hash & mask;
+    while (table->slots[i] != dyn_str) {
+        if (!table->slots[i]) {
+            /* not interned in this table */
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+
+    table->slots[i] = NULL;
+    table->count--;
+
+    /* move back the following entries whose home slot is not in (i, j] */
+    for (j = (i + 1) & mask; table->slots[j]; j = (j + 1) & mask) {
+        k = table->slots[j]->hash & mask;
+
+        if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j)) {
+            table->slots[i] = table->slots[j];
+            table->slots[j] = NULL;
+            i = j;
+        }
+    }
+}
+
+DynValue *
+dyn_string_new_interned(const void *buf, uint32_t length)
+{
+    DynStringTable *table = current_string_table();
+    uint32_t hash = dyn_atom_hash((const char *)buf, length);
+    DyntypeString **slot = NULL, *dyn_str;
+
+    if (table) {
+        slot = string_table_lookup_slot(table, buf, length, hash);
+        if (*slot) {
+            return dyn_value_hold((DynValue *)*slot);
+        }
+
+        /* keep load factor below 3/4, don't intern if the table can't grow */
+        if ((table->count + 1) * 4 > table->capacity * 3) {
+            slot = string_table_grow(table)
+                       ? string_table_lookup_slot(table, buf, length, hash)
+                       : NULL;
+        }
+    }
+
+    if (!(dyn_str = dyn_string_new_flat(length))) {
+        return NULL;
+    }
+
+    bh_memcpy_s(dyn_str->data, length, buf, length);
+    dyn_str->hash = hash;
+    dyn_str->flags |= DYN_STRING_FLAG_HASHED;
+
+    if (slot) {
+        dyn_str->flags |= DYN_STRING_FLAG_INTERNED;
+        *slot = dyn_str;
+        table->count++;
+    }
+
+    return (DynValue *)dyn_str;
+}
+
+uint32_t
+dyn_string_hash(DyntypeString *dyn_str)
+{
+    uint8_t *data;
+
+    if (dyn_str->flags & DYN_STRING_FLAG_HASHED) {
+        return dyn_str->hash;
+    }
+
+    if (!(data = dyn_string_data(dyn_str))) {
+        return 0;
+    }
+
+    dyn_str->hash = dyn_atom_hash((const char *)data, dyn_str->length);
+    dyn_str->flags |= DYN_STRING_FLAG_HASHED;
+
+    return dyn_str->hash;
+}
+
+uint8_t *
+dyn_string_data(DyntypeString *dyn_str)
+{
+    uint8_t *buf;
+
+    if (dyn_str->data) {
+        return dyn_str->data;
+    }
+
+    buf = (uint8_t *)wasm_runtime_malloc(dyn_str->length + 1);
+    if (!buf) {
+        return NULL;
+    }
+
+    rope_copy(dyn_str, buf);
+    buf[dyn_str->length] = '\0';
+
+    dyn_value_release((DynValue *)dyn_str->u.rope.left);
+    dyn_value_release((DynValue *)dyn_str->u.rope.right);
+    dyn_str->u.rope.left = dyn_str->u.rope.right = NULL;
+    dyn_str->depth = 0;
+    dyn_str->data = buf;
+
+    return buf;
+}
+
+uint32_t
+dyn_string_size(DyntypeString *dyn_str)
+{
+    return string_is_flat(dyn_str) ? DYN_STRING_FLAT_SIZE(dyn_str->length)
+                                   : sizeof(DyntypeString);
+}
+
+void
+dyn_string_destroy(DyntypeString *dyn_str)
+{
+    if (dyn_str->flags & DYN_STRING_FLAG_INTERNED) {
+        DynTypeContext *owner = dyn_value_owner((DynValue *)dyn_str);
+
+        string_table_remove(owner ? owner->string_table : NULL, dyn_str);
+    }
+
+    if (string_is_flat(dyn_str)) {
+        return;
+    }
+
+    if (dyn_str->data) {
+        wasm_runtime_free(dyn_str->data);
+    }
+    else {
+        /* releasing children recurses at most DYN_ROPE_MAX_DEPTH levels */
+        dyn_value_release((DynValue *)dyn_str->u.rope.left);
+        dyn_value_release((DynValue *)dyn_str->u.rope.right);
+    }
+}
+
+DyntypeString *
+dyn_string_concat(DyntypeString *dyn_str1, DyntypeString *dyn_str2)
+{
+    uint64_t length = (uint64_t)dyn_str1->length + dyn_str2->length;
+    uint32_t depth1, depth2;
+
+    if (length >= UINT32_MAX) {
+        return NULL;
+    }
+
+    /* strings are immutable, an empty operand can be shared */
+    if (dyn_str1->length == 0) {
+        return (DyntypeString *)dyn_value_hold((DynValue *)dyn_str2);
+    }
+    if (dyn_str2->length == 0) {
+        return (DyntypeString *)dyn_value_hold((DynValue *)dyn_str1);
+    }
+
+    if (length < DYN_ROPE_MIN_LENGTH) {
+        return flat_concat(dyn_str1, dyn_str2);
+    }
+
+    /* appending a short string to a rope ending with a short leaf: merge the
+     * two leaves so that repeated appends don't deepen the tree */
+    if (!dyn_str1->data && dyn_str2->data
+        && dyn_str1->u.rope.right->data
+        && dyn_str1->u.rope.right->length + dyn_str2->length
+               <= DYN_ROPE_LEAF_LENGTH) {
+        DyntypeString *right = flat_concat(dyn_str1->u.rope.right, dyn_str2);
+
+        if (!right) {
+            return NULL;
+        }
+        return rope_new((DyntypeString *)dyn_value_hold(
+                            (DynValue *)dyn_str1->u.rope.left),
+                        right);
+    }
+
+    depth1 = string_depth(dyn_str1);
+    depth2 = string_depth(dyn_str2);
+    if ((depth1 > depth2 ? depth1 : depth2) + 1 > DYN_ROPE_MAX_DEPTH) {
+        return rope_rebalance(dyn_str1, dyn_str2);
+    }
+
+    return rope_new((DyntypeString *)dyn_value_hold((DynValue *)dyn_str1),
+                    (DyntypeString *)dyn_value_hold((DynValue *)dyn_str2));
+}
+
+int32_t
+dyn_string_eq(DyntypeString *dyn_str1, DyntypeString *dyn_str2)
+{
+    uint8_t *data1, *data2;
+
+    if (dyn_str1 == dyn_str2) {
+        return true;
+    }
+
+    if (dyn_str1->length != dyn_str2->length) {
+        return false;
+    }
+
+    /* interned strings have distinct contents */
+    if ((dyn_str1->flags & dyn_str2->flags & DYN_STRING_FLAG_INTERNED)) {
+        return false;
+    }
+
+    if ((dyn_str1->flags & dyn_str2->flags & DYN_STRING_FLAG_HASHED)
+        && dyn_str1->hash != dyn_str2->hash) {
+        return false;
+    }
+
+    if (!(data1 = dyn_string_data(dyn_str1))
+        || !(data2 = dyn_string_data(dyn_str2))) {
+        return false;
+    }
+
+    return memcmp(data1, data2, dyn_str1->length) == 0 ? true : false;
+}
+
+DyntypeString *
+dyn_string_slice(DyntypeString *dyn_str, uint32_t start, uint32_t end)
+{
+    uint32_t actual_end;
+    uint8_t *data;
+    DyntypeString *dyn_str_res = NULL;
+
+    actual_end = end == UINT32_MAX ? dyn_str->length : end;
+
+    if (!(data = dyn_string_data(dyn_str))) {
+        return NULL;
+    }
+
+    dyn_str_res = dyn_string_new_flat(actual_end - start);
+    if (!dyn_str_res) {
+        return NULL;
+    }
+
+    bh_memcpy_s(dyn_str_res->data, dyn_str_res->length, data + start,
+                dyn_str_res->length);
+
+    return dyn_str_res;
+}
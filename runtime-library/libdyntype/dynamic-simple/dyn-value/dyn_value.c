@@ -6,21 +6,25 @@
 #include "class/dyn_class.h"
 #include "libdyntype_export.h"
 #include "pure_dynamic.h"
+#include "type.h"
+#include <math.h>
 
 #define INIT_OBJ_PROPERTY_NUM 4
 
 extern ClassMeta *class_meta_array[DynClassEnd];
 
+/* property keys are interned atoms, so the hash is precomputed and keys are
+ * compared by identity */
 static uint32_t
 prop_key_hash(const void *key)
 {
-    return (uint32)(uintptr_t)key;
+    return ((const DynAtom *)key)->hash;
 }
 
 static bool
 prop_key_equal(void *h1, void *h2)
 {
-    return strcmp(h1, h2) == 0 ? true : false;
+    return h1 == h2 ? true : false;
 }
 
 static void
@@ -29,54 +33,114 @@ prop_value_destroyer(void *value)
     dynamic_release(NULL, (dyn_value_t)value);
 }
 
+void *
+dyn_value_alloc(uint8_t class_id, uint32_t size)
+{
+    DynTypeContext *ctx = dynamic_get_context();
+
+    if (!ctx) {
+        return dyn_allocator_alloc(NULL, class_id, size);
+    }
+
+    return dyn_allocator_alloc(&ctx->allocator, class_id, size);
+}
+
+/* Allocate a value which may become part of a cycle. Like
+ * dyn_gc_maybe_collect, it must only be called where no uncounted reference
+ * is held: if the memory limit is reached, garbage cycles are collected and
+ * the allocation is retried once. */
+static void *
+dyn_value_alloc_collectable(uint8_t class_id, uint32_t size)
+{
+    DynTypeContext *ctx = dynamic_get_context();
+    void *ptr;
+
+    dyn_gc_maybe_collect();
+
+    ptr = dyn_value_alloc(class_id, size);
+    if (!ptr && ctx && ctx->allocator.memory_limit) {
+        /* the limit may be reached because of garbage cycles */
+        dyn_gc_collect(&ctx->gc);
+        ptr = dyn_value_alloc(class_id, size);
+    }
+
+    return ptr;
+}
+
+void
+dyn_value_free(void *ptr, uint8_t class_id, uint32_t size)
+{
+    DynTypeContext *owner = dyn_value_owner((DynValue *)ptr);
+
+    dyn_allocator_free(owner ? &owner->allocator : NULL, ptr, class_id, size);
+}
+
+uint8_t
+dyn_value_current_ctx_id()
+{
+    DynTypeContext *ctx = dynamic_get_context();
+
+    return ctx ? ctx->id : 0;
+}
+
+struct DynTypeContext *
+dyn_value_owner(DynValue *value)
+{
+    return dynamic_context_from_id(value->ctx_id);
+}
+
 DynValue *
 dyn_value_new_number(double value)
 {
+#if DYN_IMMEDIATE_NUMBER != 0
+    uint64_t bits;
+
+    if (isnan(value)) {
+        bits = 0x7ff8000000000000ULL;
+    }
+    else {
+        memcpy(&bits, &value, sizeof(double));
+    }
+
+    return (DynValue *)(uintptr_t)(bits + DYN_NUMBER_ENCODE_OFFSET);
+#else
     DyntypeNumber *dyn_num =
-        (DyntypeNumber *)wasm_runtime_malloc(sizeof(DyntypeNumber));
+        (DyntypeNumber *)dyn_value_alloc(DynClassNumber, sizeof(DyntypeNumber));
     if (!dyn_num) {
         return NULL;
     }
 
     dyn_num->header.type = DynNumber;
     dyn_num->header.class_id = DynClassNumber;
+    dyn_num->header.gc_flags = 0;
+    dyn_num->header.ctx_id = dyn_value_current_ctx_id();
     dyn_num->header.ref_count = 1;
     dyn_num->value = value;
 
     return (DynValue *)dyn_num;
+#endif
 }
 
 DynValue *
 dyn_value_new_boolean(bool value)
 {
-    DyntypeBoolean *dyn_bool =
-        (DyntypeBoolean *)wasm_runtime_malloc(sizeof(DyntypeBoolean));
-    if (!dyn_bool) {
-        return NULL;
-    }
-
-    dyn_bool->header.type = DynBoolean;
-    dyn_bool->header.class_id = DynClassBoolean;
-    dyn_bool->header.ref_count = 1;
-    dyn_bool->value = value;
-
-    return (DynValue *)dyn_bool;
+    return (DynValue *)(uintptr_t)(value ? DYN_TAG_TRUE : DYN_TAG_FALSE);
 }
 
 DynValue *
 dyn_value_new_string(const void *buf, uint32_t length)
 {
-    uint32 total_size = offsetof(DyntypeString, data) + length + 1;
-    DyntypeString *dyn_str = (DyntypeString *)wasm_runtime_malloc(total_size);
+    DyntypeString *dyn_str;
+
+    if (length <= DYN_STRING_INTERN_MAX_LENGTH) {
+        return dyn_string_new_interned(buf, length);
+    }
+
+    dyn_str = dyn_string_new_flat(length);
     if (!dyn_str) {
         return NULL;
     }
-    memset(dyn_str, 0, total_size);
 
-    dyn_str->header.type = DynString;
-    dyn_str->header.class_id = DynClassString;
-    dyn_str->header.ref_count = 1;
-    dyn_str->length = length;
     bh_memcpy_s(dyn_str->data, length, buf, length);
 
     return (DynValue *)dyn_str;
@@ -85,23 +149,13 @@ dyn_value_new_string(const void *buf, uint32_t length)
 DynValue *
 dyn_value_new_undefined()
 {
-    static DynValue dyn_undefined = {
-        .type = DynUndefined,
-        .ref_count = 1,
-    };
-
-    return &dyn_undefined;
+    return (DynValue *)(uintptr_t)DYN_TAG_UNDEFINED;
 }
 
 DynValue *
 dyn_value_new_null()
 {
-    static DynValue dyn_null = {
-        .type = DynNull,
-        .ref_count = 1,
-    };
-
-    return &dyn_null;
+    return (DynValue *)(uintptr_t)DYN_TAG_NULL;
 }
 
 bool
@@ -109,41 +163,194 @@ init_dyn_object(DyntypeObject *dyn_obj, uint32_t class_id)
 {
     dyn_obj->header.type = DynObject;
     dyn_obj->header.class_id = class_id;
+    dyn_obj->header.gc_flags = 0;
+    dyn_obj->header.ctx_id = dyn_value_current_ctx_id();
     dyn_obj->header.ref_count = 1;
-    dyn_obj->properties = bh_hash_map_create(
-        INIT_OBJ_PROPERTY_NUM, false, prop_key_hash, prop_key_equal,
-        wasm_runtime_free, prop_value_destroyer);
+    dyn_obj->shape = NULL;
+    dyn_obj->properties = NULL;
+    dyn_obj->slot_capacity = DYN_OBJ_INLINE_SLOT_NUM;
+    dyn_obj->slots = dyn_obj->inline_slots;
+
+    return true;
+}
+
+static uint32_t
+object_property_count(DyntypeObject *dyn_obj)
+{
+    return dyn_obj->shape ? dyn_obj->shape->prop_count : 0;
+}
+
+static void
+free_object_slots(DyntypeObject *dyn_obj)
+{
+    if (dyn_obj->slots && dyn_obj->slots != dyn_obj->inline_slots) {
+        wasm_runtime_free(dyn_obj->slots);
+    }
+
+    dyn_obj->slots = NULL;
+    dyn_obj->slot_capacity = 0;
+}
+
+/* Move all properties from the slots into a hash map, ownership of the
+ * values is transferred to the map */
+static bool
+object_to_dictionary(DyntypeObject *dyn_obj)
+{
+    uint32_t i, count = object_property_count(dyn_obj);
+    HashMap *map = bh_hash_map_create(
+        count > INIT_OBJ_PROPERTY_NUM ? count : INIT_OBJ_PROPERTY_NUM, false,
+        prop_key_hash, prop_key_equal, NULL, prop_value_destroyer);
+
+    if (!map) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!bh_hash_map_insert(map, dyn_obj->shape->keys[i],
+                                dyn_obj->slots[i])) {
+            /* values are still owned by the slots */
+            uint32_t j;
+
+            for (j = 0; j < i; j++) {
+                bh_hash_map_remove(map, dyn_obj->shape->keys[j], NULL, NULL);
+            }
+            bh_hash_map_destroy(map);
+            return false;
+        }
+    }
+
+    free_object_slots(dyn_obj);
+    dyn_obj->shape = NULL;
+    dyn_obj->properties = map;
+
+    return true;
+}
+
+DynValue *
+dyn_object_get_property(DyntypeObject *dyn_obj, DynAtom *key)
+{
+    int32_t index;
+
+    if (dyn_obj->properties) {
+        return bh_hash_map_find(dyn_obj->properties, (void *)key);
+    }
+
+    if (!dyn_obj->shape) {
+        return NULL;
+    }
+
+    index = dyn_shape_find_key(dyn_obj->shape, key);
+    return index >= 0 ? dyn_obj->slots[index] : NULL;
+}
+
+bool
+dyn_object_set_property(DyntypeObject *dyn_obj, DynShape *root_shape,
+                        DynAtom *key, DynValue *value)
+{
+    DynShape *shape = dyn_obj->shape ? dyn_obj->shape : root_shape;
+    DynShape *new_shape;
+    DynValue *old_value = NULL;
+    int32_t index;
+
     if (!dyn_obj->properties) {
+        index = dyn_shape_find_key(shape, key);
+        if (index >= 0) {
+            old_value = dyn_obj->slots[index];
+            dyn_obj->slots[index] = dyn_value_hold(value);
+            dyn_value_release(old_value);
+            return true;
+        }
+
+        new_shape = dyn_shape_add_key(shape, key);
+        if (new_shape) {
+            if (new_shape->prop_count > dyn_obj->slot_capacity) {
+                uint32_t new_capacity = dyn_obj->slot_capacity * 2;
+                DynValue **new_slots;
+
+                if (new_capacity < new_shape->prop_count) {
+                    new_capacity = new_shape->prop_count;
+                }
+
+                new_slots = (DynValue **)wasm_runtime_malloc(
+                    sizeof(DynValue *) * new_capacity);
+                if (!new_slots) {
+                    return false;
+                }
+
+                bh_memcpy_s(new_slots, sizeof(DynValue *) * new_capacity,
+                            dyn_obj->slots,
+                            sizeof(DynValue *) * shape->prop_count);
+                free_object_slots(dyn_obj);
+                dyn_obj->slots = new_slots;
+                dyn_obj->slot_capacity = new_capacity;
+            }
+
+            dyn_obj->slots[new_shape->prop_count - 1] = dyn_value_hold(value);
+            dyn_obj->shape = new_shape;
+            return true;
+        }
+
+        if (!object_to_dictionary(dyn_obj)) {
+            return false;
+        }
+    }
+
+    if (bh_hash_map_update(dyn_obj->properties, (void *)key, value,
+                           (void **)&old_value)) {
+        dyn_value_hold(value);
+        dyn_value_release(old_value);
+        return true;
+    }
+
+    if (!bh_hash_map_insert(dyn_obj->properties, (void *)key, value)) {
         return false;
     }
+    dyn_value_hold(value);
 
     return true;
 }
 
 bool
-init_dyn_object_properties(DyntypeObject *dyn_obj)
+dyn_object_delete_property(DyntypeObject *dyn_obj, DynAtom *key)
 {
-    dyn_obj->properties = bh_hash_map_create(
-        INIT_OBJ_PROPERTY_NUM, false, prop_key_hash, prop_key_equal,
-        wasm_runtime_free, prop_value_destroyer);
+    void *orig_key;
+    DynValue *value = NULL;
+
     if (!dyn_obj->properties) {
+        if (!dyn_obj->shape || dyn_shape_find_key(dyn_obj->shape, key) < 0) {
+            return false;
+        }
+
+        /* Removing a key doesn't fit a transition tree, the object is
+         * unlikely to be used as a record any more */
+        if (!object_to_dictionary(dyn_obj)) {
+            return false;
+        }
+    }
+
+    if (!bh_hash_map_remove(dyn_obj->properties, (void *)key, &orig_key,
+                            (void **)&value)) {
         return false;
     }
 
+    dyn_value_release(value);
+
     return true;
 }
 
 DynValue *
 dyn_value_new_object()
 {
-    DyntypeObject *dyn_obj =
-        (DyntypeObject *)wasm_runtime_malloc(sizeof(DyntypeObject));
+    DyntypeObject *dyn_obj;
+
+    dyn_obj = (DyntypeObject *)dyn_value_alloc_collectable(
+        DynClassObject, sizeof(DyntypeObject));
     if (!dyn_obj) {
         return NULL;
     }
 
     if (!init_dyn_object(dyn_obj, DynClassObject)) {
-        wasm_runtime_free(dyn_obj);
+        dyn_value_free(dyn_obj, DynClassObject, sizeof(DyntypeObject));
         return NULL;
     }
 
@@ -153,22 +360,132 @@ dyn_value_new_object()
 DynValue *
 dyn_value_new_array(int len)
 {
-    uint32_t total_size =
-        offsetof(DyntypeArray, data) + len * sizeof(DynValue *);
-    DyntypeArray *dyn_array = (DyntypeArray *)wasm_runtime_malloc(total_size);
+    DyntypeArray *dyn_array;
+
+    if (len < 0) {
+        return NULL;
+    }
 
-    memset(dyn_array, 0, total_size);
+    dyn_array = (DyntypeArray *)dyn_value_alloc_collectable(
+        DynClassArray, sizeof(DyntypeArray));
+    if (!dyn_array) {
+        return NULL;
+    }
+
+    memset(dyn_array, 0, sizeof(DyntypeArray));
 
     if (!init_dyn_object((DyntypeObject *)dyn_array, DynClassArray)) {
-        wasm_runtime_free(dyn_array);
+        dyn_value_free(dyn_array, DynClassArray, sizeof(DyntypeArray));
         return NULL;
     }
 
-    dyn_array->length = len;
+    if (len > 0 && !dyn_array_reserve(dyn_array, (uint32_t)len)) {
+        dyn_value_free(dyn_array, DynClassArray, sizeof(DyntypeArray));
+        return NULL;
+    }
+
+    /* elements not set yet are holes */
+    dyn_array->length = (uint32_t)len;
 
     return (DynValue *)dyn_array;
 }
 
+bool
+dyn_array_reserve(DyntypeArray *dyn_array, uint32_t capacity)
+{
+    uint64_t new_capacity, total_size;
+    DynValue **new_data;
+
+    if (capacity <= dyn_array->capacity) {
+        return true;
+    }
+
+    /* grow geometrically so that appending is amortized O(1) */
+    new_capacity = (uint64_t)dyn_array->capacity * 2;
+    if (new_capacity < capacity) {
+        new_capacity = capacity;
+    }
+    if (new_capacity < DYN_ARRAY_MIN_CAPACITY) {
+        new_capacity = DYN_ARRAY_MIN_CAPACITY;
+    }
+
+    total_size = new_capacity * sizeof(DynValue *);
+    if (total_size > UINT32_MAX) {
+        new_capacity = capacity;
+        total_size = new_capacity * sizeof(DynValue *);
+        if (total_size > UINT32_MAX) {
+            return false;
+        }
+    }
+
+    new_data = (DynValue **)wasm_runtime_realloc(dyn_array->data,
+                                                 (uint32_t)total_size);
+    if (!new_data) {
+        return false;
+    }
+
+    memset(new_data + dyn_array->capacity, 0,
+           (uint32_t)(new_capacity - dyn_array->capacity)
+               * sizeof(DynValue *));
+    dyn_array->data = new_data;
+    dyn_array->capacity = (uint32_t)new_capacity;
+
+    return true;
+}
+
+bool
+dyn_array_set_elem(DyntypeArray *dyn_array, uint32_t index, DynValue *elem)
+{
+    DynValue *old_elem = NULL;
+
+    if (index >= dyn_array->length) {
+        if (index == UINT32_MAX
+            || !dyn_array_reserve(dyn_array, index + 1)) {
+            return false;
+        }
+        /* slots between the old length and index are already holes */
+        dyn_array->length = index + 1;
+    }
+    else {
+        old_elem = dyn_array->data[index];
+    }
+
+    dyn_array->data[index] = dyn_value_hold(elem);
+
+    if (old_elem) {
+        dyn_value_release(old_elem);
+    }
+
+    return true;
+}
+
+bool
+dyn_array_push(DyntypeArray *dyn_array, DynValue *elem)
+{
+    if (dyn_array->length < dyn_array->capacity) {
+        dyn_array->data[dyn_array->length++] = dyn_value_hold(elem);
+        return true;
+    }
+
+    return dyn_array_set_elem(dyn_array, dyn_array->length, elem);
+}
+
+DynValue *
+dyn_array_pop(DyntypeArray *dyn_array)
+{
+    DynValue *elem;
+
+    if (dyn_array->length == 0) {
+        return dyn_value_new_undefined();
+    }
+
+    elem = dyn_array->data[--dyn_array->length];
+    dyn_array->data[dyn_array->length] = NULL;
+
+    /* ownership is transferred to the caller */
+    return elem ? elem : dyn_value_new_undefined();
+}
+
 DynValue *
 dyn_value_get_global(const char *name)
 {
@@ -177,8 +494,7 @@ dyn_value_get_global(const char *name)
     /* TODO: throw exception */
     assert(dyn_value);
 
-    dyn_value->ref_count++;
-    return dyn_value;
+    return dyn_value_hold(dyn_value);
 }
 
 DynValue *
@@ -196,13 +512,13 @@ DynValue *
 dyn_value_new_extref(void *ptr, external_ref_tag tag, void *opaque)
 {
     DyntypeExtref *dyn_extref =
-        (DyntypeExtref *)wasm_runtime_malloc(sizeof(DyntypeExtref));
+        (DyntypeExtref *)dyn_value_alloc(DynClassExtref, sizeof(DyntypeExtref));
     if (!dyn_extref) {
         return NULL;
     }
 
     if (!init_dyn_object((DyntypeObject *)dyn_extref, DynClassExtref)) {
-        wasm_runtime_free(dyn_extref);
+        dyn_value_free(dyn_extref, DynClassExtref, sizeof(DyntypeExtref));
         return NULL;
     }
 
@@ -230,25 +546,33 @@ object_property_keys(void *key, void *value, void *user_data)
 {
     struct ArraySetter *setter_info = (struct ArraySetter *)user_data;
     DynValue *dyn_array = setter_info->dyn_array;
-    DynValue *key_string = dyn_value_new_string(key, strlen(key));
+    DynAtom *atom = (DynAtom *)key;
+    /* keys come from the atom table, so interning them is bounded */
+    DynValue *key_string = dyn_string_new_interned(atom->str, atom->length);
     uint32_t index = setter_info->index;
 
     dynamic_set_elem(NULL, dyn_array, index,
                      key_string);
     /* transfer ownership to the array */
-    key_string->ref_count--;
+    dyn_value_release(key_string);
     setter_info->index++;
 }
 
 DynValue *
 dyn_value_get_keys(DynValue *obj)
 {
-    uint32_t count = 0;
+    uint32_t i, count = 0;
     DyntypeObject *dyn_obj = (DyntypeObject *)obj;
     DyntypeArray *dyn_array = NULL;
     struct ArraySetter setter_info;
 
-    bh_hash_map_traverse(dyn_obj->properties, object_property_counter, &count);
+    if (dyn_obj->properties) {
+        bh_hash_map_traverse(dyn_obj->properties, object_property_counter,
+                             &count);
+    }
+    else {
+        count = object_property_count(dyn_obj);
+    }
 
     dyn_array = (DyntypeArray *)dyn_value_new_array(count);
     if (!dyn_array) {
@@ -258,8 +582,16 @@ dyn_value_get_keys(DynValue *obj)
     setter_info.dyn_array = (DynValue *)dyn_array;
     setter_info.index = 0;
 
-    bh_hash_map_traverse(dyn_obj->properties, object_property_keys,
-                         &setter_info);
+    if (dyn_obj->properties) {
+        bh_hash_map_traverse(dyn_obj->properties, object_property_keys,
+                             &setter_info);
+    }
+    else {
+        /* shape keys are already in insertion order */
+        for (i = 0; i < count; i++) {
+            object_property_keys(dyn_obj->shape->keys[i], NULL, &setter_info);
+        }
+    }
 
     return (DynValue *)dyn_array;
 }
@@ -278,108 +610,176 @@ DynValue *
 dyn_value_hold(DynValue *obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    dyn_value->ref_count++;
+
+    if (dyn_value_is_immediate(dyn_value)) {
+        return obj;
+    }
+
+    if (dyn_value->ref_count != DYN_REF_COUNT_MAX) {
+        dyn_value->ref_count++;
+    }
+    /* a value being referenced again is not garbage */
+    dyn_value->gc_flags &= ~DYN_GC_COLOR_MASK;
     return obj;
 }
 
+uint32_t
+dyn_value_size(DynValue *dyn_value)
+{
+    switch (dyn_value->class_id) {
+        case DynClassNumber:
+            return sizeof(DyntypeNumber);
+        case DynClassString:
+            return dyn_string_size((DyntypeString *)dyn_value);
+        case DynClassArray:
+            return sizeof(DyntypeArray);
+        case DynClassExtref:
+            return sizeof(DyntypeExtref);
+        case DynClassDate:
+            return sizeof(DyntypeDate);
+        default:
+            return sizeof(DyntypeObject);
+    }
+}
+
+/* Release the children of an object and free its property storage, the
+ * object is left empty */
 static void
-dyn_value_destroy(void *obj)
+object_release_contents(DyntypeObject *dyn_obj)
 {
-    DynValue *dyn_value = (DynValue *)obj;
+    uint32 i, count = object_property_count(dyn_obj);
+
+    if (dyn_obj->properties) {
+        bh_hash_map_destroy(dyn_obj->properties);
+        dyn_obj->properties = NULL;
+    }
 
-    if (dyn_value->type == DynObject) {
-        bh_hash_map_destroy(((DyntypeObject *)dyn_value)->properties);
+    for (i = 0; i < count; i++) {
+        dyn_value_release(dyn_obj->slots[i]);
+    }
+    free_object_slots(dyn_obj);
+    dyn_obj->shape = NULL;
 
-        if (dyn_value->class_id == DynClassArray) {
-            uint32 i;
-            DyntypeArray *arr = (DyntypeArray *)dyn_value;
+    if (dyn_obj->header.class_id == DynClassArray) {
+        DyntypeArray *arr = (DyntypeArray *)dyn_obj;
 
-            for (i = 0; i < arr->length; i++) {
-                if (arr->data[i]) {
-                    dyn_value_release(arr->data[i]);
-                }
+        for (i = 0; i < arr->length; i++) {
+            if (arr->data[i]) {
+                dyn_value_release(arr->data[i]);
             }
         }
-    }
 
-    wasm_runtime_free(dyn_value);
+        if (arr->data) {
+            wasm_runtime_free(arr->data);
+        }
+        arr->data = NULL;
+        arr->length = arr->capacity = 0;
+    }
 }
 
-void
-dyn_value_release(DynValue *obj)
+static void
+dyn_value_destroy(void *obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
 
-    if (dyn_value->type == DynUndefined || dyn_value->type == DynNull) {
+    if (dyn_value->type == DynString) {
+        dyn_string_destroy((DyntypeString *)dyn_value);
+    }
+    else if (dyn_value->type == DynObject) {
+        if (dyn_value->class_id == DynClassExtref) {
+            DyntypeExtref *extref = (DyntypeExtref *)dyn_value;
+            dyn_ctx_t ctx = dyn_value_owner(dyn_value);
+            dyntype_extref_release_t release =
+                dyntype_get_extref_release_callback(ctx);
+
+            /* the embedder's object is no longer referred to by this extref */
+            if (release) {
+                release(ctx, (void *)(uintptr_t)extref->ref,
+                        (external_ref_tag)extref->tag);
+            }
+        }
+        object_release_contents((DyntypeObject *)dyn_value);
+    }
+
+    if (dyn_value->gc_flags & DYN_GC_FLAG_BUFFERED) {
+        /* still referenced by the possible roots buffer, the collector frees
+         * it */
+        dyn_value->gc_flags &= ~DYN_GC_COLOR_MASK;
         return;
     }
 
-    dyn_value->ref_count--;
+    dyn_value_free(dyn_value, dyn_value->class_id, dyn_value_size(dyn_value));
+}
 
-    if (dyn_value->ref_count == 0) {
-        dyn_value_destroy(obj);
+static void
+visit_property(void *key, void *value, void *user_data)
+{
+    void **args = (void **)user_data;
+    DynValue *child = (DynValue *)value;
+
+    if (!dyn_value_is_immediate(child)) {
+        ((DynValueVisitor)args[0])(child, args[1]);
     }
 }
 
-/* string utilities */
-DyntypeString *
-dyn_string_concat(DyntypeString *dyn_str1, DyntypeString *dyn_str2)
+void
+dyn_value_visit_children(DynValue *obj, DynValueVisitor visitor,
+                         void *user_data)
 {
-    uint32_t total_size =
-        offsetof(DyntypeString, data) + dyn_str1->length + dyn_str2->length + 1;
-    DyntypeString *dyn_str = (DyntypeString *)wasm_runtime_malloc(total_size);
-    if (!dyn_str) {
-        return NULL;
-    }
-    memset(dyn_str, 0, total_size);
+    DyntypeObject *dyn_obj = (DyntypeObject *)obj;
+    uint32_t i, count;
 
-    dyn_str->header.type = DynString;
-    dyn_str->header.ref_count = 1;
-    dyn_str->header.class_id = DynClassString;
-    dyn_str->length = dyn_str1->length + dyn_str2->length;
-    bh_memcpy_s(dyn_str->data, dyn_str1->length, dyn_str1->data,
-                dyn_str1->length);
-    bh_memcpy_s(dyn_str->data + dyn_str1->length, dyn_str2->length,
-                dyn_str2->data, dyn_str2->length);
+    if (!dyn_value_may_cycle(obj)) {
+        return;
+    }
 
-    return dyn_str;
-}
+    if (dyn_obj->properties) {
+        void *args[2] = { (void *)visitor, user_data };
 
-int32_t
-dyn_string_eq(DyntypeString *dyn_str1, DyntypeString *dyn_str2)
-{
-    if (dyn_str1 == dyn_str2) {
-        return true;
+        bh_hash_map_traverse(dyn_obj->properties, visit_property, args);
     }
 
-    if (dyn_str1->length != dyn_str2->length) {
-        return false;
+    count = object_property_count(dyn_obj);
+    for (i = 0; i < count; i++) {
+        if (!dyn_value_is_immediate(dyn_obj->slots[i])) {
+            visitor(dyn_obj->slots[i], user_data);
+        }
     }
 
-    return strcmp(dyn_str1->data, dyn_str2->data) == 0 ? true : false;
+    if (obj->class_id == DynClassArray) {
+        DyntypeArray *arr = (DyntypeArray *)obj;
+
+        for (i = 0; i < arr->length; i++) {
+            if (arr->data[i] && !dyn_value_is_immediate(arr->data[i])) {
+                visitor(arr->data[i], user_data);
+            }
+        }
+    }
 }
 
-DyntypeString *
-dyn_string_slice(DyntypeString *dyn_str, uint32_t start, uint32_t end)
+void
+dyn_value_clear(DynValue *obj)
 {
-    uint32_t total_size, actual_end;
-    DyntypeString *dyn_str_res = NULL;
+    if (dyn_value_may_cycle(obj)) {
+        object_release_contents((DyntypeObject *)obj);
+    }
+}
 
-    actual_end = end == UINT32_MAX ? dyn_str->length : end;
+void
+dyn_value_release(DynValue *obj)
+{
+    DynValue *dyn_value = (DynValue *)obj;
 
-    total_size = offsetof(DyntypeString, data) + actual_end - start + 1;
-    dyn_str_res = (DyntypeString *)wasm_runtime_malloc(total_size);
-    if (!dyn_str_res) {
-        return NULL;
+    if (dyn_value_is_immediate(dyn_value)
+        || dyn_value->ref_count == DYN_REF_COUNT_MAX) {
+        return;
     }
-    memset(dyn_str_res, 0, total_size);
-
-    dyn_str_res->header.type = DynString;
-    dyn_str_res->header.ref_count = 1;
-    dyn_str->header.class_id = DynClassString;
-    dyn_str_res->length = actual_end - start;
-    bh_memcpy_s(dyn_str_res->data, dyn_str_res->length, dyn_str->data + start,
-                dyn_str_res->length);
 
-    return dyn_str_res;
+    if (--dyn_value->ref_count == 0) {
+        dyn_value_destroy(obj);
+    }
+    else if (dyn_value_may_cycle(dyn_value)) {
+        /* the last external reference of a cycle may have gone */
+        dyn_gc_possible_root(dyn_value);
+    }
 }
@@ -3,6 +3,9 @@
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
  */
 
+#ifndef __DYN_VALUE_H_
+#define __DYN_VALUE_H_
+
 #include "bh_platform.h"
 #include "libdyntype.h"
 
@@ -22,37 +25,114 @@ enum DynValueClass {
     DynClassEnd,
 };
 
+/* Reference counts saturate at this value, such values are never freed */
+#define DYN_REF_COUNT_MAX UINT32_MAX
+
+/* Cycle collector state in gc_flags, see dyn_gc.c */
+#define DYN_GC_COLOR_MASK 0x3
+#define DYN_GC_BLACK 0x0
+#define DYN_GC_GRAY 0x1
+#define DYN_GC_WHITE 0x2
+#define DYN_GC_PURPLE 0x3
+/* the value is in the possible roots buffer of the collector */
+#define DYN_GC_FLAG_BUFFERED 0x4
+/* the value is garbage being freed by the collector */
+#define DYN_GC_FLAG_GARBAGE 0x8
+
 typedef struct DynValue {
     uint8_t type;
     uint8_t class_id;
-    uint16_t ref_count;
+    uint8_t gc_flags;
+    /* id of the owning context, see dyn_value_owner */
+    uint8_t ctx_id;
+    uint32_t ref_count;
 } DynValue;
 
+/* Heap number, only used when numbers can't be encoded as immediates */
 typedef struct DyntypeNumber {
     DynValue header;
     double value;
 } DyntypeNumber;
 
-typedef struct DyntypeBoolean {
-    DynValue header;
-    bool value;
-} DyntypeBoolean;
-
+/* Concatenations producing at least DYN_ROPE_MIN_LENGTH bytes create rope
+ * nodes instead of copying, shorter results are flat. Rope depth is bounded by
+ * DYN_ROPE_MAX_DEPTH, deeper trees are rebuilt into balanced ones. */
+#define DYN_ROPE_MIN_LENGTH 64
+#define DYN_ROPE_MAX_DEPTH 48
+/* Adjacent short leaves are merged up to this length when appending or
+ * rebalancing */
+#define DYN_ROPE_LEAF_LENGTH 512
+
+/* Flat strings up to this length are interned when created, set it to 0 to
+ * only intern string literals */
+#ifndef DYN_STRING_INTERN_MAX_LENGTH
+#define DYN_STRING_INTERN_MAX_LENGTH 16
+#endif
+
+/* hash holds the FNV-1a hash of the content */
+#define DYN_STRING_FLAG_HASHED 0x1
+/* the string is referenced by the intern table of the context, no other
+ * interned string has the same content */
+#define DYN_STRING_FLAG_INTERNED 0x2
+
+/* A string is either flat (data points to inline_data) or a rope node, whose
+ * data is NULL until the first access to the bytes flattens it into a
+ * separate buffer and releases the children. data is always '\0' terminated
+ * once available, use dyn_string_data to access it. */
 typedef struct DyntypeString {
     DynValue header;
     uint32_t length;
-    uint8_t data[1];
+    /* computed lazily, see DYN_STRING_FLAG_HASHED */
+    uint32_t hash;
+    /* depth of an unflattened rope, 0 otherwise */
+    uint16_t depth;
+    uint16_t flags;
+    uint8_t *data;
+    union {
+        struct {
+            struct DyntypeString *left;
+            struct DyntypeString *right;
+        } rope;
+        uint8_t inline_data[1];
+    } u;
 } DyntypeString;
 
+#define DYN_STRING_FLAT_SIZE(length) \
+    (offsetof(DyntypeString, u.inline_data) + (length) + 1)
+
+/* Weak set of interned strings, strings remove themselves when destroyed */
+typedef struct DynStringTable {
+    uint32_t capacity;
+    uint32_t count;
+    DyntypeString **slots;
+} DynStringTable;
+
+/* Number of property slots embedded in every object */
+#define DYN_OBJ_INLINE_SLOT_NUM 4
+
+struct DynShape;
+
+/* An object stores its properties either in shape mode (shape describes the
+ * key of every slot) or in dictionary mode (properties is not NULL). Empty
+ * objects have neither a shape nor a dictionary. */
 typedef struct DyntypeObject {
     DynValue header;
+    struct DynShape *shape;
     HashMap *properties;
+    uint32_t slot_capacity;
+    DynValue **slots;
+    DynValue *inline_slots[DYN_OBJ_INLINE_SLOT_NUM];
 } DyntypeObject;
 
+#define DYN_ARRAY_MIN_CAPACITY 4
+
+/* Dense array, data holds capacity slots and NULL slots below length are
+ * holes which read as undefined */
 typedef struct DyntypeArray {
     DyntypeObject base;
     uint32_t length;
-    DynValue *data[1];
+    uint32_t capacity;
+    DynValue **data;
 } DyntypeArray;
 
 typedef struct DyntypeExtref {
@@ -66,6 +146,197 @@ typedef struct DyntypeDate {
     time_t time;
 } DyntypeDate;
 
+/* Interned property key, atoms live as long as their table and are compared
+ * by identity */
+typedef struct DynAtom {
+    uint32_t hash;
+    uint32_t length;
+    /* index in DynAtomTable.atoms plus one, exposed as dyn_atom_t */
+    uint32_t id;
+    char str[1];
+} DynAtom;
+
+typedef struct DynAtomTable {
+    uint32_t capacity;
+    uint32_t count;
+    DynAtom **slots;
+    /* atoms in creation order, count entries are used */
+    DynAtom **atoms;
+    uint32_t atoms_capacity;
+} DynAtomTable;
+
+/* Slab allocator for value structures, one per context */
+#define DYN_SLAB_CLASS_NUM 8
+
+struct DynSlabChunk;
+struct DynSlabPage;
+struct DynSlabCache;
+
+typedef struct DynAllocator {
+    korp_mutex lock;
+    uint32_t generation;
+    uint32_t page_count;
+    struct DynSlabPage *pages;
+    /* free chunks shared by all threads */
+    struct DynSlabChunk *free_list[DYN_SLAB_CLASS_NUM];
+    /* per-thread caches, see dyn_alloc.c */
+    struct DynSlabCache *caches;
+    /* max bytes of slab pages plus large blocks, 0 for no limit */
+    uint64_t memory_limit;
+    /* bytes of large blocks, only tracked with a memory limit */
+    uint64_t large_total;
+} DynAllocator;
+
+typedef struct DynAllocUsage {
+    /* live values and their requested size per DynValueClass */
+    int64_t live_count[DynClassEnd];
+    int64_t live_bytes[DynClassEnd];
+    uint64_t total_live_bytes;
+    /* bytes of slab chunks in use, including size class rounding */
+    uint64_t slab_chunk_bytes;
+    /* bytes allocated outside of the slabs for large values */
+    uint64_t large_bytes;
+    /* slab pages plus large blocks */
+    uint64_t reserved_bytes;
+    /* 1 - total_live_bytes / reserved_bytes */
+    double fragmentation;
+} DynAllocUsage;
+
+/* Objects exceeding these limits are switched to dictionary mode */
+#define DYN_SHAPE_MAX_PROPS 32
+#define DYN_SHAPE_MAX_TRANSITIONS 64
+
+/* Default number of possible cycle roots triggering a collection */
+#define DYN_GC_ROOT_THRESHOLD 10000
+
+/* Trial deletion cycle collector, one per context */
+typedef struct DynGC {
+    uint32_t root_count;
+    uint32_t root_capacity;
+    DynValue **roots;
+    /* collect when root_count reaches it, 0 to only collect on request */
+    uint32_t threshold;
+    bool collecting;
+} DynGC;
+
+/* Hidden class shared by all objects built with the same key sequence, keys[i]
+ * is the key of slot i. Shapes form a transition tree owned by the context. */
+typedef struct DynShape {
+    struct DynShape *parent;
+    struct DynShape *first_child;
+    struct DynShape *next_sibling;
+    uint32_t child_count;
+    uint32_t prop_count;
+    DynAtom *keys[1];
+} DynShape;
+
+/*
+ * Immediate values
+ *
+ * undefined, null and booleans are never allocated, they are encoded in the
+ * low bits of the pointer, which are always zero for heap values. On 64-bit
+ * hosts numbers are immediates too: the double bits are shifted up by
+ * DYN_NUMBER_ENCODE_OFFSET so every encoded number lies above the usual user
+ * space address range (at most 48 bits), NaN is canonicalized before
+ * encoding. Immediates are not reference counted.
+ *
+ * Hosts which may map the heap at or above DYN_NUMBER_ENCODE_OFFSET (57-bit
+ * or 52-bit virtual addresses, pointers with tags in the top byte) must build
+ * with DYN_IMMEDIATE_NUMBER=0, otherwise the allocator fails every value
+ * allocated there instead of letting it be read as a number.
+ */
+#define DYN_TAG_MASK 0x3
+#define DYN_TAG_NULL 0x2
+#define DYN_TAG_FALSE 0x6
+#define DYN_TAG_TRUE 0x7
+#define DYN_TAG_UNDEFINED 0xa
+
+#if UINTPTR_MAX != UINT64_MAX
+#undef DYN_IMMEDIATE_NUMBER
+#define DYN_IMMEDIATE_NUMBER 0
+#elif !defined(DYN_IMMEDIATE_NUMBER)
+#define DYN_IMMEDIATE_NUMBER 1
+#endif
+
+#if DYN_IMMEDIATE_NUMBER != 0
+#define DYN_NUMBER_ENCODE_OFFSET ((uintptr_t)1 << 49)
+#endif
+
+static inline bool
+dyn_value_is_immediate(const DynValue *value)
+{
+    uintptr_t bits = (uintptr_t)value;
+
+#if DYN_IMMEDIATE_NUMBER != 0
+    if (bits >= DYN_NUMBER_ENCODE_OFFSET) {
+        return true;
+    }
+#endif
+    return (bits & DYN_TAG_MASK) != 0 ? true : false;
+}
+
+static inline uint8_t
+dyn_value_type(const DynValue *value)
+{
+    uintptr_t bits = (uintptr_t)value;
+
+    if (!dyn_value_is_immediate(value)) {
+        return value->type;
+    }
+
+#if DYN_IMMEDIATE_NUMBER != 0
+    if (bits >= DYN_NUMBER_ENCODE_OFFSET) {
+        return DynNumber;
+    }
+#endif
+
+    switch (bits) {
+        case DYN_TAG_NULL:
+            return DynNull;
+        case DYN_TAG_UNDEFINED:
+            return DynUndefined;
+        default:
+            return DynBoolean;
+    }
+}
+
+static inline uint8_t
+dyn_value_class_id(const DynValue *value)
+{
+    if (!dyn_value_is_immediate(value)) {
+        return value->class_id;
+    }
+
+    switch (dyn_value_type(value)) {
+        case DynNumber:
+            return DynClassNumber;
+        case DynBoolean:
+            return DynClassBoolean;
+        default:
+            return DynClassNone;
+    }
+}
+
+static inline double
+dyn_value_get_number(const DynValue *value)
+{
+#if DYN_IMMEDIATE_NUMBER != 0
+    uint64_t bits = (uint64_t)((uintptr_t)value - DYN_NUMBER_ENCODE_OFFSET);
+    double number;
+
+    memcpy(&number, &bits, sizeof(double));
+    return number;
+#else
+    return ((const DyntypeNumber *)value)->value;
+#endif
+}
+
+static inline bool
+dyn_value_get_boolean(const DynValue *value)
+{
+    return (uintptr_t)value == DYN_TAG_TRUE ? true : false;
+}
+
 DynValue *
 dyn_value_new_number(double value);
 
@@ -84,8 +355,17 @@ dyn_value_new_null();
 bool
 init_dyn_object(DyntypeObject *dyn_obj, uint32_t class_id);
 
+/* Return the value of key without increasing its reference count, or NULL if
+ * the property doesn't exist */
+DynValue *
+dyn_object_get_property(DyntypeObject *dyn_obj, DynAtom *key);
+
 bool
-init_dyn_object_properties(DyntypeObject *dyn_obj);
+dyn_object_set_property(DyntypeObject *dyn_obj, DynShape *root_shape,
+                        DynAtom *key, DynValue *value);
+
+bool
+dyn_object_delete_property(DyntypeObject *dyn_obj, DynAtom *key);
 
 DynValue *
 dyn_value_new_object();
@@ -93,6 +373,21 @@ dyn_value_new_object();
 DynValue *
 dyn_value_new_array(int len);
 
+/* array utilities */
+bool
+dyn_array_reserve(DyntypeArray *dyn_array, uint32_t capacity);
+
+/* Set elem at index, the array grows if index >= length */
+bool
+dyn_array_set_elem(DyntypeArray *dyn_array, uint32_t index, DynValue *elem);
+
+bool
+dyn_array_push(DyntypeArray *dyn_array, DynValue *elem);
+
+/* Remove the last element and return it, the caller owns the reference */
+DynValue *
+dyn_array_pop(DyntypeArray *dyn_array);
+
 DynValue *
 dyn_value_get_global(const char *name);
 
@@ -115,7 +410,68 @@ dyn_value_hold(DynValue *obj);
 void
 dyn_value_release(DynValue *obj);
 
+typedef void (*DynValueVisitor)(DynValue *child, void *user_data);
+
+/* Call visitor on every heap value directly referenced by an object or array,
+ * strings have no visited children */
+void
+dyn_value_visit_children(DynValue *obj, DynValueVisitor visitor,
+                         void *user_data);
+
+/* Release all properties and elements of an object or array */
+void
+dyn_value_clear(DynValue *obj);
+
+/* Size of the structure allocated for a heap value */
+uint32_t
+dyn_value_size(DynValue *dyn_value);
+
+/* Objects and arrays may form reference cycles */
+static inline bool
+dyn_value_may_cycle(const DynValue *value)
+{
+    return value->type == DynObject && value->class_id != DynClassConstructor
+               ? true
+               : false;
+}
+
 /* string utilities */
+
+/* Allocate a zero filled flat string of length bytes */
+DyntypeString *
+dyn_string_new_flat(uint32_t length);
+
+/* Return the '\0' terminated bytes of the string, ropes are flattened in
+ * place. Return NULL if flattening runs out of memory. */
+uint8_t *
+dyn_string_data(DyntypeString *dyn_str);
+
+/* Size of the structure allocated for the string */
+uint32_t
+dyn_string_size(DyntypeString *dyn_str);
+
+/* Release the children or the flattened buffer of a rope node, and remove
+ * the string from the intern table */
+void
+dyn_string_destroy(DyntypeString *dyn_str);
+
+/* Return the hash of the string, computed on first use. Return 0 if a rope
+ * can't be flattened. */
+uint32_t
+dyn_string_hash(DyntypeString *dyn_str);
+
+/* Return the interned string with the given content, creating it if needed.
+ * Falls back to a new flat string if there is no intern table. */
+DynValue *
+dyn_string_new_interned(const void *buf, uint32_t length);
+
+DynStringTable *
+dyn_string_table_create(uint32_t init_capacity);
+
+/* Destroy the table, strings still alive are no longer interned */
+void
+dyn_string_table_destroy(DynStringTable *table);
+
 DyntypeString *
 dyn_string_concat(DyntypeString *dyn_str1, DyntypeString *dyn_str2);
 
@@ -124,3 +480,102 @@ dyn_string_eq(DyntypeString *dyn_str1, DyntypeString *dyn_str2);
 
 DyntypeString *
 dyn_string_slice(DyntypeString *dyn_str, uint32_t start, uint32_t end);
+
+/* atom utilities */
+uint32_t
+dyn_atom_hash(const char *str, uint32_t length);
+
+DynAtomTable *
+dyn_atom_table_create(uint32_t init_capacity);
+
+void
+dyn_atom_table_destroy(DynAtomTable *table);
+
+/* Return the atom of str, create it if not exist */
+DynAtom *
+dyn_atom_new(DynAtomTable *table, const char *str);
+
+/* Return the atom of str, or NULL if str has never been interned */
+DynAtom *
+dyn_atom_find(DynAtomTable *table, const char *str);
+
+/* Return the atom of the given id, or NULL if the id is invalid */
+DynAtom *
+dyn_atom_get(DynAtomTable *table, uint32_t id);
+
+/* allocator utilities */
+/* memory_limit is the max bytes reserved by the allocator, 0 for no limit */
+bool
+dyn_allocator_init(DynAllocator *allocator, uint64_t memory_limit);
+
+void
+dyn_allocator_destroy(DynAllocator *allocator);
+
+/* Allocate a value of class_id, a NULL allocator falls back to
+ * wasm_runtime_malloc */
+void *
+dyn_allocator_alloc(DynAllocator *allocator, uint8_t class_id, uint32_t size);
+
+/* Free a value, size and class_id must match the allocation */
+void
+dyn_allocator_free(DynAllocator *allocator, void *ptr, uint8_t class_id,
+                   uint32_t size);
+
+void
+dyn_allocator_get_usage(DynAllocator *allocator, DynAllocUsage *usage);
+
+/* Allocate and free value structures with the allocator of the current
+ * context. Allocation never collects, callers may hold uncounted references
+ * to other values. */
+void *
+dyn_value_alloc(uint8_t class_id, uint32_t size);
+
+/* Release a value into the allocator of its owning context */
+void
+dyn_value_free(void *ptr, uint8_t class_id, uint32_t size);
+
+/* Id to be recorded in new values, 0 if there is no current context */
+uint8_t
+dyn_value_current_ctx_id();
+
+/* Context owning the value, NULL if it was allocated without a context.
+ * Values are released into their owner whichever context is current. */
+struct DynTypeContext *
+dyn_value_owner(DynValue *value);
+
+/* cycle collector utilities */
+bool
+dyn_gc_init(DynGC *gc, uint32_t threshold);
+
+void
+dyn_gc_destroy(DynGC *gc);
+
+/* Record a value whose reference count dropped to a non-zero value */
+void
+dyn_gc_possible_root(DynValue *value);
+
+/* Collect if the possible roots of the current context reached the
+ * threshold, must only be called where no uncounted reference is held */
+void
+dyn_gc_maybe_collect();
+
+void
+dyn_gc_collect(DynGC *gc);
+
+/* shape utilities */
+DynShape *
+dyn_shape_new_root();
+
+void
+dyn_shape_destroy_tree(DynShape *shape);
+
+/* Return the shape reached by appending key, NULL if the transition limits
+ * are exceeded */
+DynShape *
+dyn_shape_add_key(DynShape *shape, DynAtom *key);
+
+/* Return the slot index of key, or -1 if not found */
+int32_t
+dyn_shape_find_key(DynShape *shape, DynAtom *key);
+
+#endif /* end of __DYN_VALUE_H_ */
@@ -5,7 +5,7 @@
 
 #include "libdyntype_export.h"
 #include "pure_dynamic.h"
-#include "dyn_value.h"
+#include "type.h"
 #include <assert.h>
 
 /******************* builtin type compare *******************/
@@ -169,9 +169,7 @@ dynamic_new_boolean(dyn_ctx_t ctx, bool value)
 dyn_value_t
 dynamic_new_string(dyn_ctx_t ctx, const void *stringref)
 {
-    DynValue *dyn_value = (DynValue *)stringref;
-    dyn_value->ref_count++;
-    return (dyn_value_t)stringref;
+    return dyn_value_hold((DynValue *)stringref);
 }
 
 dyn_value_t
@@ -222,23 +220,36 @@ dynamic_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem)
 {
     DyntypeArray *dyn_array = (DyntypeArray *)obj;
 
-    if (dyn_array->base.header.type != DynObject
-        || dyn_array->base.header.class_id != DynClassArray) {
+    if (dyn_value_type(obj) != DynObject
+        || dyn_value_class_id(obj) != DynClassArray) {
         return false;
     }
 
-    if (index < 0 || index >= dyn_array->length) {
+    if (index < 0) {
         return false;
     }
 
-    if (dyn_array->data[index]) {
-        dynamic_release(ctx, dyn_array->data[index]);
+    /* fast path for appending */
+    if ((uint32_t)index == dyn_array->length) {
+        return dyn_array_push(dyn_array, elem);
     }
 
-    dyn_array->data[index] = elem;
-    dynamic_hold(ctx, elem);
+    return dyn_array_set_elem(dyn_array, (uint32_t)index, elem);
+}
+
+int
+dynamic_add_elem(dyn_ctx_t ctx, dyn_value_t obj, dyn_value_t elem)
+{
+    if (dyn_value_type(obj) != DynObject
+        || dyn_value_class_id(obj) != DynClassArray) {
+        return -DYNTYPE_TYPEERR;
+    }
+
+    if (!dyn_array_push((DyntypeArray *)obj, elem)) {
+        return -DYNTYPE_EXCEPTION;
+    }
 
-    return true;
+    return DYNTYPE_SUCCESS;
 }
 
 dyn_value_t
@@ -246,67 +257,85 @@ dynamic_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index)
 {
     DyntypeArray *dyn_array = (DyntypeArray *)obj;
 
-    if (dyn_array->base.header.type != DynObject
-        || dyn_array->base.header.class_id != DynClassArray) {
+    if (dyn_value_type(obj) != DynObject
+        || dyn_value_class_id(obj) != DynClassArray) {
         return NULL;
     }
 
-    if (index < 0 || index >= dyn_array->length) {
-        return NULL;
+    /* out of range elements and holes are undefined */
+    if (index < 0 || (uint32_t)index >= dyn_array->length
+        || !dyn_array->data[index]) {
+        return dynamic_new_undefined(ctx);
     }
 
-    if (!dyn_array->data[index]) {
-        return dynamic_new_undefined(ctx);
+    return dyn_value_hold(dyn_array->data[index]);
+}
+
+static int
+object_set_property(dyn_ctx_t ctx, dyn_value_t obj, DynAtom *key,
+                    dyn_value_t value)
+{
+    if (!key) {
+        return false;
     }
 
-    ((DynValue *)dyn_array->data[index])->ref_count++;
-    return dyn_array->data[index];
+    return dyn_object_set_property((DyntypeObject *)obj, ctx->root_shape, key,
+                                   value);
 }
 
-int
-dynamic_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
-                     dyn_value_t value)
+static dyn_value_t
+object_get_property(dyn_ctx_t ctx, dyn_value_t obj, DynAtom *key)
 {
     DyntypeObject *dyn_obj = (DyntypeObject *)obj;
-    char *key = NULL;
+    DynValue *dyn_value = NULL;
 
-    if (dyn_obj->header.type != DynObject) {
-        return false;
+    if (dyn_obj->header.class_id == DynClassArray && key && key->length == 6
+        && memcmp(key->str, "length", 6) == 0) {
+        DyntypeArray *dyn_array = (DyntypeArray *)dyn_obj;
+        return dynamic_new_number(ctx, dyn_array->length);
     }
 
-    if (!dyn_obj->properties) {
-        if (!init_dyn_object_properties(dyn_obj)) {
-            return false;
-        }
+    if (key) {
+        dyn_value = dyn_object_get_property(dyn_obj, key);
     }
 
-    key = bh_strdup(prop);
+    if (!dyn_value) {
+        return dynamic_new_undefined(ctx);
+    }
 
-    if (!bh_hash_map_find(dyn_obj->properties, (void *)key)) {
-        if (!bh_hash_map_insert(dyn_obj->properties, (void *)key, value)) {
-            wasm_runtime_free(key);
-            return false;
-        }
-        dynamic_hold(ctx, value);
+    return dyn_value_hold(dyn_value);
+}
+
+static int
+object_has_property(dyn_ctx_t ctx, dyn_value_t obj, DynAtom *key)
+{
+    if (key && dyn_object_get_property((DyntypeObject *)obj, key)) {
+        return true;
     }
-    else {
-        void *old_key;
-        DynValue *old_value;
 
-        bh_hash_map_remove(dyn_obj->properties, (void *)key, &old_key,
-                           (void **)&old_value);
-        wasm_runtime_free(old_key);
+    return false;
+}
+
+static int
+object_delete_property(dyn_ctx_t ctx, dyn_value_t obj, DynAtom *key)
+{
+    if (!key) {
+        return false;
+    }
 
-        if (!bh_hash_map_insert(dyn_obj->properties, (void *)key, value)) {
-            wasm_runtime_free(key);
-            return false;
-        }
+    return dyn_object_delete_property((DyntypeObject *)obj, key);
+}
 
-        dynamic_hold(ctx, value);
-        dynamic_release(ctx, old_value);
+int
+dynamic_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
+                     dyn_value_t value)
+{
+    if (dyn_value_type(obj) != DynObject) {
+        return false;
     }
 
-    return true;
+    return object_set_property(ctx, obj, dyn_atom_new(ctx->atom_table, prop),
+                               value);
 }
 
 int
@@ -319,78 +348,104 @@ dynamic_define_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
 dyn_value_t
 dynamic_get_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
 {
-    DyntypeObject *dyn_obj = (DyntypeObject *)obj;
-    DynValue *dyn_value = NULL;
-
-    if (dyn_obj->header.type != DynObject) {
+    if (dyn_value_type(obj) != DynObject) {
         return NULL;
     }
 
-    if (!dyn_obj->properties) {
-        return NULL;
-    }
-
-    if (dyn_obj->header.class_id == DynClassArray
+    if (((DynValue *)obj)->class_id == DynClassArray
         && strcmp(prop, "length") == 0) {
-        DyntypeArray *dyn_array = (DyntypeArray *)dyn_obj;
-        return dynamic_new_number(ctx, dyn_array->length);
+        return dynamic_new_number(ctx, ((DyntypeArray *)obj)->length);
     }
 
-    dyn_value = bh_hash_map_find(dyn_obj->properties, (void *)prop);
-    if (dyn_value) {
-        dyn_value->ref_count++;
-    }
-    else {
-        return dynamic_new_undefined(ctx);
-    }
-
-    return dyn_value;
+    /* a key that has never been interned can't be a property of any
+     * object */
+    return object_get_property(ctx, obj, dyn_atom_find(ctx->atom_table, prop));
 }
 
 int
 dynamic_has_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
 {
-    DyntypeObject *dyn_obj = (DyntypeObject *)obj;
-
-    if (dyn_obj->header.type != DynObject) {
+    if (dyn_value_type(obj) != DynObject) {
         return false;
     }
 
-    if (!dyn_obj->properties) {
+    return object_has_property(ctx, obj, dyn_atom_find(ctx->atom_table, prop));
+}
+
+int
+dynamic_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+{
+    if (dyn_value_type(obj) != DynObject) {
         return false;
     }
 
-    if (bh_hash_map_find(dyn_obj->properties, (void *)prop)) {
-        return true;
-    }
+    return object_delete_property(ctx, obj,
+                                  dyn_atom_find(ctx->atom_table, prop));
+}
 
-    return false;
+dyn_atom_t
+dynamic_new_atom(dyn_ctx_t ctx, const char *prop)
+{
+    DynAtom *atom = dyn_atom_new(ctx->atom_table, prop);
+
+    return atom ? atom->id : DYNTYPE_ATOM_NULL;
 }
 
-int
-dynamic_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+const char *
+dynamic_atom_to_cstring(dyn_ctx_t ctx, dyn_atom_t atom)
 {
-    DyntypeObject *dyn_obj = (DyntypeObject *)obj;
-    void *orig_key;
-    DynValue *value = NULL;
+    DynAtom *key = dyn_atom_get(ctx->atom_table, atom);
+
+    return key ? key->str : NULL;
+}
+
+void
+dynamic_free_atom_cstring(dyn_ctx_t ctx, const char *str)
+{
+    /* the string is owned by the atom table */
+}
 
-    if (dyn_obj->header.type != DynObject) {
+int
+dynamic_set_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom,
+                          dyn_value_t value)
+{
+    if (dyn_value_type(obj) != DynObject) {
         return false;
     }
 
-    if (!dyn_obj->properties) {
-        return false;
+    return object_set_property(ctx, obj, dyn_atom_get(ctx->atom_table, atom),
+                               value);
+}
+
+dyn_value_t
+dynamic_get_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom)
+{
+    if (dyn_value_type(obj) != DynObject) {
+        return NULL;
     }
 
-    if (!bh_hash_map_remove(dyn_obj->properties, (void *)prop, &orig_key,
-                            (void **)&value)) {
+    return object_get_property(ctx, obj, dyn_atom_get(ctx->atom_table, atom));
+}
+
+int
+dynamic_has_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom)
+{
+    if (dyn_value_type(obj) != DynObject) {
         return false;
     }
 
-    dynamic_release(ctx, value);
-    wasm_runtime_free(orig_key);
+    return object_has_property(ctx, obj, dyn_atom_get(ctx->atom_table, atom));
+}
 
-    return true;
+int
+dynamic_delete_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom)
+{
+    if (dyn_value_type(obj) != DynObject) {
+        return false;
+    }
+
+    return object_delete_property(ctx, obj,
+                                  dyn_atom_get(ctx->atom_table, atom));
 }
 
 dyn_value_t
@@ -405,34 +460,33 @@ bool
 dynamic_is_undefined(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    return dyn_value->type == DynUndefined ? true : false;
+    return dyn_value_type(dyn_value) == DynUndefined ? true : false;
 }
 
 bool
 dynamic_is_null(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    return dyn_value->type == DynNull ? true : false;
+    return dyn_value_type(dyn_value) == DynNull ? true : false;
 }
 
 bool
 dynamic_is_bool(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    return dyn_value->type == DynBoolean ? true : false;
+    return dyn_value_type(dyn_value) == DynBoolean ? true : false;
 }
 
 int
 dynamic_to_bool(dyn_ctx_t ctx, dyn_value_t bool_obj, bool *pres)
 {
     DynValue *dyn_value = (DynValue *)bool_obj;
-    DyntypeBoolean *dyn_bool = (DyntypeBoolean *)dyn_value;
 
-    if (dyn_value->type != DynBoolean) {
+    if (dyn_value_type(dyn_value) != DynBoolean) {
         return -DYNTYPE_TYPEERR;
     }
 
-    *pres = dyn_bool->value;
+    *pres = dyn_value_get_boolean(dyn_value);
     return DYNTYPE_SUCCESS;
 }
 
@@ -440,20 +494,19 @@ bool
 dynamic_is_number(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    return dyn_value->type == DynNumber ? true : false;
+    return dyn_value_type(dyn_value) == DynNumber ? true : false;
 }
 
 int
 dynamic_to_number(dyn_ctx_t ctx, dyn_value_t obj, double *pres)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    DyntypeNumber *dyn_num = (DyntypeNumber *)dyn_value;
 
-    if (dyn_value->type != DynNumber) {
+    if (dyn_value_type(dyn_value) != DynNumber) {
         return -DYNTYPE_EXCEPTION;
     }
 
-    *pres = dyn_num->value;
+    *pres = dyn_value_get_number(dyn_value);
     return DYNTYPE_SUCCESS;
 }
 
@@ -461,15 +514,13 @@ bool
 dynamic_is_string(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    return dyn_value->type == DynString ? true : false;
+    return dyn_value_type(dyn_value) == DynString ? true : false;
 }
 
 void *
 dynamic_to_string(dyn_ctx_t ctx, dyn_value_t obj)
 {
-    DynValue *dyn_value = (DynValue *)obj;
-    dyn_value->ref_count++;
-    return obj;
+    return dyn_value_hold((DynValue *)obj);
 }
 
 int
@@ -477,24 +528,27 @@ dynamic_to_cstring(dyn_ctx_t ctx, dyn_value_t str_obj, char **pres)
 {
     DynValue *dyn_value = (DynValue *)str_obj;
 
-    switch (dyn_value->type) {
+    switch (dyn_value_type(dyn_value)) {
         case DynString:
         {
             DyntypeString *dyn_str = (DyntypeString *)dyn_value;
+            uint8_t *data = dyn_string_data(dyn_str);
+
+            if (!data) {
+                return -DYNTYPE_EXCEPTION;
+            }
 
             *pres = wasm_runtime_malloc(dyn_str->length + 1);
             if (!*pres) {
                 return -DYNTYPE_EXCEPTION;
             }
 
-            bh_memcpy_s(*pres, dyn_str->length + 1, dyn_str->data,
-                        dyn_str->length + 1);
+            bh_memcpy_s(*pres, dyn_str->length + 1, data, dyn_str->length + 1);
             break;
         }
         case DynNumber:
         {
-            DyntypeNumber *dyn_num = (DyntypeNumber *)dyn_value;
-            double value = dyn_num->value;
+            double value = dyn_value_get_number(dyn_value);
             char buf[128];
 
             if (value - (int64_t)value != 0) {
@@ -512,9 +566,8 @@ dynamic_to_cstring(dyn_ctx_t ctx, dyn_value_t str_obj, char **pres)
         }
         case DynBoolean:
         {
-            DyntypeBoolean *dyn_bool = (DyntypeBoolean *)dyn_value;
-
-            *pres = bh_strdup(dyn_bool->value ? "true" : "false");
+            *pres = bh_strdup(dyn_value_get_boolean(dyn_value) ? "true"
+                                                                : "false");
             if (!*pres) {
                 return -DYNTYPE_EXCEPTION;
             }
@@ -563,7 +616,7 @@ bool
 dynamic_is_object(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    return dyn_value->type == DynObject ? true : false;
+    return dyn_value_type(dyn_value) == DynObject ? true : false;
 }
 
 bool
@@ -576,8 +629,8 @@ bool
 dynamic_is_array(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    return ((dyn_value->type == DynObject)
-            && (dyn_value->class_id == DynClassArray))
+    return ((dyn_value_type(dyn_value) == DynObject)
+            && (dyn_value_class_id(dyn_value) == DynClassArray))
                ? true
                : false;
 }
@@ -586,8 +639,8 @@ bool
 dynamic_is_extref(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
-    return (dyn_value->type == DynObject)
-                   && (dyn_value->class_id == DynClassExtref)
+    return (dyn_value_type(dyn_value) == DynObject)
+                   && (dyn_value_class_id(dyn_value) == DynClassExtref)
                ? true
                : false;
 }
@@ -598,7 +651,8 @@ dynamic_to_extref(dyn_ctx_t ctx, dyn_value_t obj, void **pres)
     DynValue *dyn_value = (DynValue *)obj;
     DyntypeExtref *dyn_extref = (DyntypeExtref *)dyn_value;
 
-    if (dyn_value->type != DynObject || dyn_value->class_id != DynClassExtref) {
+    if (dyn_value_type(dyn_value) != DynObject
+        || dyn_value_class_id(dyn_value) != DynClassExtref) {
         return -DYNTYPE_TYPEERR;
     }
 
@@ -617,10 +671,12 @@ dynamic_is_falsy(dyn_ctx_t ctx, dyn_value_t value)
 {
     DynValue *obj = (DynValue *)value;
 
-    if (obj->type == DynUndefined || obj->type == DynNull
-        || (obj->type == DynBoolean && !((DyntypeBoolean *)obj)->value)
-        || (obj->type == DynNumber && !((DyntypeNumber *)obj)->value)
-        || (obj->type == DynString && !((DyntypeString *)obj)->length)) {
+    uint8_t type = dyn_value_type(obj);
+
+    if (type == DynUndefined || type == DynNull
+        || (type == DynBoolean && !dyn_value_get_boolean(obj))
+        || (type == DynNumber && !dyn_value_get_number(obj))
+        || (type == DynString && !((DyntypeString *)obj)->length)) {
         return true;
     }
 
@@ -634,7 +690,8 @@ dynamic_typeof(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
 
-    if (dyn_value->type == DynObject && dyn_value->class_id == DynClassExtref) {
+    if (dyn_value_type(dyn_value) == DynObject
+        && dyn_value_class_id(dyn_value) == DynClassExtref) {
         DyntypeExtref *extref_value = (DyntypeExtref *)dyn_value;
         if (extref_value->tag == ExtObj) {
             return DynExtRefObj;
@@ -646,13 +703,13 @@ dynamic_typeof(dyn_ctx_t ctx, dyn_value_t obj)
             return DynExtRefArray;
         }
     }
-    return ((DynValue *)obj)->type;
+    return dyn_value_type(dyn_value);
 }
 
 bool
 dynamic_type_eq(dyn_ctx_t ctx, dyn_value_t lhs, dyn_value_t rhs)
 {
-    return ((DynValue *)lhs)->type == ((DynValue *)rhs)->type ? true : false;
+    return dyn_value_type(lhs) == dyn_value_type(rhs) ? true : false;
 }
 
 bool
@@ -662,7 +719,10 @@ dynamic_cmp(dyn_ctx_t ctx, dyn_value_t lhs, dyn_value_t rhs,
     bool res;
     dyn_type_t type;
 
-    if (lhs == rhs) {
+    type = dynamic_typeof(ctx, lhs);
+
+    /* NaN is canonicalized, so identical numbers aren't necessarily equal */
+    if (lhs == rhs && type != DynNumber) {
         if (cmp_operator_has_equal_token(operator_kind)) {
             return true;
         }
@@ -671,8 +731,6 @@ dynamic_cmp(dyn_ctx_t ctx, dyn_value_t lhs, dyn_value_t rhs,
         }
     }
 
-    type = dynamic_typeof(ctx, lhs);
-
     switch (type) {
         case DynBoolean:
         {
@@ -716,6 +774,22 @@ dynamic_cmp(dyn_ctx_t ctx, dyn_value_t lhs, dyn_value_t rhs,
         case DynString:
         {
             char *lhs_s, *rhs_s;
+
+            /* equality doesn't need a copy, and is decided by the cached
+             * hashes or by identity for interned strings */
+            if (dyn_value_type(rhs) == DynString) {
+                if (operator_kind == EqualsEqualsToken
+                    || operator_kind == EqualsEqualsEqualsToken) {
+                    res = dyn_string_eq(lhs, rhs);
+                    break;
+                }
+                else if (operator_kind == ExclamationEqualsToken
+                         || operator_kind == ExclamationEqualsEqualsToken) {
+                    res = !dyn_string_eq(lhs, rhs);
+                    break;
+                }
+            }
+
             dynamic_to_cstring(ctx, lhs, &lhs_s);
             dynamic_to_cstring(ctx, rhs, &rhs_s);
             res = string_cmp(lhs_s, rhs_s, operator_kind);
@@ -787,7 +861,7 @@ dynamic_dump_value(dyn_ctx_t ctx, dyn_value_t obj)
 {
     DynValue *dyn_value = (DynValue *)obj;
 
-    switch (dyn_value->type) {
+    switch (dyn_value_type(dyn_value)) {
         case DynUndefined:
         {
             printf("undefined");
@@ -800,13 +874,12 @@ dynamic_dump_value(dyn_ctx_t ctx, dyn_value_t obj)
         }
         case DynBoolean:
         {
-            printf("%s",
-                   ((DyntypeBoolean *)dyn_value)->value ? "true" : "false");
+            printf("%s", dyn_value_get_boolean(dyn_value) ? "true" : "false");
             break;
         }
         case DynNumber:
         {
-            double value = ((DyntypeNumber *)dyn_value)->value;
+            double value = dyn_value_get_number(dyn_value);
             if (value - (int64_t)value != 0) {
                 printf("%.14g", value);
             }
@@ -818,7 +891,11 @@ dynamic_dump_value(dyn_ctx_t ctx, dyn_value_t obj)
         }
         case DynString:
         {
-            printf("%s", ((DyntypeString *)dyn_value)->data);
+            uint8_t *data = dyn_string_data((DyntypeString *)dyn_value);
+
+            if (data) {
+                printf("%s", (char *)data);
+            }
             break;
         }
         case DynObject:
@@ -875,6 +952,35 @@ void
 dynamic_dump_error(dyn_ctx_t ctx)
 {}
 
+void
+dynamic_dump_memory_usage(dyn_ctx_t ctx)
+{
+    static const char *class_names[DynClassEnd] = {
+        [DynClassNumber] = "Number", [DynClassString] = "String",
+        [DynClassObject] = "Object", [DynClassArray] = "Array",
+        [DynClassExtref] = "Extref", [DynClassDate] = "Date",
+    };
+    DynAllocUsage usage;
+    uint32 i;
+
+    dyn_allocator_get_usage(&ctx->allocator, &usage);
+
+    printf("libdyntype memory usage:\n");
+    printf("  %-10s %12s %14s\n", "class", "live count", "live bytes");
+    for (i = 0; i < DynClassEnd; i++) {
+        if (!class_names[i]) {
+            continue;
+        }
+        printf("  %-10s %12" PRId64 " %14" PRId64 "\n", class_names[i],
+               usage.live_count[i], usage.live_bytes[i]);
+    }
+    printf("  live bytes:       %" PRIu64 "\n", usage.total_live_bytes);
+    printf("  slab chunk bytes: %" PRIu64 "\n", usage.slab_chunk_bytes);
+    printf("  large bytes:      %" PRIu64 "\n", usage.large_bytes);
+    printf("  reserved bytes:   %" PRIu64 "\n", usage.reserved_bytes);
+    printf("  fragmentation:    %.2f%%\n", usage.fragmentation * 100);
+}
+
 /******************* Garbage collection *******************/
 
 dyn_value_t
@@ -889,10 +995,28 @@ dynamic_release(dyn_ctx_t ctx, dyn_value_t obj)
     dyn_value_release(obj);
 }
 
+dyn_value_t
+dynamic_new_weak_ref(dyn_ctx_t ctx, dyn_value_t obj)
+{
+    return obj;
+}
+
+void
+dynamic_free_weak_ref(dyn_ctx_t ctx, dyn_value_t ref)
+{
+    /* the value itself is the reference */
+}
+
 void
 dynamic_collect(dyn_ctx_t ctx)
 {
-    // TODO
+    dyn_gc_collect(&ctx->gc);
+}
+
+bool
+dynamic_is_immediate(dyn_ctx_t ctx, dyn_value_t obj)
+{
+    return dyn_value_is_immediate((DynValue *)obj);
 }
 
 /******************* Exception *******************/
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef __DYN_TYPE_H_
+#define __DYN_TYPE_H_
+
+#include "libdyntype.h"
+#include "dyn_value.h"
+
+typedef struct DynTypeContext {
+    DynAtomTable *atom_table;
+    DynStringTable *string_table;
+    DynShape *root_shape;
+    DynAllocator allocator;
+    DynGC gc;
+    DynHostData host;
+    /* index in the registry of live contexts, see dynamic_context_from_id */
+    uint8_t id;
+} DynTypeContext;
+
+/* Values record the id of their context in one byte, id 0 is used for
+ * values allocated without a context */
+#define DYN_CONTEXT_MAX_NUM 255
+
+DynTypeContext *
+dynamic_context_from_id(uint8_t id);
+
+#endif /* end of __DYN_TYPE_H_ */
@@ -15,15 +15,98 @@
 
 #define EXTREF_PROLOGUE()                                                    \
     int ext_tag;                                                             \
-    void *p_table_index;                                                     \
-    uint32_t table_index;                                                    \
-    wasm_exec_env_t exec_env = dyntype_context_get_exec_env();               \
+    void *p_handle;                                                          \
+    uint32_t handle;                                                         \
+    wasm_exec_env_t exec_env = dyntype_context_get_exec_env(ctx);            \
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env); \
                                                                              \
     bh_assert(exec_env);                                                     \
                                                                              \
-    ext_tag = dynamic_to_extref(ctx, obj, &p_table_index);                   \
-    table_index = (uint32_t)(uintptr_t)p_table_index;
+    ext_tag = dynamic_to_extref(ctx, obj, &p_handle);                        \
+    handle = (uint32_t)(uintptr_t)p_handle;
+
+/******************* Static field lookup cache *******************/
+
+/*
+ * Direct mapped cache of the static field lookups, keyed by the meta of the
+ * object and the property name. A hit saves the meta search done by
+ * get_prop_index_of_struct, misses overwrite the entry. The meta is keyed by
+ * its offset in the linear memory, which stays valid if the memory grows.
+ */
+
+#define PROP_CACHE_SIZE 512
+/* longer names are not cached */
+#define PROP_CACHE_NAME_MAX 32
+
+typedef struct ExtPropCacheEntry {
+    /* 0 for an empty entry */
+    uint32_t meta;
+    /* -1 if the name is not a static property */
+    int32_t index;
+    wasm_ref_type_t field_type;
+    char name[PROP_CACHE_NAME_MAX];
+} ExtPropCacheEntry;
+
+static uint32_t
+prop_cache_hash(uint32_t meta, const char *prop, uint32_t *plength)
+{
+    uint32_t hash = 2166136261u ^ meta;
+    uint32_t length = 0;
+
+    for (; prop[length]; length++) {
+        hash ^= (uint8_t)prop[length];
+        hash *= 16777619u;
+    }
+
+    *plength = length;
+    return hash;
+}
+
+/* Same as get_prop_index_of_struct, through the cache of ctx */
+static int
+lookup_prop_index_of_struct(dyn_ctx_t ctx, wasm_exec_env_t exec_env,
+                            const char *prop, wasm_obj_t *wasm_obj,
+                            wasm_ref_type_t *field_type)
+{
+    DynHostData *host = dynamic_get_host_data(ctx);
+    ExtPropCacheEntry *entry;
+    uint32_t meta, length = 0;
+    int index;
+
+    meta = get_meta_offset_of_object(*wasm_obj);
+    entry = (ExtPropCacheEntry *)host->prop_cache;
+
+    if (!entry) {
+        uint32_t size = sizeof(ExtPropCacheEntry) * PROP_CACHE_SIZE;
+
+        if ((entry = (ExtPropCacheEntry *)wasm_runtime_malloc(size))) {
+            memset(entry, 0, size);
+            host->prop_cache = entry;
+        }
+    }
+
+    if (entry && meta) {
+        entry += prop_cache_hash(meta, prop, &length) & (PROP_CACHE_SIZE - 1);
+        if (entry->meta == meta && strcmp(entry->name, prop) == 0) {
+            *field_type = entry->field_type;
+            return entry->index;
+        }
+    }
+
+    index = get_prop_index_of_struct(exec_env, prop, wasm_obj, field_type);
+
+    /* errors are not cached */
+    if (entry && meta && index >= -1 && length < PROP_CACHE_NAME_MAX) {
+        entry->meta = meta;
+        entry->index = index;
+        if (index >= 0) {
+            entry->field_type = *field_type;
+        }
+        bh_memcpy_s(entry->name, PROP_CACHE_NAME_MAX, prop, length + 1);
+    }
+
+    return index;
+}
 
 int
 extref_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem)
@@ -35,7 +118,7 @@ extref_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem)
         WasmArrayInfo arr_info;
         wasm_value_t unboxed_elem_value = { 0 };
 
-        get_static_array_info(exec_env, table_index, &arr_info);
+        get_static_array_info(ctx, handle, &arr_info);
 
         /* unbox value from any */
         unbox_value_from_any(exec_env, ctx, elem, arr_info.element_type,
@@ -63,7 +146,7 @@ extref_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index)
         wasm_value_t elem_value = { 0 };
         dyn_value_t elem_res_any = NULL;
 
-        get_static_array_info(exec_env, table_index, &arr_info);
+        get_static_array_info(ctx, handle, &arr_info);
 
         /* get value from array */
         wasm_array_obj_get_elem(arr_info.ref, index, false, &elem_value);
@@ -80,73 +163,344 @@ extref_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index)
     }
 }
 
+/******************* Bulk element access *******************/
+
+/* Clamp [start, start + count) to the static array, return the number of
+ * elements in range */
+static uint32_t
+clamp_elem_range(WasmArrayInfo *arr_info, int start, int count)
+{
+    if (start < 0 || count <= 0 || (uint32_t)start >= arr_info->lengh) {
+        return 0;
+    }
+
+    if ((uint32_t)count > arr_info->lengh - (uint32_t)start) {
+        return arr_info->lengh - (uint32_t)start;
+    }
+
+    return (uint32_t)count;
+}
+
+/* i32 elements are either booleans or ints, which the array type doesn't
+ * tell apart, so they are only accessed one by one */
+static inline bool
+is_bulk_elem_type(wasm_ref_type_t type)
+{
+    return type.value_type != VALUE_TYPE_I32;
+}
+
 int
-extref_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
-                    dyn_value_t value)
+extref_foreach_elem(dyn_ctx_t ctx, dyn_value_t obj, int start, int count,
+                    extref_elem_visitor_t visitor, void *user_data)
+{
+    WasmArrayInfo arr_info;
+    ts_value_t elem = { 0 };
+    wasm_value_t elem_value = { 0 };
+    uint32_t i, n;
+    int ret;
+    EXTREF_PROLOGUE()
+
+    if (ext_tag != ExtArray) {
+        wasm_runtime_set_exception(
+            module_inst, "libdyntype: iterate elements on non-array object");
+        return -DYNTYPE_TYPEERR;
+    }
+
+    get_static_array_info(ctx, handle, &arr_info);
+    if (!is_bulk_elem_type(arr_info.element_type)) {
+        return -DYNTYPE_TYPEERR;
+    }
+    n = clamp_elem_range(&arr_info, start, count);
+
+    /* primitive elements are read in place, without boxing */
+    if (arr_info.element_type.value_type == VALUE_TYPE_F64) {
+        double *data;
+
+        elem.type = TS_NUMBER;
+        for (i = 0; i < n; i++) {
+            /* the visitor may allocate wasm objects, reload the address */
+            data = (double *)wasm_array_obj_elem_addr(arr_info.ref, start + i);
+            elem.of.f64 = *data;
+            if ((ret = visitor(ctx, start + i, &elem, user_data)) != 0) {
+                return ret;
+            }
+        }
+    }
+    else {
+        elem.type = arr_info.element_type.value_type == REF_TYPE_ANYREF
+                        ? TS_ANY
+                        : TS_OBJECT;
+        for (i = 0; i < n; i++) {
+            wasm_array_obj_get_elem(arr_info.ref, start + i, false,
+                                    &elem_value);
+            /* any elements are passed as the dynamic value they hold */
+            elem.of.ref = elem.type == TS_ANY
+                              ? wasm_anyref_obj_get_value(
+                                  (wasm_anyref_obj_t)elem_value.gc_obj)
+                              : (void *)elem_value.gc_obj;
+            if ((ret = visitor(ctx, start + i, &elem, user_data)) != 0) {
+                return ret;
+            }
+        }
+    }
+
+    return DYNTYPE_SUCCESS;
+}
+
+typedef struct ExtElemsCopy {
+    wasm_exec_env_t exec_env;
+    wasm_ref_type_t element_type;
+    dyn_value_t arr;
+    int start;
+} ExtElemsCopy;
+
+static int
+copy_elem_to_dynamic(dyn_ctx_t ctx, uint32_t index, struct ts_value_t *elem,
+                     void *user_data)
+{
+    ExtElemsCopy *copy = (ExtElemsCopy *)user_data;
+    dyn_value_t value;
+    wasm_value_t wasm_value = { 0 };
+
+    switch (elem->type) {
+        case TS_NUMBER:
+            value = dynamic_new_number(ctx, elem->of.f64);
+            break;
+        case TS_ANY:
+            value = dynamic_hold(ctx, (dyn_value_t)elem->of.ref);
+            break;
+        default:
+            /* strings, closures and objects need the wasm type to convert */
+            wasm_value.gc_obj = (wasm_obj_t)elem->of.ref;
+            value = box_value_to_any(copy->exec_env, ctx, &wasm_value,
+                                     copy->element_type, false, -1);
+            break;
+    }
+
+    if (!value) {
+        return -DYNTYPE_EXCEPTION;
+    }
+
+    dynamic_set_elem(ctx, copy->arr, index - copy->start, value);
+    dynamic_release(ctx, value);
+    return 0;
+}
+
+dyn_value_t
+extref_get_elems(dyn_ctx_t ctx, dyn_value_t obj, int start, int count)
+{
+    WasmArrayInfo arr_info;
+    ExtElemsCopy copy;
+    EXTREF_PROLOGUE()
+
+    if (ext_tag != ExtArray) {
+        wasm_runtime_set_exception(
+            module_inst, "libdyntype: get elements on non-array object");
+        return NULL;
+    }
+
+    get_static_array_info(ctx, handle, &arr_info);
+    if (!is_bulk_elem_type(arr_info.element_type)) {
+        return NULL;
+    }
+
+    copy.exec_env = exec_env;
+    copy.element_type = arr_info.element_type;
+    copy.start = start;
+    copy.arr =
+        dynamic_new_array(ctx, (int)clamp_elem_range(&arr_info, start, count));
+    if (!copy.arr) {
+        return NULL;
+    }
+
+    if (extref_foreach_elem(ctx, obj, start, count, copy_elem_to_dynamic,
+                            &copy)
+        != DYNTYPE_SUCCESS) {
+        dynamic_release(ctx, copy.arr);
+        return NULL;
+    }
+
+    return copy.arr;
+}
+
+int
+extref_set_elems(dyn_ctx_t ctx, dyn_value_t obj, int start, dyn_value_t src,
+                 int count)
 {
+    WasmArrayInfo arr_info;
+    wasm_value_t unboxed_elem_value = { 0 };
+    dyn_value_t elem;
+    uint32_t i, n;
+    int ret = DYNTYPE_SUCCESS;
     EXTREF_PROLOGUE()
 
+    if (ext_tag != ExtArray) {
+        wasm_runtime_set_exception(
+            module_inst, "libdyntype: set elements on non-array object");
+        return -DYNTYPE_TYPEERR;
+    }
+
+    get_static_array_info(ctx, handle, &arr_info);
+    if (!is_bulk_elem_type(arr_info.element_type)) {
+        return -DYNTYPE_TYPEERR;
+    }
+    n = clamp_elem_range(&arr_info, start, count);
+
+    for (i = 0; i < n && ret == DYNTYPE_SUCCESS; i++) {
+        elem = dynamic_get_elem(ctx, src, i);
+        if (!elem) {
+            return -DYNTYPE_TYPEERR;
+        }
+
+        /* primitive elements are written in place, without boxing */
+        if (arr_info.element_type.value_type == VALUE_TYPE_F64) {
+            ret = dynamic_to_number(
+                ctx, elem,
+                (double *)wasm_array_obj_elem_addr(arr_info.ref, start + i));
+        }
+        else {
+            unbox_value_from_any(exec_env, ctx, elem, arr_info.element_type,
+                                 &unboxed_elem_value, false, -1);
+            wasm_array_obj_set_elem(arr_info.ref, start + i,
+                                    &unboxed_elem_value);
+        }
+
+        dynamic_release(ctx, elem);
+    }
+
+    return ret;
+}
+
+int
+extref_get_field(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
+                 dyn_value_t *pres)
+{
+    EXTREF_PROLOGUE()
+
+    (void)module_inst;
+
     if (ext_tag == ExtObj) {
         int index;
         wasm_ref_type_t field_type;
         wasm_obj_t wasm_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
-        wasm_value_t wasm_value = { .gc_obj = wasm_obj };
+            (wasm_obj_t)wamr_utils_get_extref_obj(ctx, handle);
+        wasm_value_t field_wasm_value = { 0 };
 
         bh_assert(wasm_obj_is_struct_obj(wasm_obj));
-        index =
-            get_prop_index_of_struct(exec_env, prop, &wasm_obj, &field_type);
-
+        index = lookup_prop_index_of_struct(ctx, exec_env, prop, &wasm_obj,
+                                            &field_type);
         if (index < 0) {
-            return dynamic_set_property(ctx, obj, prop, value);
+            return DYNTYPE_FALSE;
         }
-        else {
-            unbox_value_from_any(exec_env, ctx, value, field_type, &wasm_value,
+
+        field_wasm_value.gc_obj = wasm_obj;
+        *pres = box_value_to_any(exec_env, ctx, &field_wasm_value, field_type,
                                  true, index);
-            return DYNTYPE_SUCCESS;
-        }
+        return DYNTYPE_TRUE;
     }
-    else if (ext_tag == ExtArray) {
-        wasm_runtime_set_exception(module_inst,
-                                   "libdyntype: set property on non-object");
+    else if (ext_tag == ExtArray && strcmp(prop, "length") == 0) {
+        WasmArrayInfo arr_info;
+
+        get_static_array_info(ctx, handle, &arr_info);
+        *pres = dynamic_new_number(ctx, (double)arr_info.lengh);
+        return DYNTYPE_TRUE;
     }
 
-    return -DYNTYPE_TYPEERR;
+    return DYNTYPE_FALSE;
 }
 
-dyn_value_t
-extref_get_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+int
+extref_set_field(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
+                 dyn_value_t value)
 {
     EXTREF_PROLOGUE()
 
+    (void)module_inst;
+
     if (ext_tag == ExtObj) {
         int index;
         wasm_ref_type_t field_type;
         wasm_obj_t wasm_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+            (wasm_obj_t)wamr_utils_get_extref_obj(ctx, handle);
+        wasm_value_t wasm_value = { .gc_obj = wasm_obj };
 
         bh_assert(wasm_obj_is_struct_obj(wasm_obj));
-        index =
-            get_prop_index_of_struct(exec_env, prop, &wasm_obj, &field_type);
+        index = lookup_prop_index_of_struct(ctx, exec_env, prop, &wasm_obj,
+                                            &field_type);
         if (index < 0) {
-            return dynamic_get_property(ctx, obj, prop);
-        }
-        else {
-            wasm_value_t field_wasm_value = { .gc_obj = wasm_obj };
-            return box_value_to_any(exec_env, ctx, &field_wasm_value,
-                                    field_type, true, index);
+            return DYNTYPE_FALSE;
         }
+
+        unbox_value_from_any(exec_env, ctx, value, field_type, &wasm_value,
+                             true, index);
+        return DYNTYPE_TRUE;
+    }
+
+    return DYNTYPE_FALSE;
+}
+
+int
+extref_has_field(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+{
+    EXTREF_PROLOGUE()
+
+    (void)module_inst;
+
+    if (ext_tag == ExtObj) {
+        wasm_ref_type_t field_type;
+        wasm_obj_t wasm_obj =
+            (wasm_obj_t)wamr_utils_get_extref_obj(ctx, handle);
+
+        bh_assert(wasm_obj_is_struct_obj(wasm_obj));
+        return lookup_prop_index_of_struct(ctx, exec_env, prop, &wasm_obj,
+                                           &field_type)
+                       < 0
+                   ? DYNTYPE_FALSE
+                   : DYNTYPE_TRUE;
     }
     else if (ext_tag == ExtArray) {
-        WasmArrayInfo arr_info;
-        if (strcmp(prop, "length") != 0) {
-            wasm_runtime_set_exception(
-                module_inst, "libdyntype: get property on non-object");
-            return NULL;
+        return strcmp(prop, "length") == 0 ? DYNTYPE_TRUE : DYNTYPE_FALSE;
+    }
+
+    return DYNTYPE_FALSE;
+}
+
+int
+extref_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
+                    dyn_value_t value)
+{
+    EXTREF_PROLOGUE()
+
+    if (ext_tag == ExtObj) {
+        if (extref_set_field(ctx, obj, prop, value) == DYNTYPE_TRUE) {
+            return DYNTYPE_SUCCESS;
         }
+        return dynamic_set_property(ctx, obj, prop, value);
+    }
+    else if (ext_tag == ExtArray) {
+        wasm_runtime_set_exception(module_inst,
+                                   "libdyntype: set property on non-object");
+    }
 
-        get_static_array_info(exec_env, table_index, &arr_info);
-        return dynamic_new_number(ctx, (double)arr_info.lengh);
+    return -DYNTYPE_TYPEERR;
+}
+
+dyn_value_t
+extref_get_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
+{
+    dyn_value_t field_value = NULL;
+    EXTREF_PROLOGUE()
+
+    if (extref_get_field(ctx, obj, prop, &field_value) == DYNTYPE_TRUE) {
+        return field_value;
+    }
+
+    if (ext_tag == ExtObj) {
+        return dynamic_get_property(ctx, obj, prop);
+    }
+    else if (ext_tag == ExtArray) {
+        wasm_runtime_set_exception(module_inst,
+                                   "libdyntype: get property on non-object");
     }
 
     return NULL;
@@ -164,21 +518,10 @@ extref_has_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
     EXTREF_PROLOGUE()
 
     if (ext_tag == ExtObj) {
-        int index;
-        wasm_ref_type_t field_type;
-        wasm_obj_t wasm_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
-
-        bh_assert(wasm_obj_is_struct_obj(wasm_obj));
-        index =
-            get_prop_index_of_struct(exec_env, prop, &wasm_obj, &field_type);
-
-        if (index < 0) {
-            return dynamic_has_property(ctx, obj, prop);
-        }
-        else {
+        if (extref_has_field(ctx, obj, prop) == DYNTYPE_TRUE) {
             return DYNTYPE_TRUE;
         }
+        return dynamic_has_property(ctx, obj, prop);
     }
     else {
         wasm_runtime_set_exception(module_inst,
@@ -197,11 +540,11 @@ extref_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
         int index;
         wasm_ref_type_t field_type;
         wasm_obj_t wasm_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+            (wasm_obj_t)wamr_utils_get_extref_obj(ctx, handle);
 
         bh_assert(wasm_obj_is_struct_obj(wasm_obj));
-        index =
-            get_prop_index_of_struct(exec_env, prop, &wasm_obj, &field_type);
+        index = lookup_prop_index_of_struct(ctx, exec_env, prop, &wasm_obj,
+                                            &field_type);
 
         if (index < 0) {
             return dynamic_delete_property(ctx, obj, prop);
@@ -235,14 +578,14 @@ extref_invoke(dyn_ctx_t ctx, const char *name, dyn_value_t obj, int argc,
          * get the real ptr */
         bh_assert(dyntype_is_extref(ctx, field_any_obj));
         ext_tag =
-            dynamic_to_extref(ctx, field_any_obj, (void **)&p_table_index);
-        table_index = (uint32_t)(uintptr_t)p_table_index;
+            dynamic_to_extref(ctx, field_any_obj, (void **)&p_handle);
+        handle = (uint32_t)(uintptr_t)p_handle;
     }
 
     if (ext_tag == ExtFunc) {
         /* invoke static closure */
         wasm_obj_t func_obj =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+            (wasm_obj_t)wamr_utils_get_extref_obj(ctx, handle);
         bh_assert(wasm_obj_is_struct_obj(func_obj));
         res = call_wasm_func_with_boxing(
             exec_env, ctx, (wasm_anyref_obj_t)func_obj, argc, args);
@@ -273,7 +616,7 @@ extref_get_keys(dyn_ctx_t ctx, dyn_value_t obj)
 
     if (ext_tag == ExtObj) {
         wasm_obj_t obj_struct =
-            (wasm_obj_t)wamr_utils_get_table_element(exec_env, table_index);
+            (wasm_obj_t)wamr_utils_get_extref_obj(ctx, handle);
         /* get meta, get prop names */
         meta_addr = get_meta_of_object(exec_env, obj_struct);
         prop_count = get_meta_fields_count(meta_addr);
@@ -318,6 +661,26 @@ extref_get_keys(dyn_ctx_t ctx, dyn_value_t obj)
             wasm_runtime_free(prop_name_list);
         }
     }
+    else if (ext_tag == ExtArray) {
+        WasmArrayInfo arr_info;
+        char index_str[16];
+
+        /* keys of an array are its indices, the length is read once */
+        get_static_array_info(ctx, handle, &arr_info);
+        arr = dynamic_new_array(ctx, (int)arr_info.lengh);
+        for (i = 0; arr && i < arr_info.lengh; i++) {
+            snprintf(index_str, sizeof(index_str), "%u", (unsigned)i);
+#if WASM_ENABLE_STRINGREF != 0
+            str = dynamic_new_string(
+                ctx, wasm_stringref_obj_get_value(
+                         create_wasm_string(exec_env, index_str)));
+#else
+            str = dynamic_new_string(ctx, index_str, strlen(index_str));
+#endif
+            dynamic_set_elem(ctx, arr, i, str);
+            dyntype_release(ctx, str);
+        }
+    }
     else {
         wasm_runtime_set_exception(module_inst,
                                    "libdyntype: get_keys on non-object");
@@ -327,9 +690,262 @@ extref_get_keys(dyn_ctx_t ctx, dyn_value_t obj)
 }
 
 void
-extref_unsupported(const char *reason)
+extref_unsupported(dyn_ctx_t ctx, const char *reason)
 {
-    wasm_exec_env_t exec_env = dyntype_context_get_exec_env();
+    wasm_exec_env_t exec_env = dyntype_context_get_exec_env(ctx);
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     wasm_runtime_set_exception(module_inst, reason);
-}
\ No newline at end of file
+}
+
+/******************* ExtFunc wrapper cache *******************/
+
+/*
+ * Converting the same closure to any again returns the wrapper created the
+ * first time. Each context keeps its own cache, keyed by the closure. An
+ * entry holds neither the closure nor the wrapper: the wrapper roots the
+ * closure through its extref slot, and extref_release drops the entry when
+ * the wrapper is freed, so both can be collected once the wrapper is no
+ * longer used.
+ */
+
+#define FUNC_WRAPPER_MIN_BUCKETS 64
+
+typedef struct ExtFuncWrapper {
+    void *closure;
+    /* weak, the entry is dropped when the wrapper is freed */
+    dyn_value_t wrapper;
+    /* extref handle of the wrapper */
+    uint32_t ref;
+    struct ExtFuncWrapper *next;
+} ExtFuncWrapper;
+
+typedef struct ExtFuncWrapperCache {
+    ExtFuncWrapper **buckets;
+    uint32_t bucket_count;
+    uint32_t count;
+} ExtFuncWrapperCache;
+
+static inline uint32_t
+func_wrapper_hash(void *closure)
+{
+    uintptr_t key = (uintptr_t)closure >> 3;
+
+    return (uint32_t)(key ^ (key >> 16)) * 2654435761u;
+}
+
+static inline ExtFuncWrapperCache *
+func_wrapper_cache(dyn_ctx_t ctx)
+{
+    return (ExtFuncWrapperCache *)dynamic_get_host_data(ctx)->func_wrappers;
+}
+
+static ExtFuncWrapper **
+func_wrapper_lookup(ExtFuncWrapperCache *cache, void *closure)
+{
+    ExtFuncWrapper **p = &cache->buckets[func_wrapper_hash(closure)
+                                         & (cache->bucket_count - 1)];
+
+    while (*p && (*p)->closure != closure) {
+        p = &(*p)->next;
+    }
+
+    return p;
+}
+
+static bool
+func_wrapper_cache_grow(ExtFuncWrapperCache *cache)
+{
+    uint32_t bucket_count = cache->bucket_count ? cache->bucket_count * 2
+                                                : FUNC_WRAPPER_MIN_BUCKETS;
+    uint64_t size = (uint64_t)sizeof(ExtFuncWrapper *) * bucket_count;
+    ExtFuncWrapper **buckets;
+    uint32_t i;
+
+    if (size > UINT32_MAX) {
+        return false;
+    }
+
+    buckets = (ExtFuncWrapper **)wasm_runtime_malloc((uint32_t)size);
+    if (!buckets) {
+        return false;
+    }
+    memset(buckets, 0, (uint32_t)size);
+
+    for (i = 0; i < cache->bucket_count; i++) {
+        ExtFuncWrapper *entry = cache->buckets[i], *next;
+
+        for (; entry; entry = next) {
+            uint32_t j = func_wrapper_hash(entry->closure) & (bucket_count - 1);
+
+            next = entry->next;
+            entry->next = buckets[j];
+            buckets[j] = entry;
+        }
+    }
+
+    if (cache->buckets) {
+        wasm_runtime_free(cache->buckets);
+    }
+    cache->buckets = buckets;
+    cache->bucket_count = bucket_count;
+
+    return true;
+}
+
+dyn_value_t
+extref_get_func_wrapper(dyn_ctx_t ctx, void *closure)
+{
+    ExtFuncWrapperCache *cache = func_wrapper_cache(ctx);
+    ExtFuncWrapper *entry;
+
+    if (!cache) {
+        return NULL;
+    }
+
+    entry = *func_wrapper_lookup(cache, closure);
+    return entry ? dyntype_hold(ctx, entry->wrapper) : NULL;
+}
+
+void
+extref_set_func_wrapper(dyn_ctx_t ctx, void *closure, dyn_value_t wrapper)
+{
+    ExtFuncWrapperCache *cache = func_wrapper_cache(ctx);
+    ExtFuncWrapper **p, *entry;
+    void *ref = NULL;
+
+    if (!closure || dyntype_to_extref(ctx, wrapper, &ref) != ExtFunc) {
+        return;
+    }
+
+    if (!cache) {
+        cache = (ExtFuncWrapperCache *)wasm_runtime_malloc(
+            sizeof(ExtFuncWrapperCache));
+        if (!cache) {
+            return;
+        }
+        memset(cache, 0, sizeof(ExtFuncWrapperCache));
+        if (!func_wrapper_cache_grow(cache)) {
+            wasm_runtime_free(cache);
+            return;
+        }
+        dynamic_get_host_data(ctx)->func_wrappers = cache;
+    }
+
+    p = func_wrapper_lookup(cache, closure);
+    if (*p) {
+        return;
+    }
+
+    if (cache->count + 1 > cache->bucket_count * 2) {
+        if (!func_wrapper_cache_grow(cache)) {
+            return;
+        }
+        p = func_wrapper_lookup(cache, closure);
+    }
+
+    entry = (ExtFuncWrapper *)wasm_runtime_malloc(sizeof(ExtFuncWrapper));
+    if (!entry) {
+        return;
+    }
+
+    if (!(entry->wrapper = dynamic_new_weak_ref(ctx, wrapper))) {
+        wasm_runtime_free(entry);
+        return;
+    }
+
+    entry->closure = closure;
+    entry->ref = (uint32_t)(uintptr_t)ref;
+    entry->next = NULL;
+    *p = entry;
+    cache->count++;
+}
+
+static void
+drop_func_wrapper(dyn_ctx_t ctx, uint32_t handle)
+{
+    ExtFuncWrapperCache *cache = func_wrapper_cache(ctx);
+    ExtFuncWrapper **p = NULL, *entry;
+    void *closure;
+    uint32_t i;
+
+    if (!cache) {
+        return;
+    }
+
+    if ((closure = wamr_utils_get_extref_obj(ctx, handle))) {
+        p = func_wrapper_lookup(cache, closure);
+    }
+    else {
+        /* the slots were destroyed with the instance, look for the handle */
+        for (i = 0; i < cache->bucket_count && !p; i++) {
+            for (p = &cache->buckets[i]; *p && (*p)->ref != handle;
+                 p = &(*p)->next)
+                ;
+            if (!*p) {
+                p = NULL;
+            }
+        }
+    }
+
+    /* another wrapper of the closure may be the cached one */
+    if (!p || !(entry = *p) || entry->ref != handle) {
+        return;
+    }
+
+    *p = entry->next;
+    cache->count--;
+    dynamic_free_weak_ref(ctx, entry->wrapper);
+    wasm_runtime_free(entry);
+}
+
+void
+extref_release(dyn_ctx_t ctx, void *ref, external_ref_tag tag)
+{
+    uint32_t handle = (uint32_t)(uintptr_t)ref;
+
+    if (tag == ExtFunc) {
+        drop_func_wrapper(ctx, handle);
+    }
+    wamr_utils_free_extref_handle(ctx, handle);
+}
+
+static void
+destroy_func_wrappers(dyn_ctx_t ctx)
+{
+    ExtFuncWrapperCache *cache = func_wrapper_cache(ctx);
+    uint32_t i;
+
+    if (!cache) {
+        return;
+    }
+
+    dynamic_get_host_data(ctx)->func_wrappers = NULL;
+
+    for (i = 0; i < cache->bucket_count; i++) {
+        ExtFuncWrapper *entry = cache->buckets[i], *next;
+
+        for (; entry; entry = next) {
+            next = entry->next;
+            dynamic_free_weak_ref(ctx, entry->wrapper);
+            wasm_runtime_free(entry);
+        }
+    }
+
+    wasm_runtime_free(cache->buckets);
+    wasm_runtime_free(cache);
+}
+
+void
+extref_context_destroy(dyn_ctx_t ctx)
+{
+    DynHostData *host = dynamic_get_host_data(ctx);
+
+    destroy_func_wrappers(ctx);
+    /* usually already destroyed with the instance */
+    wamr_utils_destroy_extref_handles(ctx);
+
+    if (host->prop_cache) {
+        wasm_runtime_free(host->prop_cache);
+        host->prop_cache = NULL;
+    }
+}
@@ -14,6 +14,44 @@ extref_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem);
 dyn_value_t
 extref_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index);
 
+/* Visitor of extref_foreach_elem, f64 elements are passed as TS_NUMBER,
+ * anyref as TS_ANY holding the dynamic value (not held) and other references
+ * as TS_OBJECT holding the wasm object. Return non-zero to stop the
+ * iteration */
+struct ts_value_t;
+typedef int (*extref_elem_visitor_t)(dyn_ctx_t ctx, uint32_t index,
+                                     struct ts_value_t *elem, void *user_data);
+
+/* Bulk access to the elements of an ExtArray, [start, start + count) is
+ * clamped to the static array. Primitive elements are read and written in
+ * place instead of being boxed one by one. Arrays of i32 elements are
+ * rejected with -DYNTYPE_TYPEERR (NULL for extref_get_elems), booleans and
+ * ints can't be told apart from the array type */
+int
+extref_foreach_elem(dyn_ctx_t ctx, dyn_value_t obj, int start, int count,
+                    extref_elem_visitor_t visitor, void *user_data);
+
+dyn_value_t
+extref_get_elems(dyn_ctx_t ctx, dyn_value_t obj, int start, int count);
+
+/* Elements are read from src starting at index 0 */
+int
+extref_set_elems(dyn_ctx_t ctx, dyn_value_t obj, int start, dyn_value_t src,
+                 int count);
+
+/* Static field access, these never fall back to the dynamic properties of
+ * the extref and return DYNTYPE_FALSE if prop is not a field of obj */
+int
+extref_get_field(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
+                 dyn_value_t *pres);
+
+int
+extref_set_field(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
+                 dyn_value_t value);
+
+int
+extref_has_field(dyn_ctx_t ctx, dyn_value_t obj, const char *prop);
+
 int
 extref_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
                      dyn_value_t value);
@@ -38,6 +76,25 @@ dyn_value_t
 extref_get_keys(dyn_ctx_t ctx, dyn_value_t obj);
 
 void
-extref_unsupported(const char *reason);
+extref_unsupported(dyn_ctx_t ctx, const char *reason);
+
+/* Cached ExtFunc wrapper of a wasm closure, the returned value is held by
+ * the caller, NULL if there is none for ctx */
+dyn_value_t
+extref_get_func_wrapper(dyn_ctx_t ctx, void *closure);
+
+/* The cache doesn't hold wrapper, its entry is dropped by extref_release */
+void
+extref_set_func_wrapper(dyn_ctx_t ctx, void *closure, dyn_value_t wrapper);
+
+/* Free the slot referred to by an extref once the extref is dropped, it is
+ * ignored once the slots of ctx were destroyed with the instance. Registered
+ * on the context with dyntype_set_extref_release_callback */
+void
+extref_release(dyn_ctx_t ctx, void *ref, external_ref_tag tag);
+
+/* Release the wrappers, lookups and extref slots kept for ctx */
+void
+extref_context_destroy(dyn_ctx_t ctx);
 
 #endif /* end of __EXTREF_H_ */
@@ -8,13 +8,20 @@
 #include "object_utils.h"
 #include "type_utils.h"
 #include "wamr_utils.h"
+#include "extref/extref.h"
 
 /****************** Context access *****************/
 void *
 dyntype_get_context_wrapper(wasm_exec_env_t exec_env)
 {
-    dyn_ctx_t ctx = dyntype_get_context();
-    dyntype_context_set_exec_env(exec_env);
+    /* the embedder binds a context to each instance through the user data
+     * of its exec_env, see main.c */
+    dyn_ctx_t ctx = (dyn_ctx_t)wasm_runtime_get_user_data(exec_env);
+
+    if (!ctx) {
+        ctx = dyntype_get_context();
+    }
+    dyntype_context_set_exec_env(ctx, exec_env);
     return wasm_anyref_obj_new(exec_env, ctx);
 }
 
@@ -97,15 +104,40 @@ void
 dyntype_add_elem_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
                          wasm_anyref_obj_t obj, wasm_anyref_obj_t elem)
 {
+    dyntype_add_elem(UNBOX_ANYREF(ctx), UNBOX_ANYREF(obj), UNBOX_ANYREF(elem));
 }
 
 wasm_anyref_obj_t
 dyntype_new_extref_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
-                           void *ptr, external_ref_tag tag)
+                           wasm_obj_t obj, external_ref_tag tag)
 {
-    RETURN_BOX_ANYREF(
-        dyntype_new_extref(UNBOX_ANYREF(ctx), ptr, tag, (void *)exec_env),
-        UNBOX_ANYREF(ctx));
+    dyn_ctx_t dyn_ctx = UNBOX_ANYREF(ctx);
+    dyn_value_t extref;
+    uint32_t handle;
+
+    if (tag == ExtFunc) {
+        /* reuse the wrapper if the closure has been converted before */
+        extref = extref_get_func_wrapper(dyn_ctx, obj);
+        if (extref) {
+            RETURN_BOX_ANYREF(extref, dyn_ctx);
+        }
+    }
+
+    handle = wamr_utils_new_extref_handle(exec_env, dyn_ctx, obj);
+    if (handle == EXTREF_INVALID_HANDLE) {
+        return NULL;
+    }
+
+    extref = dyntype_new_extref(dyn_ctx, (void *)(uintptr_t)handle, tag,
+                                (void *)exec_env);
+    if (!extref) {
+        wamr_utils_free_extref_handle(dyn_ctx, handle);
+    }
+    else if (tag == ExtFunc) {
+        extref_set_func_wrapper(dyn_ctx, obj, extref);
+    }
+
+    RETURN_BOX_ANYREF(extref, dyn_ctx);
 }
 
 wasm_anyref_obj_t
@@ -170,6 +202,53 @@ dyntype_get_property_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
     RETURN_BOX_ANYREF(dyntype_get_property(dyn_ctx, dyn_obj, prop), dyn_ctx);
 }
 
+int
+dyntype_new_atom_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
+                         const char *prop)
+{
+    return dyntype_new_atom(UNBOX_ANYREF(ctx), prop);
+}
+
+int
+dyntype_set_property_atom_wrapper(wasm_exec_env_t exec_env,
+                                  wasm_anyref_obj_t ctx, wasm_anyref_obj_t obj,
+                                  int atom, wasm_anyref_obj_t value)
+{
+    return dyntype_set_property_atom(UNBOX_ANYREF(ctx), UNBOX_ANYREF(obj),
+                                     (dyn_atom_t)atom, UNBOX_ANYREF(value));
+}
+
+dyn_value_t
+dyntype_get_property_atom_wrapper(wasm_exec_env_t exec_env,
+                                  wasm_anyref_obj_t ctx, wasm_anyref_obj_t obj,
+                                  int atom)
+{
+    dyn_value_t dyn_ctx = UNBOX_ANYREF(ctx);
+    dyn_value_t dyn_obj = UNBOX_ANYREF(obj);
+
+    RETURN_BOX_ANYREF(
+        dyntype_get_property_atom(dyn_ctx, dyn_obj, (dyn_atom_t)atom),
+        dyn_ctx);
+}
+
+int
+dyntype_has_property_atom_wrapper(wasm_exec_env_t exec_env,
+                                  wasm_anyref_obj_t ctx, wasm_anyref_obj_t obj,
+                                  int atom)
+{
+    return dyntype_has_property_atom(UNBOX_ANYREF(ctx), UNBOX_ANYREF(obj),
+                                     (dyn_atom_t)atom);
+}
+
+int
+dyntype_delete_property_atom_wrapper(wasm_exec_env_t exec_env,
+                                     wasm_anyref_obj_t ctx,
+                                     wasm_anyref_obj_t obj, int atom)
+{
+    return dyntype_delete_property_atom(UNBOX_ANYREF(ctx), UNBOX_ANYREF(obj),
+                                        (dyn_atom_t)atom);
+}
+
 wasm_anyref_obj_t
 dyntype_get_own_property_wrapper(wasm_exec_env_t exec_env,
                                  wasm_anyref_obj_t ctx, wasm_anyref_obj_t obj,
@@ -365,7 +444,7 @@ dyntype_toString_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
         } else {
             dyntype_to_extref(dyn_ctx, dyn_value, &table_elem);
             table_index = (int32_t)(intptr_t)table_elem;
-            table_elem = wamr_utils_get_table_element(exec_env, table_index);
+            table_elem = wamr_utils_get_extref_obj(dyn_ctx, table_index);
             res = array_to_string(exec_env, dyn_ctx, table_elem, NULL);
         }
     } else {
@@ -488,14 +567,14 @@ dyntype_cmp_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
     if (!l_is_null) {
         dyntype_to_extref(UNBOX_ANYREF(ctx), UNBOX_ANYREF(lhs), &lhs_ref);
         lhs_idx = (int32_t)(intptr_t)lhs_ref;
-        lhs_ref = wamr_utils_get_table_element(exec_env, lhs_idx);
+        lhs_ref = wamr_utils_get_extref_obj(UNBOX_ANYREF(ctx), lhs_idx);
     } else {
         lhs_ref = NULL;
     }
     if (!r_is_null) {
         dyntype_to_extref(UNBOX_ANYREF(ctx), UNBOX_ANYREF(rhs), &rhs_ref);
         rhs_idx = (int32_t)(intptr_t)rhs_ref;
-        rhs_ref = wamr_utils_get_table_element(exec_env, rhs_idx);
+        rhs_ref = wamr_utils_get_extref_obj(UNBOX_ANYREF(ctx), rhs_idx);
     } else {
         rhs_ref = NULL;
     }
@@ -563,7 +642,7 @@ dyntype_instanceof_wrapper(wasm_exec_env_t exec_env, wasm_anyref_obj_t ctx,
     }
     dyntype_to_extref(dyn_ctx, dyn_src, &table_elem);
     table_idx = (int32_t)(intptr_t)table_elem;
-    table_elem = wamr_utils_get_table_element(exec_env, table_idx);
+    table_elem = wamr_utils_get_extref_obj(dyn_ctx, table_idx);
 
     obj = (wasm_obj_t)table_elem;
     inst_obj = (wasm_obj_t)dst_obj;
@@ -704,7 +783,7 @@ dyntype_callback_wasm_dispatcher(void *exec_env_v, dyn_ctx_t ctx, void *vfunc,
     void *closure = NULL;
     void *res = NULL;
 
-    closure = wamr_utils_get_table_element(exec_env, func_id);
+    closure = wamr_utils_get_extref_obj(ctx, func_id);
     res = call_wasm_func_with_boxing(exec_env, ctx,
                                      (wasm_anyref_obj_t)closure, argc,
                                      args);
@@ -733,7 +812,7 @@ static NativeSymbol native_symbols[] = {
     REG_NATIVE_FUNC(dyntype_add_elem, "(rrr)"),
     REG_NATIVE_FUNC(dyntype_set_elem, "(rrir)"),
     REG_NATIVE_FUNC(dyntype_get_elem, "(rri)r"),
-    REG_NATIVE_FUNC(dyntype_new_extref, "(rii)r"),
+    REG_NATIVE_FUNC(dyntype_new_extref, "(rri)r"),
     REG_NATIVE_FUNC(dyntype_new_object_with_proto, "(rr)r"),
 
     REG_NATIVE_FUNC(dyntype_set_prototype, "(rrr)i"),
@@ -745,6 +824,11 @@ static NativeSymbol native_symbols[] = {
     REG_NATIVE_FUNC(dyntype_get_property, "(rr$)r"),
     REG_NATIVE_FUNC(dyntype_has_property, "(rr$)i"),
     REG_NATIVE_FUNC(dyntype_delete_property, "(rr$)i"),
+    REG_NATIVE_FUNC(dyntype_new_atom, "(r$)i"),
+    REG_NATIVE_FUNC(dyntype_set_property_atom, "(rrir)i"),
+    REG_NATIVE_FUNC(dyntype_get_property_atom, "(rri)r"),
+    REG_NATIVE_FUNC(dyntype_has_property_atom, "(rri)i"),
+    REG_NATIVE_FUNC(dyntype_delete_property_atom, "(rri)i"),
 
     REG_NATIVE_FUNC(dyntype_get_keys, "(rr)r"),
 
@@ -8,8 +8,6 @@
 #include "pure_dynamic.h"
 #include "extref/extref.h"
 
-static void *g_exec_env = NULL;
-static dyntype_callback_dispatcher_t g_cb_dispatcher = NULL;
 
 /********************************************/
 /*     APIs exposed to runtime embedder     */
@@ -29,33 +27,51 @@ dyntype_context_init_with_opt(dyn_options_t *options)
 void
 dyntype_context_destroy(dyn_ctx_t ctx)
 {
-    g_exec_env = NULL;
-    g_cb_dispatcher = NULL;
+    if (!ctx) {
+        return;
+    }
+
+    extref_context_destroy(ctx);
     dynamic_context_destroy(ctx);
 }
 
 void
-dyntype_context_set_exec_env(void *exec_env)
+dyntype_context_set_exec_env(dyn_ctx_t ctx, void *exec_env)
 {
-    g_exec_env = exec_env;
+    dynamic_get_host_data(ctx)->exec_env = exec_env;
+    dynamic_set_context(ctx);
 }
 
 void *
-dyntype_context_get_exec_env()
+dyntype_context_get_exec_env(dyn_ctx_t ctx)
 {
-    return g_exec_env;
+    return ctx ? dynamic_get_host_data(ctx)->exec_env : NULL;
 }
 
 void
-dyntype_set_callback_dispatcher(dyntype_callback_dispatcher_t callback)
+dyntype_set_callback_dispatcher(dyn_ctx_t ctx,
+                                dyntype_callback_dispatcher_t callback)
 {
-    g_cb_dispatcher = callback;
+    dynamic_get_host_data(ctx)->cb_dispatcher = callback;
 }
 
 dyntype_callback_dispatcher_t
-dyntype_get_callback_dispatcher()
+dyntype_get_callback_dispatcher(dyn_ctx_t ctx)
+{
+    return ctx ? dynamic_get_host_data(ctx)->cb_dispatcher : NULL;
+}
+
+void
+dyntype_set_extref_release_callback(dyn_ctx_t ctx,
+                                    dyntype_extref_release_t callback)
 {
-    return g_cb_dispatcher;
+    dynamic_get_host_data(ctx)->extref_release = callback;
+}
+
+dyntype_extref_release_t
+dyntype_get_extref_release_callback(dyn_ctx_t ctx)
+{
+    return ctx ? dynamic_get_host_data(ctx)->extref_release : NULL;
 }
 
 int
@@ -88,6 +104,12 @@ dyntype_dump_value_buffer(dyn_ctx_t ctx, dyn_value_t obj, void *buffer, int len)
     return dynamic_dump_value_buffer(ctx, obj, buffer, len);
 }
 
+void
+dyntype_dump_memory_usage(dyn_ctx_t ctx)
+{
+    dynamic_dump_memory_usage(ctx);
+}
+
 dyn_value_t
 dyntype_hold(dyn_ctx_t ctx, dyn_value_t obj)
 {
@@ -106,15 +128,21 @@ dyntype_collect(dyn_ctx_t ctx)
     dynamic_collect(ctx);
 }
 
+bool
+dyntype_is_immediate(dyn_ctx_t ctx, dyn_value_t obj)
+{
+    return dynamic_is_immediate(ctx, obj);
+}
+
 /********************************************/
 /*     APIs exposed to wasm application     */
 /********************************************/
 
-#define EXTREF_NOT_ALLOWED(api_name, ret)                              \
-    if (dyntype_is_extref(ctx, obj)) {                                 \
-        extref_unsupported(                                            \
-            "libdyntype: unsupport operation for extref: " #api_name); \
-        return ret;                                                    \
+#define EXTREF_NOT_ALLOWED(api_name, ret)                                   \
+    if (dyntype_is_extref(ctx, obj)) {                                      \
+        extref_unsupported(                                                 \
+            ctx, "libdyntype: unsupport operation for extref: " #api_name); \
+        return ret;                                                         \
     }
 
 #define MIXED_TYPE_DISPATCH(api_name, ...)          \
@@ -207,12 +235,79 @@ dyntype_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem)
     MIXED_TYPE_DISPATCH(set_elem, obj, index, elem)
 }
 
+int
+dyntype_add_elem(dyn_ctx_t ctx, dyn_value_t obj, dyn_value_t elem)
+{
+    /* static arrays have a fixed length */
+    EXTREF_NOT_ALLOWED(add_elem, -DYNTYPE_TYPEERR)
+
+    return dynamic_add_elem(ctx, obj, elem);
+}
+
 dyn_value_t
 dyntype_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index)
 {
     MIXED_TYPE_DISPATCH(get_elem, obj, index)
 }
 
+dyn_value_t
+dyntype_get_elems(dyn_ctx_t ctx, dyn_value_t obj, int start, int count)
+{
+    dyn_value_t arr, elem;
+    int i, length;
+
+    if (dyntype_is_extref(ctx, obj)) {
+        return extref_get_elems(ctx, obj, start, count);
+    }
+
+    if (!dynamic_is_array(ctx, obj)) {
+        return NULL;
+    }
+
+    length = dynamic_get_array_length(ctx, obj);
+    if (start < 0 || count < 0 || start >= length) {
+        count = 0;
+    }
+    else if (count > length - start) {
+        count = length - start;
+    }
+
+    if (!(arr = dynamic_new_array(ctx, count))) {
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        if ((elem = dynamic_get_elem(ctx, obj, start + i))) {
+            dynamic_set_elem(ctx, arr, i, elem);
+            dynamic_release(ctx, elem);
+        }
+    }
+
+    return arr;
+}
+
+int
+dyntype_set_elems(dyn_ctx_t ctx, dyn_value_t obj, int start, dyn_value_t src,
+                  int count)
+{
+    dyn_value_t elem;
+    int i;
+
+    if (dyntype_is_extref(ctx, obj)) {
+        return extref_set_elems(ctx, obj, start, src, count);
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!(elem = dynamic_get_elem(ctx, src, i))) {
+            return -DYNTYPE_TYPEERR;
+        }
+        dynamic_set_elem(ctx, obj, start + i, elem);
+        dynamic_release(ctx, elem);
+    }
+
+    return DYNTYPE_SUCCESS;
+}
+
 int
 dyntype_set_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop,
                      dyn_value_t value)
@@ -253,6 +348,90 @@ dyntype_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop)
     MIXED_TYPE_DISPATCH(delete_property, obj, prop)
 }
 
+dyn_atom_t
+dyntype_new_atom(dyn_ctx_t ctx, const char *prop)
+{
+    return dynamic_new_atom(ctx, prop);
+}
+
+/* extref fields are looked up by name, so the atom is converted back */
+int
+dyntype_set_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom,
+                          dyn_value_t value)
+{
+    const char *prop;
+    int res;
+
+    if (!dyntype_is_extref(ctx, obj)) {
+        return dynamic_set_property_atom(ctx, obj, atom, value);
+    }
+
+    if (!(prop = dynamic_atom_to_cstring(ctx, atom))) {
+        return -DYNTYPE_EXCEPTION;
+    }
+    res = extref_set_property(ctx, obj, prop, value);
+    dynamic_free_atom_cstring(ctx, prop);
+
+    return res;
+}
+
+dyn_value_t
+dyntype_get_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom)
+{
+    const char *prop;
+    dyn_value_t res;
+
+    if (!dyntype_is_extref(ctx, obj)) {
+        return dynamic_get_property_atom(ctx, obj, atom);
+    }
+
+    if (!(prop = dynamic_atom_to_cstring(ctx, atom))) {
+        return NULL;
+    }
+    res = extref_get_property(ctx, obj, prop);
+    dynamic_free_atom_cstring(ctx, prop);
+
+    return res;
+}
+
+int
+dyntype_has_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom)
+{
+    const char *prop;
+    int res;
+
+    if (!dyntype_is_extref(ctx, obj)) {
+        return dynamic_has_property_atom(ctx, obj, atom);
+    }
+
+    if (!(prop = dynamic_atom_to_cstring(ctx, atom))) {
+        return -DYNTYPE_EXCEPTION;
+    }
+    res = extref_has_property(ctx, obj, prop);
+    dynamic_free_atom_cstring(ctx, prop);
+
+    return res;
+}
+
+int
+dyntype_delete_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom)
+{
+    const char *prop;
+    int res;
+
+    if (!dyntype_is_extref(ctx, obj)) {
+        return dynamic_delete_property_atom(ctx, obj, atom);
+    }
+
+    if (!(prop = dynamic_atom_to_cstring(ctx, atom))) {
+        return -DYNTYPE_EXCEPTION;
+    }
+    res = extref_delete_property(ctx, obj, prop);
+    dynamic_free_atom_cstring(ctx, prop);
+
+    return res;
+}
+
 dyn_value_t dyntype_get_keys(dyn_ctx_t ctx, dyn_value_t obj)
 {
     bool is_extref;
@@ -24,14 +24,29 @@ extern "C" {
 struct DynTypeContext;
 
 typedef struct DynTypeContext *dyn_ctx_t;
-typedef void dyn_options_t;
 typedef void *dyn_value_t;
 
-typedef dyn_value_t (*dyntype_callback_dispatcher_t)(void *env, dyn_ctx_t ctx,
-                                                     void *vfunc,
-                                                     dyn_value_t this_obj,
-                                                     int argc,
-                                                     dyn_value_t *args);
+/* Options of dyntype_context_init_with_opt, a zero field keeps the default
+ * of the backend */
+typedef struct dyn_options_t {
+    /* max bytes held by dynamic values */
+    uint64_t memory_limit;
+    /* quickjs: bytes allocated since the last collection that trigger the
+     * next one. simple: number of possible cycle roots that trigger a cycle
+     * collection */
+    uint64_t gc_threshold;
+    /* max native stack used by the js runtime, only used by quickjs */
+    uint64_t max_stack_size;
+    /* expected number of distinct property names, the property name tables
+     * are sized for it at creation */
+    uint32_t property_table_size;
+} dyn_options_t;
+
+/* Property name resolved by dyntype_new_atom, valid until the context is
+ * destroyed */
+typedef uint32_t dyn_atom_t;
+
+#define DYNTYPE_ATOM_NULL 0
 
 typedef enum external_ref_tag {
     ExtObj,
@@ -39,6 +54,28 @@ typedef enum external_ref_tag {
     ExtArray,
 } external_ref_tag;
 
+typedef dyn_value_t (*dyntype_callback_dispatcher_t)(void *env, dyn_ctx_t ctx,
+                                                     void *vfunc,
+                                                     dyn_value_t this_obj,
+                                                     int argc,
+                                                     dyn_value_t *args);
+
+typedef void (*dyntype_extref_release_t)(dyn_ctx_t ctx, void *ref,
+                                         external_ref_tag tag);
+
+/* Embedder state bound to a context, each backend stores one in its context
+ * and it's only used by libdyntype.c and the extref layer */
+typedef struct DynHostData {
+    void *exec_env;
+    dyntype_callback_dispatcher_t cb_dispatcher;
+    dyntype_extref_release_t extref_release;
+    /* ExtFunc wrappers and static field lookups, see extref.c */
+    void *func_wrappers;
+    void *prop_cache;
+    /* wasm objects referred to by extrefs, see wamr_utils.c */
+    void *extref_slots;
+} DynHostData;
+
 typedef enum dyn_type_t {
     DynUnknown,
     DynNull,
@@ -77,7 +114,9 @@ typedef enum cmp_operator {
 /****************** Context access *****************/
 
 /**
- * @brief Get the global dynamic type system context
+ * @brief Get the dynamic type system context of the calling thread, that is
+ * the last one bound by dyntype_context_set_exec_env on this thread, or the
+ * first one created on it
  *
  * @return dynamic type system context if success, NULL otherwise
  */
@@ -206,6 +245,17 @@ dyntype_new_extref(dyn_ctx_t ctx, void *ptr, external_ref_tag tag, void* opaque)
 int
 dyntype_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem);
 
+/**
+ * @brief Append an element to the end of a dynamic array.
+ *
+ * @param ctx the dynamic type system context
+ * @param obj dynamic array
+ * @param elem the value to be appended
+ * @return 0: SUCCESS, -1: EXCEPTION, -2: TYPE ERROR
+ */
+int
+dyntype_add_elem(dyn_ctx_t ctx, dyn_value_t obj, dyn_value_t elem);
+
 /**
  * @brief Get the value of a dynamic object by index.
  *
@@ -217,6 +267,36 @@ dyntype_set_elem(dyn_ctx_t ctx, dyn_value_t obj, int index, dyn_value_t elem);
 dyn_value_t
 dyntype_get_elem(dyn_ctx_t ctx, dyn_value_t obj, int index);
 
+/**
+ * @brief Copy a range of elements of an array into a new dynamic array. The
+ * elements of a static array are converted without boxing them one by one,
+ * static arrays of boolean or int elements are not supported.
+ *
+ * @param ctx the dynamic type system context
+ * @param obj dynamic array or static array extref
+ * @param start the index of the first element
+ * @param count the number of elements, clamped to the array length
+ * @return dynamic array if success, NULL otherwise
+ */
+dyn_value_t
+dyntype_get_elems(dyn_ctx_t ctx, dyn_value_t obj, int start, int count);
+
+/**
+ * @brief Copy the elements of a dynamic array into a range of an array,
+ * static arrays of boolean or int elements are not supported
+ *
+ * @param ctx the dynamic type system context
+ * @param obj dynamic array or static array extref
+ * @param start the index of the first element to be set
+ * @param src dynamic array, read from index 0
+ * @param count the number of elements, clamped to the length of obj if it is
+ * a static array
+ * @return 0: SUCCESS, -1: EXCEPTION, -2: TYPE ERROR
+ */
+int
+dyntype_set_elems(dyn_ctx_t ctx, dyn_value_t obj, int start, dyn_value_t src,
+                  int count);
+
 /**
  * @brief Set the property of a dynamic object
  *
@@ -289,6 +369,68 @@ dyntype_has_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop);
 int
 dyntype_delete_property(dyn_ctx_t ctx, dyn_value_t obj, const char *prop);
 
+/**
+ * @brief Resolve a property name to an atom, resolving the same name again
+ * returns the same atom
+ *
+ * @param ctx the dynamic type system context
+ * @param prop property name
+ * @return the atom if success, DYNTYPE_ATOM_NULL otherwise
+ */
+dyn_atom_t
+dyntype_new_atom(dyn_ctx_t ctx, const char *prop);
+
+/**
+ * @brief Set the property of a dynamic object, same as dyntype_set_property
+ * with a pre-resolved property name
+ *
+ * @param ctx the dynamic type system context
+ * @param obj dynamic object
+ * @param atom property name returned by dyntype_new_atom
+ * @param value the value to be set to the property
+ * @return 0 if success, error code otherwise
+ * @retval -1:EXCEPTION, -2: TYPE ERROR
+ */
+int
+dyntype_set_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom,
+                          dyn_value_t value);
+
+/**
+ * @brief Get the property of a dynamic object, same as dyntype_get_property
+ * with a pre-resolved property name
+ *
+ * @param ctx the dynamic type system context
+ * @param obj dynamic object
+ * @param atom property name returned by dyntype_new_atom
+ * @return dynamic value if success, NULL otherwise
+ */
+dyn_value_t
+dyntype_get_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom);
+
+/**
+ * @brief Test if the property exists on the given object, same as
+ * dyntype_has_property with a pre-resolved property name
+ *
+ * @param ctx the dynamic type system context
+ * @param obj dynamic object
+ * @param atom property name returned by dyntype_new_atom
+ * @return TRUE if exists, FALSE if not exists, -1 if EXCEPTION
+ */
+int
+dyntype_has_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom);
+
+/**
+ * @brief Delete the property of the given object, same as
+ * dyntype_delete_property with a pre-resolved property name
+ *
+ * @param ctx the dynamic type system context
+ * @param obj dynamic object
+ * @param atom property name returned by dyntype_new_atom
+ * @return TRUE if success, FALSE if failed, -1 if EXCEPTION
+ */
+int
+dyntype_delete_property_atom(dyn_ctx_t ctx, dyn_value_t obj, dyn_atom_t atom);
+
 /**
  * @brief Get the enumerable properties of the given object
  *
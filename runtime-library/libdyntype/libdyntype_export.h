@@ -33,10 +33,11 @@ dyntype_context_init();
 /**
  * @brief Initialize the dynamic type system context with given options
  *
- * @note options can contain allocator functions and maybe other GC related
- * things
+ * @note the memory limit is checked when a backend allocates memory for
+ * dynamic values. When it is reached, the simple backend collects cycles
+ * and retries once; QuickJS throws an out of memory exception.
  *
- * @param options options to set (TBD)
+ * @param options options to set, see dyn_options_t, NULL for the defaults
  * @return dynamic type system context if success, NULL otherwise
  */
 dyn_ctx_t
@@ -51,20 +52,26 @@ void
 dyntype_context_destroy(dyn_ctx_t ctx);
 
 /**
- * @brief Bind an execution environment to libdyntype
+ * @brief Bind an execution environment to the context, the context also
+ * becomes the one returned by dyntype_get_context on the calling thread.
+ * Every context is independent, an embedder running several module instances
+ * creates one context for each of them and binds it before running the
+ * instance.
  *
+ * @param ctx the dynamic type system context
  * @param exec_env the execution environment to bind
  */
 void
-dyntype_context_set_exec_env(void *exec_env);
+dyntype_context_set_exec_env(dyn_ctx_t ctx, void *exec_env);
 
 /**
- * @brief Get the execution environment bound to libdyntype
+ * @brief Get the execution environment bound to the context
  *
- * @return the execution environment bound to libdyntype
+ * @param ctx the dynamic type system context
+ * @return the execution environment bound to the context
  */
 void *
-dyntype_context_get_exec_env();
+dyntype_context_get_exec_env(dyn_ctx_t ctx);
 
 /**
  * @brief Set the callback dispatcher for external functions. When calling
@@ -77,18 +84,44 @@ dyntype_context_get_exec_env();
  *
  * @note If another callback is set, the previous one will be overwrite.
  *
+ * @param ctx the dynamic type system context
  * @param callback the callback to set
  */
 void
-dyntype_set_callback_dispatcher(dyntype_callback_dispatcher_t callback);
+dyntype_set_callback_dispatcher(dyn_ctx_t ctx,
+                                dyntype_callback_dispatcher_t callback);
 
 /**
  * @brief Get the callback dispatcher for external functions.
  *
+ * @param ctx the dynamic type system context
  * @return the callback dispatcher for external functions
  */
 dyntype_callback_dispatcher_t
-dyntype_get_callback_dispatcher();
+dyntype_get_callback_dispatcher(dyn_ctx_t ctx);
+
+/**
+ * @brief Set the callback invoked when an extref is freed. The reference
+ * stored in an extref is opaque to libdyntype, the embedder may use the
+ * callback to release what it refers to.
+ *
+ * @note If another callback is set, the previous one will be overwrite.
+ *
+ * @param ctx the dynamic type system context
+ * @param callback the callback to set
+ */
+void
+dyntype_set_extref_release_callback(dyn_ctx_t ctx,
+                                    dyntype_extref_release_t callback);
+
+/**
+ * @brief Get the callback invoked when an extref is freed.
+ *
+ * @param ctx the dynamic type system context
+ * @return the callback invoked when an extref is freed
+ */
+dyntype_extref_release_t
+dyntype_get_extref_release_callback(dyn_ctx_t ctx);
 
 /******************* event loop *******************/
 
@@ -146,6 +179,14 @@ int
 dyntype_dump_value_buffer(dyn_ctx_t ctx, dyn_value_t obj, void *buffer,
                           int len);
 
+/**
+ * @brief Dump memory usage of the dynamic type system to stdout
+ *
+ * @param ctx the dynamic type system context
+ */
+void
+dyntype_dump_memory_usage(dyn_ctx_t ctx);
+
 /******************* Garbage collection *******************/
 
 /**
@@ -177,6 +218,17 @@ dyntype_release(dyn_ctx_t ctx, dyn_value_t obj);
 void
 dyntype_collect(dyn_ctx_t ctx);
 
+/**
+ * @brief Check if the value is encoded as an immediate, immediate values are
+ * not allocated and dyntype_hold/dyntype_release on them are no-ops
+ *
+ * @param ctx the dynamic type system context
+ * @param obj the dynamic value
+ * @return true if the value is an immediate, false otherwise
+ */
+bool
+dyntype_is_immediate(dyn_ctx_t ctx, dyn_value_t obj);
+
 /**
  * @brief Get array's length
  *
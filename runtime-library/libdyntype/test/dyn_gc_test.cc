@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "libdyntype_export.h"
+extern "C" {
+#include "type.h"
+}
+#include <gtest/gtest.h>
+
+class DynGCTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        ctx = dyntype_context_init();
+        base_objects = live_count(DynClassObject);
+        base_arrays = live_count(DynClassArray);
+    }
+
+    virtual void TearDown() { dyntype_context_destroy(ctx); }
+
+    int64_t live_count(uint32_t class_id)
+    {
+        DynAllocUsage usage;
+
+        dyn_allocator_get_usage(&((DynTypeContext *)ctx)->allocator, &usage);
+        return usage.live_count[class_id];
+    }
+
+    int64_t live_objects() { return live_count(DynClassObject) - base_objects; }
+
+    int64_t live_arrays() { return live_count(DynClassArray) - base_arrays; }
+
+    uint32_t buffered_roots() { return ((DynTypeContext *)ctx)->gc.root_count; }
+
+    dyn_ctx_t ctx;
+    int64_t base_objects;
+    int64_t base_arrays;
+};
+
+TEST_F(DynGCTest, self_cycle)
+{
+    dyn_value_t obj = dyntype_new_object(ctx);
+
+    dyntype_set_property(ctx, obj, "self", obj);
+    dyntype_release(ctx, obj);
+
+    /* only the cycle collector can free it */
+    EXPECT_EQ(live_objects(), 1);
+    EXPECT_EQ(buffered_roots(), 1);
+
+    dyntype_collect(ctx);
+    EXPECT_EQ(live_objects(), 0);
+    EXPECT_EQ(buffered_roots(), 0);
+}
+
+TEST_F(DynGCTest, two_object_cycle)
+{
+    dyn_value_t obj1 = dyntype_new_object(ctx);
+    dyn_value_t obj2 = dyntype_new_object(ctx);
+
+    dyntype_set_property(ctx, obj1, "next", obj2);
+    dyntype_set_property(ctx, obj2, "next", obj1);
+    dyntype_release(ctx, obj1);
+    dyntype_release(ctx, obj2);
+    EXPECT_EQ(live_objects(), 2);
+
+    dyntype_collect(ctx);
+    EXPECT_EQ(live_objects(), 0);
+    EXPECT_EQ(buffered_roots(), 0);
+}
+
+TEST_F(DynGCTest, cycle_with_external_ref)
+{
+    dyn_value_t obj1 = dyntype_new_object(ctx);
+    dyn_value_t obj2 = dyntype_new_object(ctx);
+    dyn_value_t num = dyntype_new_number(ctx, 42);
+    dyn_value_t next, value;
+    double raw_number = 0;
+
+    dyntype_set_property(ctx, obj1, "next", obj2);
+    dyntype_set_property(ctx, obj2, "next", obj1);
+    dyntype_set_property(ctx, obj2, "value", num);
+    dyntype_release(ctx, num);
+    /* obj1 is still referenced */
+    dyntype_release(ctx, obj2);
+
+    dyntype_collect(ctx);
+    EXPECT_EQ(live_objects(), 2);
+
+    /* the cycle survived intact */
+    next = dyntype_get_property(ctx, obj1, "next");
+    value = dyntype_get_property(ctx, next, "value");
+    EXPECT_EQ(dyntype_to_number(ctx, value, &raw_number), DYNTYPE_SUCCESS);
+    EXPECT_EQ(raw_number, 42);
+    dyntype_release(ctx, value);
+    dyntype_release(ctx, next);
+
+    dyntype_release(ctx, obj1);
+    dyntype_collect(ctx);
+    EXPECT_EQ(live_objects(), 0);
+    EXPECT_EQ(buffered_roots(), 0);
+}
+
+TEST_F(DynGCTest, cycle_through_array)
+{
+    dyn_value_t obj = dyntype_new_object(ctx);
+    dyn_value_t arr = dyntype_new_array(ctx, 0);
+    dyn_value_t elem = dyntype_new_object(ctx);
+
+    dyntype_set_elem(ctx, arr, 0, elem);
+    dyntype_set_elem(ctx, arr, 1, obj);
+    dyntype_set_property(ctx, obj, "arr", arr);
+    dyntype_release(ctx, elem);
+    dyntype_release(ctx, obj);
+    dyntype_release(ctx, arr);
+    EXPECT_EQ(live_objects(), 2);
+    EXPECT_EQ(live_arrays(), 1);
+
+    dyntype_collect(ctx);
+    EXPECT_EQ(live_objects(), 0);
+    EXPECT_EQ(live_arrays(), 0);
+    EXPECT_EQ(buffered_roots(), 0);
+}
+
+TEST_F(DynGCTest, buffered_released_to_zero)
+{
+    dyn_value_t obj = dyntype_new_object(ctx);
+    dyn_value_t prop = dyntype_new_object(ctx);
+
+    /* dropping a reference makes a value a possible root */
+    dyntype_set_property(ctx, obj, "prop", prop);
+    dyntype_release(ctx, prop);
+    dyntype_hold(ctx, obj);
+    dyntype_release(ctx, obj);
+    EXPECT_TRUE(((DynValue *)obj)->gc_flags & DYN_GC_FLAG_BUFFERED);
+    EXPECT_TRUE(((DynValue *)prop)->gc_flags & DYN_GC_FLAG_BUFFERED);
+    EXPECT_EQ(buffered_roots(), 2);
+
+    /* the buffer still points to obj, freeing it is deferred and keeps its
+     * children alive */
+    dyntype_release(ctx, obj);
+    EXPECT_EQ(live_objects(), 2);
+    EXPECT_EQ(buffered_roots(), 2);
+
+    dyntype_collect(ctx);
+    EXPECT_EQ(live_objects(), 0);
+    EXPECT_EQ(buffered_roots(), 0);
+}
+
+TEST_F(DynGCTest, collect_at_memory_limit)
+{
+    dyn_options_t options = { 0 };
+    dyn_value_t obj;
+
+    /* only the memory limit can trigger a collection */
+    options.memory_limit = 256 * 1024;
+    options.gc_threshold = UINT32_MAX;
+    dyntype_context_destroy(ctx);
+    ctx = dyntype_context_init_with_opt(&options);
+    ASSERT_NE(ctx, nullptr);
+
+    for (int i = 0; i < 100000; i++) {
+        obj = dyntype_new_object(ctx);
+        ASSERT_NE(obj, nullptr);
+        dyntype_set_property(ctx, obj, "self", obj);
+        dyntype_release(ctx, obj);
+    }
+    EXPECT_LT(live_count(DynClassObject), 100000);
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "libdyntype_export.h"
+#include "pure_dynamic.h"
+extern "C" {
+#include "type.h"
+}
+#include <gtest/gtest.h>
+#include <string>
+
+class DynStringTest : public testing::Test
+{
+  protected:
+    virtual void SetUp() { ctx = dyntype_context_init(); }
+
+    virtual void TearDown() { dyntype_context_destroy(ctx); }
+
+    DyntypeString *new_string(const std::string &str)
+    {
+        return (DyntypeString *)dyn_value_new_string(str.c_str(),
+                                                     str.length());
+    }
+
+    /* leaves longer than DYN_ROPE_LEAF_LENGTH are never merged */
+    std::string make_chunk(int i)
+    {
+        return std::string(DYN_ROPE_LEAF_LENGTH + 1, (char)('a' + i % 26));
+    }
+
+    bool is_rope(DyntypeString *dyn_str) { return dyn_str->data == NULL; }
+
+    DynStringTable *string_table()
+    {
+        return ((DynTypeContext *)ctx)->string_table;
+    }
+
+    dyn_ctx_t ctx;
+};
+
+TEST_F(DynStringTest, rope_depth_bounded)
+{
+    DyntypeString *appended = new_string("");
+    DyntypeString *prepended = new_string("");
+    std::string expected_appended, expected_prepended;
+
+    for (int i = 0; i < DYN_ROPE_MAX_DEPTH * 4; i++) {
+        std::string chunk = make_chunk(i);
+        DyntypeString *leaf = new_string(chunk);
+        DyntypeString *res;
+
+        res = dyn_string_concat(appended, leaf);
+        ASSERT_NE(res, nullptr);
+        dyn_value_release((DynValue *)appended);
+        appended = res;
+        expected_appended += chunk;
+
+        res = dyn_string_concat(leaf, prepended);
+        ASSERT_NE(res, nullptr);
+        dyn_value_release((DynValue *)prepended);
+        prepended = res;
+        expected_prepended = chunk + expected_prepended;
+
+        dyn_value_release((DynValue *)leaf);
+
+        EXPECT_LE(appended->depth, DYN_ROPE_MAX_DEPTH);
+        EXPECT_LE(prepended->depth, DYN_ROPE_MAX_DEPTH);
+    }
+
+    EXPECT_TRUE(is_rope(appended));
+    EXPECT_TRUE(is_rope(prepended));
+    ASSERT_EQ(appended->length, expected_appended.length());
+    ASSERT_EQ(prepended->length, expected_prepended.length());
+    EXPECT_EQ(std::string((char *)dyn_string_data(appended), appended->length),
+              expected_appended);
+    EXPECT_EQ(
+        std::string((char *)dyn_string_data(prepended), prepended->length),
+        expected_prepended);
+
+    dyn_value_release((DynValue *)appended);
+    dyn_value_release((DynValue *)prepended);
+}
+
+TEST_F(DynStringTest, rope_eq_flat)
+{
+    std::string left = make_chunk(0), right = make_chunk(1);
+    std::string different = left + make_chunk(2);
+    DyntypeString *dyn_left = new_string(left);
+    DyntypeString *dyn_right = new_string(right);
+    DyntypeString *flat = new_string(left + right);
+    DyntypeString *other = new_string(different);
+    DyntypeString *rope1 = dyn_string_concat(dyn_left, dyn_right);
+    DyntypeString *rope2 = dyn_string_concat(dyn_left, dyn_right);
+
+    ASSERT_TRUE(is_rope(rope1));
+    ASSERT_TRUE(is_rope(rope2));
+    EXPECT_FALSE(dyn_string_eq(rope1, other));
+    EXPECT_TRUE(dyn_string_eq(rope1, flat));
+    EXPECT_TRUE(dyn_string_eq(flat, rope2));
+    EXPECT_TRUE(dyn_string_eq(rope1, rope2));
+    EXPECT_FALSE(dyn_string_eq(other, rope2));
+
+    dyn_value_release((DynValue *)dyn_left);
+    dyn_value_release((DynValue *)dyn_right);
+    dyn_value_release((DynValue *)flat);
+    dyn_value_release((DynValue *)other);
+    dyn_value_release((DynValue *)rope1);
+    dyn_value_release((DynValue *)rope2);
+}
+
+TEST_F(DynStringTest, rope_slice)
+{
+    std::string left(100, 'l'), right(100, 'r');
+    DyntypeString *dyn_left = new_string(left);
+    DyntypeString *dyn_right = new_string(right);
+    DyntypeString *rope = dyn_string_concat(dyn_left, dyn_right);
+    std::string expected = left + right;
+    uint32_t ranges[][2] = { { 90, 110 }, { 99, 101 }, { 0, 100 },
+                             { 100, 200 }, { 0, 200 },  { 100, 100 } };
+
+    ASSERT_TRUE(is_rope(rope));
+
+    for (int i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++) {
+        uint32_t start = ranges[i][0], end = ranges[i][1];
+        DyntypeString *slice = dyn_string_slice(rope, start, end);
+
+        ASSERT_NE(slice, nullptr);
+        ASSERT_EQ(slice->length, end - start);
+        EXPECT_EQ(std::string((char *)dyn_string_data(slice), slice->length),
+                  expected.substr(start, end - start));
+        dyn_value_release((DynValue *)slice);
+    }
+
+    /* the operands are still valid after the rope was flattened */
+    EXPECT_EQ(std::string((char *)dyn_string_data(dyn_left), 100), left);
+    EXPECT_EQ(std::string((char *)dyn_string_data(dyn_right), 100), right);
+
+    dyn_value_release((DynValue *)dyn_left);
+    dyn_value_release((DynValue *)dyn_right);
+    dyn_value_release((DynValue *)rope);
+}
+
+TEST_F(DynStringTest, interned_identity)
+{
+    uint32_t count = string_table()->count;
+    DyntypeString *str1 = new_string("interned");
+    DyntypeString *str2 = new_string("interned");
+    DyntypeString *str3 = new_string("interned_");
+    std::string long_str(DYN_STRING_INTERN_MAX_LENGTH + 1, 'x');
+    DyntypeString *long1 = new_string(long_str);
+    DyntypeString *long2 = new_string(long_str);
+
+    /* short strings with the same content share one instance */
+    EXPECT_EQ(str1, str2);
+    EXPECT_NE(str1, str3);
+    EXPECT_TRUE(str1->flags & DYN_STRING_FLAG_INTERNED);
+    EXPECT_TRUE(str3->flags & DYN_STRING_FLAG_INTERNED);
+    EXPECT_EQ(string_table()->count, count + 2);
+    EXPECT_TRUE(dyn_string_eq(str1, str2));
+    EXPECT_FALSE(dyn_string_eq(str1, str3));
+
+    /* longer strings are not interned but still compare by content */
+    EXPECT_NE(long1, long2);
+    EXPECT_FALSE(long1->flags & DYN_STRING_FLAG_INTERNED);
+    EXPECT_TRUE(dyn_string_eq(long1, long2));
+    EXPECT_EQ(string_table()->count, count + 2);
+
+    dyn_value_release((DynValue *)str1);
+    dyn_value_release((DynValue *)str2);
+    dyn_value_release((DynValue *)str3);
+    dyn_value_release((DynValue *)long1);
+    dyn_value_release((DynValue *)long2);
+}
+
+TEST_F(DynStringTest, interned_removed_on_release)
+{
+    uint32_t count = string_table()->count;
+    DyntypeString *strs[64];
+    char buf[16];
+
+    /* enough strings to grow the table */
+    for (int i = 0; i < 64; i++) {
+        snprintf(buf, sizeof(buf), "str%d", i);
+        strs[i] = new_string(buf);
+        ASSERT_TRUE(strs[i]->flags & DYN_STRING_FLAG_INTERNED);
+    }
+    EXPECT_EQ(string_table()->count, count + 64);
+
+    /* an extra reference keeps the string in the table */
+    dyn_value_hold((DynValue *)strs[0]);
+    dyn_value_release((DynValue *)strs[0]);
+    EXPECT_EQ(string_table()->count, count + 64);
+    EXPECT_EQ(new_string("str0"), strs[0]);
+    dyn_value_release((DynValue *)strs[0]);
+
+    /* release every other string, the remaining ones must still be found
+     * after the probe sequences were shifted */
+    for (int i = 0; i < 64; i += 2) {
+        dyn_value_release((DynValue *)strs[i]);
+    }
+    EXPECT_EQ(string_table()->count, count + 32);
+
+    for (int i = 1; i < 64; i += 2) {
+        snprintf(buf, sizeof(buf), "str%d", i);
+        DyntypeString *str = new_string(buf);
+        EXPECT_EQ(str, strs[i]);
+        dyn_value_release((DynValue *)str);
+    }
+
+    /* a released string is interned again when recreated */
+    DyntypeString *str = new_string("str0");
+    EXPECT_TRUE(str->flags & DYN_STRING_FLAG_INTERNED);
+    EXPECT_EQ(string_table()->count, count + 33);
+    dyn_value_release((DynValue *)str);
+
+    for (int i = 1; i < 64; i += 2) {
+        dyn_value_release((DynValue *)strs[i]);
+    }
+    EXPECT_EQ(string_table()->count, count);
+}
+
+TEST_F(DynStringTest, released_into_owner_context)
+{
+    dyn_ctx_t other = dyntype_context_init();
+    DynStringTable *other_table = ((DynTypeContext *)other)->string_table;
+    uint32_t count = string_table()->count;
+    uint32_t other_count = other_table->count;
+    DynAllocUsage usage;
+    int64_t live;
+
+    ASSERT_NE(other, nullptr);
+
+    dynamic_set_context(ctx);
+    DyntypeString *str = new_string("owned");
+    ASSERT_TRUE(str->flags & DYN_STRING_FLAG_INTERNED);
+    dyn_allocator_get_usage(&((DynTypeContext *)ctx)->allocator, &usage);
+    live = usage.live_count[DynClassString];
+
+    /* released while the other context is current */
+    dynamic_set_context(other);
+    dyn_value_release((DynValue *)str);
+    EXPECT_EQ(string_table()->count, count);
+    EXPECT_EQ(other_table->count, other_count);
+    dyn_allocator_get_usage(&((DynTypeContext *)ctx)->allocator, &usage);
+    EXPECT_EQ(usage.live_count[DynClassString], live - 1);
+
+    dynamic_set_context(ctx);
+    dyntype_context_destroy(other);
+}
+
+TEST_F(DynStringTest, interned_eq_rope)
+{
+    std::string half(DYN_ROPE_MIN_LENGTH, 'a');
+    DyntypeString *left = new_string(half);
+    DyntypeString *rope = dyn_string_concat(left, left);
+    DyntypeString *slice, *interned;
+
+    EXPECT_TRUE(is_rope(rope));
+    slice = dyn_string_slice(rope, 0, 8);
+    interned = new_string("aaaaaaaa");
+
+    /* strings created by string operations are not interned */
+    EXPECT_FALSE(slice->flags & DYN_STRING_FLAG_INTERNED);
+    EXPECT_TRUE(interned->flags & DYN_STRING_FLAG_INTERNED);
+    EXPECT_NE(slice, interned);
+    EXPECT_TRUE(dyn_string_eq(slice, interned));
+    EXPECT_TRUE(dyn_string_eq(interned, slice));
+
+    dyn_value_release((DynValue *)left);
+    dyn_value_release((DynValue *)rope);
+    dyn_value_release((DynValue *)slice);
+    dyn_value_release((DynValue *)interned);
+}
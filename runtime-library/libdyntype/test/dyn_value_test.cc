@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "libdyntype_export.h"
+#include "pure_dynamic.h"
+extern "C" {
+#include "dyn_value.h"
+#include "type.h"
+}
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+class DynValueTest : public testing::Test
+{
+  protected:
+    virtual void SetUp() { ctx = dyntype_context_init(); }
+
+    virtual void TearDown() { dyntype_context_destroy(ctx); }
+
+    dyn_ctx_t ctx;
+};
+
+TEST_F(DynValueTest, number_round_trip)
+{
+    double check_values[] = { 0.0,
+                              -0.0,
+                              NAN,
+                              -NAN,
+                              INFINITY,
+                              -INFINITY,
+                              DBL_MIN,
+                              DBL_MIN / 2,
+                              -DBL_MIN / 2,
+                              4.9406564584124654e-324,
+                              -4.9406564584124654e-324,
+                              DBL_MAX,
+                              -DBL_MAX,
+                              1.0,
+                              -5.48 };
+
+    for (int i = 0; i < sizeof(check_values) / sizeof(check_values[0]); i++) {
+        double raw_number = 0;
+        DynValue *num = dyn_value_new_number(check_values[i]);
+        ASSERT_NE(num, nullptr);
+
+        EXPECT_TRUE(dynamic_is_number(ctx, num));
+        EXPECT_FALSE(dynamic_is_object(ctx, num));
+        EXPECT_EQ(dynamic_to_number(ctx, num, &raw_number), DYNTYPE_SUCCESS);
+
+        /* NaNs are canonicalized, everything else must keep its bits so
+         * that -0 and the subnormals survive the encoding */
+        if (std::isnan(check_values[i])) {
+            EXPECT_TRUE(std::isnan(raw_number));
+        }
+        else {
+            EXPECT_EQ(memcmp(&raw_number, &check_values[i], sizeof(double)),
+                      0);
+            EXPECT_EQ(std::signbit(raw_number),
+                      std::signbit(check_values[i]));
+        }
+
+        dynamic_release(ctx, num);
+    }
+}
+
+TEST_F(DynValueTest, slab_cache_kept_across_context_switch)
+{
+    dyn_ctx_t other = dyntype_context_init();
+    DynAllocator *allocators[] = { &((DynTypeContext *)ctx)->allocator,
+                                   &((DynTypeContext *)other)->allocator };
+    uint64_t reserved[2];
+    DynAllocUsage usage;
+
+    ASSERT_NE(other, nullptr);
+
+    for (int round = 0; round < 1000; round++) {
+        for (int i = 0; i < 2; i++) {
+            dyn_ctx_t cur = i == 0 ? ctx : other;
+
+            dynamic_set_context(cur);
+            dyntype_release(cur, dyntype_new_object(cur));
+        }
+
+        /* freed chunks are found again by the thread, no page is added */
+        for (int i = 0; i < 2; i++) {
+            dyn_allocator_get_usage(allocators[i], &usage);
+            if (round == 0) {
+                reserved[i] = usage.reserved_bytes;
+            }
+            EXPECT_EQ(usage.reserved_bytes, reserved[i]);
+        }
+    }
+
+    dynamic_set_context(ctx);
+    dyntype_context_destroy(other);
+}
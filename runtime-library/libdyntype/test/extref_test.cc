@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "libdyntype_export.h"
+#include "gc_export.h"
+extern "C" {
+#include "extref/extref.h"
+#include "wamr_utils.h"
+}
+#include <gtest/gtest.h>
+
+/*
+ * (module
+ *   (type $slots (array (mut anyref)))
+ *   (global (export "extref_slots") (mut (ref null $slots)) (ref.null none)))
+ */
+static unsigned char extref_app[] = {
+    0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00, 0x01, 0x04, 0x01,
+    0x5E, 0x6E, 0x01, 0x06, 0x07, 0x01, 0x63, 0x00, 0x01, 0xD0, 0x71,
+    0x0B, 0x07, 0x10, 0x01, 0x0C, 0x65, 0x78, 0x74, 0x72, 0x65, 0x66,
+    0x5F, 0x73, 0x6C, 0x6F, 0x74, 0x73, 0x03, 0x00,
+};
+
+class ExtRefTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        wasm_runtime_init();
+
+        ctx = dyntype_context_init();
+        dyntype_set_extref_release_callback(ctx, extref_release);
+
+        wasm_module = wasm_runtime_load(extref_app, sizeof(extref_app), NULL, 0);
+        ASSERT_TRUE(wasm_module != NULL);
+
+        module_inst =
+            wasm_runtime_instantiate(wasm_module, 8192, 1024, NULL, 0);
+        ASSERT_TRUE(module_inst != NULL);
+
+        exec_env = wasm_runtime_create_exec_env(module_inst, 4096);
+        ASSERT_TRUE(exec_env != NULL);
+
+        dyntype_context_set_exec_env(ctx, exec_env);
+    }
+
+    virtual void TearDown()
+    {
+        wamr_utils_destroy_extref_handles(ctx);
+        if (exec_env) {
+            wasm_runtime_destroy_exec_env(exec_env);
+        }
+        if (module_inst) {
+            wasm_runtime_deinstantiate(module_inst);
+        }
+        if (wasm_module) {
+            wasm_runtime_unload(wasm_module);
+        }
+        dyntype_context_destroy(ctx);
+    }
+
+    /* any wasm object stands for a closure, the cache only keys on it */
+    wasm_obj_t new_closure()
+    {
+        wasm_array_type_t type =
+            (wasm_array_type_t)wasm_get_defined_type(wasm_module, 0);
+        wasm_value_t init;
+
+        init.gc_obj = NULL;
+        return (wasm_obj_t)wasm_array_obj_new_with_type(exec_env, type, 1,
+                                                        &init);
+    }
+
+    dyn_ctx_t ctx;
+    wasm_module_t wasm_module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_exec_env_t exec_env = NULL;
+};
+
+TEST_F(ExtRefTest, func_wrapper_slots_bounded)
+{
+    for (int i = 0; i < 10000; i++) {
+        wasm_obj_t closure = new_closure();
+        ASSERT_TRUE(closure != NULL);
+
+        uint32_t handle = wamr_utils_new_extref_handle(exec_env, ctx, closure);
+        ASSERT_NE(handle, EXTREF_INVALID_HANDLE);
+        /* the slot of the previous closure has been freed and is reused */
+        EXPECT_EQ(handle & EXTREF_INDEX_MASK, 0u);
+
+        dyn_value_t wrapper = dyntype_new_extref(
+            ctx, (void *)(uintptr_t)handle, ExtFunc, (void *)exec_env);
+        ASSERT_TRUE(wrapper != NULL);
+        extref_set_func_wrapper(ctx, closure, wrapper);
+
+        dyn_value_t cached = extref_get_func_wrapper(ctx, closure);
+        ASSERT_TRUE(cached != NULL);
+        void *ref = NULL;
+        EXPECT_EQ(dyntype_to_extref(ctx, cached, &ref), ExtFunc);
+        EXPECT_EQ((uint32_t)(uintptr_t)ref, handle);
+        dyntype_release(ctx, cached);
+
+        /* the cache doesn't keep the wrapper, so the slot is freed with it */
+        dyntype_release(ctx, wrapper);
+        EXPECT_TRUE(wamr_utils_get_extref_obj(ctx, handle) == NULL);
+        EXPECT_TRUE(extref_get_func_wrapper(ctx, closure) == NULL);
+    }
+}
+
+TEST_F(ExtRefTest, func_wrapper_other_wrapper_kept)
+{
+    wasm_obj_t closure = new_closure();
+    ASSERT_TRUE(closure != NULL);
+
+    uint32_t handle1 = wamr_utils_new_extref_handle(exec_env, ctx, closure);
+    uint32_t handle2 = wamr_utils_new_extref_handle(exec_env, ctx, closure);
+    dyn_value_t wrapper1 = dyntype_new_extref(ctx, (void *)(uintptr_t)handle1,
+                                              ExtFunc, (void *)exec_env);
+    dyn_value_t wrapper2 = dyntype_new_extref(ctx, (void *)(uintptr_t)handle2,
+                                              ExtFunc, (void *)exec_env);
+    extref_set_func_wrapper(ctx, closure, wrapper1);
+
+    /* freeing a wrapper which isn't cached keeps the cached one */
+    dyntype_release(ctx, wrapper2);
+    dyn_value_t cached = extref_get_func_wrapper(ctx, closure);
+    ASSERT_TRUE(cached != NULL);
+    void *ref = NULL;
+    dyntype_to_extref(ctx, cached, &ref);
+    EXPECT_EQ((uint32_t)(uintptr_t)ref, handle1);
+    dyntype_release(ctx, cached);
+
+    dyntype_release(ctx, wrapper1);
+    EXPECT_TRUE(extref_get_func_wrapper(ctx, closure) == NULL);
+}
@@ -374,6 +374,45 @@ TEST_F(ObjectPropertyTest, object_set_and_delete_property)
 #endif
 }
 
+TEST_F(ObjectPropertyTest, object_property_atom)
+{
+    dyn_value_t obj = dyntype_new_object(ctx);
+    dyn_value_t num = dyntype_new_number(ctx, 100);
+    dyn_value_t boolean = dyntype_new_boolean(ctx, true);
+    dyn_atom_t prop1 = dyntype_new_atom(ctx, "prop1");
+    dyn_atom_t prop2 = dyntype_new_atom(ctx, "prop2");
+    dyn_value_t value;
+    double num_value;
+
+    EXPECT_NE(prop1, DYNTYPE_ATOM_NULL);
+    EXPECT_NE(prop2, DYNTYPE_ATOM_NULL);
+    EXPECT_NE(prop1, prop2);
+    EXPECT_EQ(dyntype_new_atom(ctx, "prop1"), prop1);
+
+    EXPECT_EQ(dyntype_set_property_atom(ctx, obj, prop1, num),
+              DYNTYPE_SUCCESS);
+    EXPECT_EQ(dyntype_set_property(ctx, obj, "prop2", boolean),
+              DYNTYPE_SUCCESS);
+
+    /* atoms and names address the same properties */
+    EXPECT_EQ(dyntype_has_property(ctx, obj, "prop1"), DYNTYPE_TRUE);
+    EXPECT_EQ(dyntype_has_property_atom(ctx, obj, prop1), DYNTYPE_TRUE);
+    EXPECT_EQ(dyntype_has_property_atom(ctx, obj, prop2), DYNTYPE_TRUE);
+
+    value = dyntype_get_property_atom(ctx, obj, prop1);
+    EXPECT_EQ(dyntype_to_number(ctx, value, &num_value), DYNTYPE_SUCCESS);
+    EXPECT_EQ(num_value, 100);
+    dyntype_release(ctx, value);
+
+    EXPECT_EQ(dyntype_delete_property_atom(ctx, obj, prop1), DYNTYPE_TRUE);
+    EXPECT_EQ(dyntype_has_property(ctx, obj, "prop1"), DYNTYPE_FALSE);
+    EXPECT_EQ(dyntype_has_property_atom(ctx, obj, prop1), DYNTYPE_FALSE);
+
+    dyntype_release(ctx, obj);
+    dyntype_release(ctx, num);
+    dyntype_release(ctx, boolean);
+}
+
 TEST_F(ObjectPropertyTest, object_define_and_delete_property)
 {
     dyn_value_t obj = dyntype_new_object(ctx);
@@ -610,7 +649,7 @@ TEST_F(ObjectPropertyTest, map_callback_test)
     exec_env = wasm_runtime_create_exec_env(module_inst, 4096);
     EXPECT_TRUE(exec_env != NULL);
 
-    dyntype_context_set_exec_env(exec_env);
+    dyntype_context_set_exec_env(ctx, exec_env);
 
     char str[] = { ' ', '\0' };
     dyn_value_t argv[10];
@@ -669,7 +708,7 @@ TEST_F(ObjectPropertyTest, map_callback_test)
     EXPECT_TRUE(dyntype_is_exception(ctx, ret));
     dyntype_release(ctx, ret);
 
-    dyntype_set_callback_dispatcher(test_callback_dispatcher);
+    dyntype_set_callback_dispatcher(ctx, test_callback_dispatcher);
     ret = dyntype_invoke(ctx, "forEach", obj, 1, argv);
     /* The forEach method should return undefined no matter what is returned by
      * the callback */
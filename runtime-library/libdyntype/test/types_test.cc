@@ -408,6 +408,65 @@ TEST_F(TypesTest, create_array)
 //     dyntype_release(ctx, extfunc);
 // }
 
+TEST_F(TypesTest, independent_contexts)
+{
+    dyn_ctx_t ctx2 = dyntype_context_init();
+    EXPECT_NE(ctx2, nullptr);
+    EXPECT_NE(ctx2, ctx);
+    /* the first context created on the thread stays the current one */
+    EXPECT_EQ(dyntype_get_context(), ctx);
+
+    dyntype_context_set_exec_env(ctx2, NULL);
+    EXPECT_EQ(dyntype_get_context(), ctx2);
+
+    dyn_value_t obj2 = dyntype_new_object(ctx2);
+    dyn_value_t num = dyntype_new_number(ctx2, 1);
+    dyntype_set_property(ctx2, obj2, "a", num);
+    dyntype_release(ctx2, num);
+
+    dyntype_context_set_exec_env(ctx, NULL);
+    EXPECT_EQ(dyntype_get_context(), ctx);
+
+    dyn_value_t obj = dyntype_new_object(ctx);
+    EXPECT_EQ(dyntype_has_property(ctx, obj, "a"), DYNTYPE_FALSE);
+    dyntype_release(ctx, obj);
+
+    dyntype_context_set_exec_env(ctx2, NULL);
+    EXPECT_EQ(dyntype_has_property(ctx2, obj2, "a"), DYNTYPE_TRUE);
+    dyntype_release(ctx2, obj2);
+    dyntype_context_destroy(ctx2);
+
+    dyntype_context_set_exec_env(ctx, NULL);
+}
+
+TEST_F(TypesTest, context_init_with_opt)
+{
+    dyn_options_t options = { 0 };
+    options.memory_limit = 64 * 1024 * 1024;
+    options.gc_threshold = 256 * 1024;
+    options.max_stack_size = 256 * 1024;
+    options.property_table_size = 1000;
+
+    dyn_ctx_t ctx2 = dyntype_context_init_with_opt(&options);
+    EXPECT_NE(ctx2, nullptr);
+    dyntype_context_set_exec_env(ctx2, NULL);
+
+    dyn_value_t obj = dyntype_new_object(ctx2);
+    char name[16];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(name, sizeof(name), "p%d", i);
+        dyn_value_t num = dyntype_new_number(ctx2, i);
+        dyntype_set_property(ctx2, obj, name, num);
+        dyntype_release(ctx2, num);
+    }
+    EXPECT_EQ(dyntype_has_property(ctx2, obj, "p999"), DYNTYPE_TRUE);
+
+    dyntype_release(ctx2, obj);
+    dyntype_context_destroy(ctx2);
+
+    dyntype_context_set_exec_env(ctx, NULL);
+}
+
 TEST_F(TypesTest, create_object)
 {
     dyn_value_t obj = dyntype_new_object(ctx);
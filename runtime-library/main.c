@@ -14,6 +14,8 @@
 #include "bh_read_file.h"
 #include "wasm_export.h"
 #include "libdyntype_export.h"
+#include "type_utils.h"
+#include "wamr_utils.h"
 
 extern uint32_t
 get_libdyntype_symbols(char **p_module_name, NativeSymbol **p_native_symbols);
@@ -35,6 +37,9 @@ dyntype_callback_wasm_dispatcher(void *exec_env_v, dyn_ctx_t ctx, void *vfunc,
                                  dyn_value_t this_obj, int argc,
                                  dyn_value_t *args);
 
+extern void
+extref_release(dyn_ctx_t ctx, void *ref, external_ref_tag tag);
+
 #if BH_HAS_DLFCN
 #include <dlfcn.h>
 #endif
@@ -80,6 +85,13 @@ print_help()
     printf("  --llvm-jit-size-level=n  Set LLVM JIT size level, default is 3\n");
     printf("  --llvm-jit-opt-level=n   Set LLVM JIT optimization level, default is 3\n");
 #endif
+    printf("  --dyn-memory-limit=n     Set maximum memory of dynamic values in bytes,\n"
+           "                           default is no limit\n");
+    printf("  --dyn-gc-threshold=n     Set the dynamic values GC threshold, in bytes\n"
+           "                           allocated for quickjs and in possible cycle\n"
+           "                           roots for the simple libdyntype\n");
+    printf("  --dyn-stack-size=n       Set maximum stack size of the js runtime in bytes\n");
+    printf("  --dyn-prop-table-size=n  Set the expected number of distinct property names\n");
     printf("  --repl                   Start a very simple REPL (read-eval-print-loop) mode\n"
            "                           that runs commands in the form of \"FUNC ARG...\"\n");
 #if WASM_ENABLE_LIBC_WASI != 0
@@ -429,6 +441,7 @@ main(int argc, char *argv[])
     wasm_module_inst_t wasm_module_inst = NULL;
     wasm_exec_env_t exec_env = NULL;
     wasm_function_inst_t start_func = NULL;
+    dyn_options_t dyn_options = { 0 };
     RunningMode running_mode = 0;
     RuntimeInitArgs init_args;
     char error_buf[128] = { 0 };
@@ -509,6 +522,26 @@ main(int argc, char *argv[])
                 return print_help();
             heap_size = atoi(argv[0] + 12);
         }
+        else if (!strncmp(argv[0], "--dyn-memory-limit=", 19)) {
+            if (argv[0][19] == '\0')
+                return print_help();
+            dyn_options.memory_limit = strtoull(argv[0] + 19, NULL, 10);
+        }
+        else if (!strncmp(argv[0], "--dyn-gc-threshold=", 19)) {
+            if (argv[0][19] == '\0')
+                return print_help();
+            dyn_options.gc_threshold = strtoull(argv[0] + 19, NULL, 10);
+        }
+        else if (!strncmp(argv[0], "--dyn-stack-size=", 17)) {
+            if (argv[0][17] == '\0')
+                return print_help();
+            dyn_options.max_stack_size = strtoull(argv[0] + 17, NULL, 10);
+        }
+        else if (!strncmp(argv[0], "--dyn-prop-table-size=", 22)) {
+            if (argv[0][22] == '\0')
+                return print_help();
+            dyn_options.property_table_size = atoi(argv[0] + 22);
+        }
 #if WASM_ENABLE_FAST_JIT != 0
         else if (!strncmp(argv[0], "--jit-codecache-size=", 21)) {
             if (argv[0][21] == '\0')
@@ -718,8 +751,13 @@ main(int argc, char *argv[])
     }
 
     /* initialize dyntype context and set callback dispatcher */
-    dyn_ctx = dyntype_context_init();
-    dyntype_set_callback_dispatcher(dyntype_callback_wasm_dispatcher);
+    dyn_ctx = dyntype_context_init_with_opt(&dyn_options);
+    if (!dyn_ctx) {
+        printf("Init dyntype context failed.\n");
+        goto fail1;
+    }
+    dyntype_set_callback_dispatcher(dyn_ctx, dyntype_callback_wasm_dispatcher);
+    dyntype_set_extref_release_callback(dyn_ctx, extref_release);
 
 #if WASM_ENABLE_LOG != 0
     bh_log_set_verbose_level(log_verbose_level);
@@ -824,10 +862,20 @@ main(int argc, char *argv[])
         goto fail3;
     }
 
+    if (!check_meta_version(wasm_module_inst)) {
+        printf("%s\n", "Mismatched meta version, please recompile the module");
+        goto fail4;
+    }
+
     exec_env = wasm_runtime_get_exec_env_singleton(wasm_module_inst);
     if (exec_env == NULL) {
         printf("%s\n", wasm_runtime_get_exception(wasm_module_inst));
     }
+    else {
+        /* bind the dyntype context to this instance */
+        wasm_runtime_set_user_data(exec_env, dyn_ctx);
+        dyntype_context_set_exec_env(dyn_ctx, exec_env);
+    }
 
 #if WASM_ENABLE_DEBUG_INTERP != 0
     if (ip_addr != NULL) {
@@ -878,6 +926,10 @@ main(int argc, char *argv[])
     execute_micro_tasks(exec_env, dyn_ctx);
 
 fail4:
+    /* the extrefs released after this don't refer to the instance */
+    dyntype_context_set_exec_env(dyn_ctx, NULL);
+    wamr_utils_destroy_extref_handles(dyn_ctx);
+
     /* destroy the module instance */
     wasm_runtime_deinstantiate(wasm_module_inst);
 
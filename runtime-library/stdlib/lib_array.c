@@ -11,10 +11,36 @@
 #include "libdyntype_export.h"
 #include "object_utils.h"
 #include "type_utils.h"
+#include <math.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 /* When growing an array, allocate more slots to avoid frequent allocation */
 #define ARRAY_GROW_REDUNDANCE 16
 
+/* Capacity to hold required elements, it grows by 1.5x at least so that
+ * appending n elements one by one copies O(n) elements in total */
+static uint32_t
+array_grow_capacity(uint32_t capacity, uint32_t required)
+{
+    uint64_t new_capacity = (uint64_t)capacity + (capacity >> 1);
+
+    if (new_capacity < (uint64_t)required + ARRAY_GROW_REDUNDANCE) {
+        new_capacity = (uint64_t)required + ARRAY_GROW_REDUNDANCE;
+    }
+    if (new_capacity > UINT32_MAX) {
+        new_capacity = required;
+    }
+
+    return (uint32_t)new_capacity;
+}
+
 double
 array_push_generic(wasm_exec_env_t exec_env, void *ctx, void *obj, void *value)
 {
@@ -35,7 +61,7 @@ array_push_generic(wasm_exec_env_t exec_env, void *ctx, void *obj, void *value)
         (wasm_array_type_t)wasm_obj_get_defined_type((wasm_obj_t)arr_ref);
     if (value_len >= capacity - len) {
         /* Current array space not enough, create new array */
-        uint32_t new_len = len + value_len + ARRAY_GROW_REDUNDANCE;
+        uint32_t new_len = array_grow_capacity(capacity, len + value_len);
         new_arr =
             wasm_array_obj_new_with_type(exec_env, arr_type, new_len, &init);
         if (!new_arr) {
@@ -132,7 +158,6 @@ array_concat_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     wasm_value_t init = { .gc_obj = NULL }, tmp_val = { 0 };
     wasm_local_obj_ref_t local_ref;
-    bool create_new_array = false;
 
     len = get_array_length(obj);
     value_len = get_array_length(value);
@@ -143,30 +168,20 @@ array_concat_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
     arr_type =
         (wasm_array_type_t)wasm_obj_get_defined_type((wasm_obj_t)arr_ref);
 
-    if (len == 0 && value_len != 0) {
-        new_arr = value_arr_ref;
-        new_length = value_len;
-    }
-    else if (len != 0 && value_len == 0) {
-        new_arr = arr_ref;
-        new_length = len;
+    /* always copy, the arrays are modified in place by push, shift, etc. */
+    new_length = len + value_len;
+    new_arr =
+        wasm_array_obj_new_with_type(exec_env, arr_type, new_length, &init);
+    if (!new_arr) {
+        wasm_runtime_set_exception(module_inst, "alloc memory failed");
+        return NULL;
     }
-    else {
-        new_length = len + value_len;
-        new_arr =
-            wasm_array_obj_new_with_type(exec_env, arr_type, new_length, &init);
-        if (!new_arr) {
-            wasm_runtime_set_exception(module_inst, "alloc memory failed");
-            return NULL;
-        }
 
-        wasm_runtime_push_local_obj_ref(exec_env, &local_ref);
-        local_ref.val = (wasm_obj_t)new_arr;
-        create_new_array = true;
+    wasm_runtime_push_local_obj_ref(exec_env, &local_ref);
+    local_ref.val = (wasm_obj_t)new_arr;
 
-        wasm_array_obj_copy(new_arr, 0, arr_ref, 0, len);
-        wasm_array_obj_copy(new_arr, len, value_arr_ref, 0, value_len);
-    }
+    wasm_array_obj_copy(new_arr, 0, arr_ref, 0, len);
+    wasm_array_obj_copy(new_arr, len, value_arr_ref, 0, value_len);
 
     /* wrap with struct */
     new_arr_struct = wasm_struct_obj_new_with_type(exec_env, struct_type);
@@ -182,9 +197,7 @@ array_concat_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
     wasm_struct_obj_set_field(new_arr_struct, 1, &tmp_val);
 
 fail:
-    if (create_new_array) {
-        wasm_runtime_pop_local_obj_ref(exec_env);
-    }
+    wasm_runtime_pop_local_obj_ref(exec_env);
 
     return new_arr_struct;
 }
@@ -210,38 +223,28 @@ array_reverse_generic(wasm_exec_env_t exec_env, void *ctx, void *obj)
     return obj;
 }
 
-/* Delete and return the first element of the array */
+/* Delete and return the first element of the array, the elements are moved
+ * in place so the capacity is kept for following push/unshift */
 #define ARRAY_SHIFT_API(return_type, wasm_type, wasm_field)                    \
     return_type array_shift_##wasm_type(wasm_exec_env_t exec_env, void *ctx,   \
                                         void *obj)                             \
     {                                                                          \
         uint32_t len;                                                          \
-        return_type res;                                                       \
-        wasm_array_type_t arr_type;                                            \
-        wasm_array_obj_t new_arr;                                              \
+        return_type res = 0;                                                   \
         wasm_array_obj_t arr_ref = get_array_ref(obj);                         \
-        wasm_module_inst_t module_inst =                                       \
-            wasm_runtime_get_module_inst(exec_env);                            \
-        wasm_value_t init = { .gc_obj = NULL }, tmp_val = { 0 },               \
-                     value = { 0 };                                            \
+        wasm_value_t init = { .gc_obj = NULL }, value = { 0 };                 \
                                                                                \
         len = get_array_length(obj);                                           \
-        arr_type =                                                             \
-            (wasm_array_type_t)wasm_obj_get_defined_type((wasm_obj_t)arr_ref); \
         if (len == 0) {                                                        \
             wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env), \
                                        "array is empty:undefined");            \
+            return res;                                                        \
         }                                                                      \
         wasm_array_obj_get_elem(arr_ref, 0, false, &value);                    \
         res = value.wasm_field;                                                \
-        new_arr =                                                              \
-            wasm_array_obj_new_with_type(exec_env, arr_type, len - 1, &init);  \
-        if (!new_arr) {                                                        \
-            wasm_runtime_set_exception(module_inst, "alloc memory failed");    \
-        }                                                                      \
-        wasm_array_obj_copy(new_arr, 0, arr_ref, 1, len - 1);                  \
-        tmp_val.gc_obj = (wasm_obj_t)new_arr;                                  \
-        wasm_struct_obj_set_field(obj, 0, &tmp_val);                           \
+        wasm_array_obj_copy(arr_ref, 0, arr_ref, 1, len - 1);                  \
+        /* don't keep the moved out reference alive */                         \
+        wasm_array_obj_set_elem(arr_ref, len - 1, &init);                      \
         value.u32 = len - 1;                                                   \
         wasm_struct_obj_set_field(obj, 1, &value);                             \
         return res;                                                            \
@@ -330,105 +333,811 @@ end:
     return new_arr_struct;
 }
 
-void
-quick_sort(wasm_exec_env_t exec_env, wasm_array_obj_t arr, int l, int r,
-           void *closure)
+/* Array.prototype.sort is a TimSort: natural runs extended to a minimum
+ * length by binary insertion, merged with galloping. It is stable, doesn't
+ * recurse, and calls the comparator O(log n) times per element */
+#define SORT_MIN_MERGE 64
+#define SORT_MIN_GALLOP 7
+#define SORT_MAX_RUNS 64
+
+typedef struct SortRun {
+    int base;
+    int len;
+} SortRun;
+
+typedef struct SortContext {
+    wasm_exec_env_t exec_env;
+    wasm_array_obj_t arr;
+    /* holds the elements of the shorter run while merging */
+    wasm_array_obj_t tmp;
+    wasm_func_obj_t func;
+    /* context and thiz, overwritten by the result of every call */
+    uint32_t env_argv[4];
+    uint32_t argv[8];
+    uint32_t argc;
+    uint32_t elem_offset;
+    uint32_t elem_slot;
+    int min_gallop;
+    int run_count;
+    SortRun runs[SORT_MAX_RUNS];
+    /* the comparator threw, the remaining elements compare equal */
+    bool failed;
+} SortContext;
+
+/* Less than according to the comparator, NaN means equal */
+static bool
+sort_less(SortContext *sc, const wasm_value_t *a, const wasm_value_t *b)
 {
-    int i = l - 1, j = r + 1, pivot_idx = (l + r) >> 1;
+    uint32_t elem_bytes = sc->elem_slot * sizeof(uint32);
     double cmp_res;
-    wasm_value_t pivot_elem, elem, tmp_elem, left_elem, right_elem;
-    uint32_t argv[8], argc = 0, occupied_slots = 0;
-    uint32_t argv_bytes = sizeof(argv),
-             pointer_slots = sizeof(void *) / sizeof(uint32);
-    uint32_t elem_size, elem_slot;
-    wasm_func_obj_t func = { 0 };
-
-    if (l >= r)
-        return;
 
-    GET_ELEM_FROM_CLOSURE(closure);
-    func = (wasm_func_obj_t)func_obj.gc_obj;
-
-    elem_size = 1 << wasm_array_obj_elem_size_log(arr);
-    elem_slot = (elem_size + sizeof(uint32) - 1) / sizeof(uint32);
-    wasm_array_obj_get_elem(arr, pivot_idx, false, &pivot_elem);
-
-    /* context */
-    argc += pointer_slots;
-    /* thiz */
-    argc += pointer_slots;
-    /* pivot elem */
-    argc += elem_slot;
-    /* elem */
-    argc += elem_slot;
-
-    while (i < j) {
+    if (sc->failed) {
+        return false;
+    }
+
+    bh_memcpy_s(sc->argv, sizeof(sc->argv), sc->env_argv, sizeof(double));
+    bh_memcpy_s(sc->argv + sc->elem_offset,
+                sizeof(sc->argv) - sc->elem_offset * sizeof(uint32), a,
+                elem_bytes);
+    bh_memcpy_s(sc->argv + sc->elem_offset + sc->elem_slot,
+                sizeof(sc->argv)
+                    - (sc->elem_offset + sc->elem_slot) * sizeof(uint32),
+                b, elem_bytes);
+
+    if (!wasm_runtime_call_func_ref(sc->exec_env, sc->func, sc->argc,
+                                    sc->argv)) {
+        sc->failed = true;
+        return false;
+    }
+
+    bh_memcpy_s(&cmp_res, sizeof(cmp_res), sc->argv, sizeof(double));
+    return cmp_res < 0.0;
+}
+
+static inline void
+sort_move(wasm_array_obj_t dst, int dst_idx, wasm_array_obj_t src,
+          int src_idx)
+{
+    wasm_value_t elem;
+
+    wasm_array_obj_get_elem(src, src_idx, false, &elem);
+    wasm_array_obj_set_elem(dst, dst_idx, &elem);
+}
+
+/* Sort [lo, hi) whose prefix [lo, start) is already sorted */
+static void
+binary_insertion_sort(SortContext *sc, int lo, int hi, int start)
+{
+    wasm_array_obj_t arr = sc->arr;
+    wasm_value_t pivot, elem;
+    int left, right, mid;
+
+    for (; start < hi; start++) {
+        wasm_array_obj_get_elem(arr, start, false, &pivot);
+        left = lo;
+        right = start;
+        while (left < right) {
+            mid = left + ((right - left) >> 1);
+            wasm_array_obj_get_elem(arr, mid, false, &elem);
+            if (sort_less(sc, &pivot, &elem)) {
+                right = mid;
+            }
+            else {
+                left = mid + 1;
+            }
+        }
+        if (left < start) {
+            wasm_array_obj_copy(arr, left + 1, arr, left, start - left);
+            wasm_array_obj_set_elem(arr, left, &pivot);
+        }
+    }
+}
+
+/* Length of the run starting at lo, a strictly descending run is reversed
+ * in place so the order of equal elements is kept */
+static int
+count_run(SortContext *sc, int lo, int hi)
+{
+    wasm_array_obj_t arr = sc->arr;
+    wasm_value_t prev, elem;
+    int i, j, run = lo + 1;
+
+    if (run == hi) {
+        return 1;
+    }
+
+    wasm_array_obj_get_elem(arr, lo, false, &prev);
+    wasm_array_obj_get_elem(arr, run, false, &elem);
+    if (sort_less(sc, &elem, &prev)) {
+        for (run++; run < hi; run++) {
+            prev = elem;
+            wasm_array_obj_get_elem(arr, run, false, &elem);
+            if (!sort_less(sc, &elem, &prev)) {
+                break;
+            }
+        }
+        for (i = lo, j = run - 1; i < j; i++, j--) {
+            wasm_array_obj_get_elem(arr, i, false, &prev);
+            sort_move(arr, i, arr, j);
+            wasm_array_obj_set_elem(arr, j, &prev);
+        }
+    }
+    else {
+        for (run++; run < hi; run++) {
+            prev = elem;
+            wasm_array_obj_get_elem(arr, run, false, &elem);
+            if (sort_less(sc, &elem, &prev)) {
+                break;
+            }
+        }
+    }
+
+    return run - lo;
+}
+
+/* Position to insert key into the sorted a[base, base + n), before the
+ * elements equal to it. The search starts from a[base + hint] */
+static int
+gallop_left(SortContext *sc, const wasm_value_t *key, wasm_array_obj_t a,
+            int base, int n, int hint)
+{
+    wasm_value_t elem;
+    int ofs = 1, last_ofs = 0, max_ofs, k, m;
+
+    wasm_array_obj_get_elem(a, base + hint, false, &elem);
+    if (sort_less(sc, &elem, key)) {
+        /* a[hint] < key, gallop right */
+        max_ofs = n - hint;
+        while (ofs < max_ofs) {
+            wasm_array_obj_get_elem(a, base + hint + ofs, false, &elem);
+            if (!sort_less(sc, &elem, key)) {
+                break;
+            }
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) {
+                ofs = max_ofs;
+            }
+        }
+        if (ofs > max_ofs) {
+            ofs = max_ofs;
+        }
+        last_ofs += hint;
+        ofs += hint;
+    }
+    else {
+        /* key <= a[hint], gallop left */
+        max_ofs = hint + 1;
+        while (ofs < max_ofs) {
+            wasm_array_obj_get_elem(a, base + hint - ofs, false, &elem);
+            if (sort_less(sc, &elem, key)) {
+                break;
+            }
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) {
+                ofs = max_ofs;
+            }
+        }
+        if (ofs > max_ofs) {
+            ofs = max_ofs;
+        }
+        k = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - k;
+    }
+
+    /* a[last_ofs] < key <= a[ofs], binary search in between */
+    last_ofs++;
+    while (last_ofs < ofs) {
+        m = last_ofs + ((ofs - last_ofs) >> 1);
+        wasm_array_obj_get_elem(a, base + m, false, &elem);
+        if (sort_less(sc, &elem, key)) {
+            last_ofs = m + 1;
+        }
+        else {
+            ofs = m;
+        }
+    }
+
+    return ofs;
+}
+
+/* Same as gallop_left, but after the elements equal to key */
+static int
+gallop_right(SortContext *sc, const wasm_value_t *key, wasm_array_obj_t a,
+             int base, int n, int hint)
+{
+    wasm_value_t elem;
+    int ofs = 1, last_ofs = 0, max_ofs, k, m;
+
+    wasm_array_obj_get_elem(a, base + hint, false, &elem);
+    if (sort_less(sc, key, &elem)) {
+        /* key < a[hint], gallop left */
+        max_ofs = hint + 1;
+        while (ofs < max_ofs) {
+            wasm_array_obj_get_elem(a, base + hint - ofs, false, &elem);
+            if (!sort_less(sc, key, &elem)) {
+                break;
+            }
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) {
+                ofs = max_ofs;
+            }
+        }
+        if (ofs > max_ofs) {
+            ofs = max_ofs;
+        }
+        k = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - k;
+    }
+    else {
+        /* a[hint] <= key, gallop right */
+        max_ofs = n - hint;
+        while (ofs < max_ofs) {
+            wasm_array_obj_get_elem(a, base + hint + ofs, false, &elem);
+            if (sort_less(sc, key, &elem)) {
+                break;
+            }
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) {
+                ofs = max_ofs;
+            }
+        }
+        if (ofs > max_ofs) {
+            ofs = max_ofs;
+        }
+        last_ofs += hint;
+        ofs += hint;
+    }
+
+    /* a[last_ofs] <= key < a[ofs], binary search in between */
+    last_ofs++;
+    while (last_ofs < ofs) {
+        m = last_ofs + ((ofs - last_ofs) >> 1);
+        wasm_array_obj_get_elem(a, base + m, false, &elem);
+        if (sort_less(sc, key, &elem)) {
+            ofs = m;
+        }
+        else {
+            last_ofs = m + 1;
+        }
+    }
+
+    return ofs;
+}
+
+/* Merge the adjacent runs in place, len1 <= len2, the first element of run2
+ * is less than run1[0] and the last one of run1 is greater than all of run2.
+ * Every element stays reachable from arr or tmp while the comparator runs */
+static void
+merge_lo(SortContext *sc, int base1, int len1, int base2, int len2)
+{
+    wasm_array_obj_t arr = sc->arr, tmp = sc->tmp;
+    wasm_value_t elem1, elem2;
+    int dest = base1, cursor1 = 0, cursor2 = base2;
+    int count1, count2, k, min_gallop = sc->min_gallop;
+
+    wasm_array_obj_copy(tmp, 0, arr, base1, len1);
+
+    sort_move(arr, dest++, arr, cursor2++);
+    if (--len2 == 0) {
+        goto done;
+    }
+    if (len1 == 1) {
+        goto last_one;
+    }
+
+    for (;;) {
+        count1 = count2 = 0;
+
+        /* one at a time until a run wins consistently */
+        do {
+            wasm_array_obj_get_elem(arr, cursor2, false, &elem2);
+            wasm_array_obj_get_elem(tmp, cursor1, false, &elem1);
+            if (sort_less(sc, &elem2, &elem1)) {
+                wasm_array_obj_set_elem(arr, dest++, &elem2);
+                cursor2++;
+                count2++;
+                count1 = 0;
+                if (--len2 == 0) {
+                    goto done;
+                }
+            }
+            else {
+                wasm_array_obj_set_elem(arr, dest++, &elem1);
+                cursor1++;
+                count1++;
+                count2 = 0;
+                if (--len1 == 1) {
+                    goto last_one;
+                }
+            }
+        } while ((count1 | count2) < min_gallop);
+
+        /* galloping, move the elements in chunks */
+        min_gallop++;
+        do {
+            min_gallop -= min_gallop > 1;
+            sc->min_gallop = min_gallop;
+
+            wasm_array_obj_get_elem(arr, cursor2, false, &elem2);
+            k = count1 = gallop_right(sc, &elem2, tmp, cursor1, len1, 0);
+            if (k) {
+                wasm_array_obj_copy(arr, dest, tmp, cursor1, k);
+                dest += k;
+                cursor1 += k;
+                len1 -= k;
+                if (len1 == 1) {
+                    goto last_one;
+                }
+                /* only with an inconsistent comparator */
+                if (len1 == 0) {
+                    goto done;
+                }
+            }
+            sort_move(arr, dest++, arr, cursor2++);
+            if (--len2 == 0) {
+                goto done;
+            }
+
+            wasm_array_obj_get_elem(tmp, cursor1, false, &elem1);
+            k = count2 = gallop_left(sc, &elem1, arr, cursor2, len2, 0);
+            if (k) {
+                wasm_array_obj_copy(arr, dest, arr, cursor2, k);
+                dest += k;
+                cursor2 += k;
+                len2 -= k;
+                if (len2 == 0) {
+                    goto done;
+                }
+            }
+            sort_move(arr, dest++, tmp, cursor1++);
+            if (--len1 == 1) {
+                goto last_one;
+            }
+        } while (count1 >= SORT_MIN_GALLOP || count2 >= SORT_MIN_GALLOP);
+        min_gallop++;
+        sc->min_gallop = min_gallop;
+    }
+
+done:
+    if (len1) {
+        wasm_array_obj_copy(arr, dest, tmp, cursor1, len1);
+    }
+    return;
+
+last_one:
+    /* the last element of run1 is greater than the rest of run2 */
+    wasm_array_obj_copy(arr, dest, arr, cursor2, len2);
+    sort_move(arr, dest + len2, tmp, cursor1);
+}
+
+/* Same as merge_lo but merges from the end, len1 >= len2 */
+static void
+merge_hi(SortContext *sc, int base1, int len1, int base2, int len2)
+{
+    wasm_array_obj_t arr = sc->arr, tmp = sc->tmp;
+    wasm_value_t elem1, elem2;
+    int dest = base2 + len2 - 1, cursor1 = base1 + len1 - 1,
+        cursor2 = len2 - 1;
+    int count1, count2, k, min_gallop = sc->min_gallop;
+
+    wasm_array_obj_copy(tmp, 0, arr, base2, len2);
+
+    sort_move(arr, dest--, arr, cursor1--);
+    if (--len1 == 0) {
+        goto done;
+    }
+    if (len2 == 1) {
+        goto first_one;
+    }
+
+    for (;;) {
+        count1 = count2 = 0;
+
         do {
-            occupied_slots = 0;
-            i++;
-            POPULATE_ENV_ARGS(argv, argv_bytes, occupied_slots, context, thiz);
-            /* arg2: pivot elem */
-            bh_memcpy_s(argv + occupied_slots,
-                        argv_bytes - occupied_slots * sizeof(uint32),
-                        &pivot_elem.gc_obj, elem_slot * sizeof(uint32));
-            occupied_slots += elem_slot;
-            /* arg3: elem*/
-            wasm_array_obj_get_elem(arr, i, false, &elem);
-            bh_memcpy_s(argv + occupied_slots,
-                        argv_bytes - occupied_slots * sizeof(uint32),
-                        &elem.gc_obj, elem_slot * sizeof(uint32));
-            occupied_slots += elem_slot;
-
-            wasm_runtime_call_func_ref(exec_env, func, argc, argv);
-
-            bh_memcpy_s(&cmp_res, sizeof(cmp_res), argv, sizeof(double));
-        } while ((i < j) && (cmp_res > 0.0));
+            wasm_array_obj_get_elem(tmp, cursor2, false, &elem2);
+            wasm_array_obj_get_elem(arr, cursor1, false, &elem1);
+            if (sort_less(sc, &elem2, &elem1)) {
+                wasm_array_obj_set_elem(arr, dest--, &elem1);
+                cursor1--;
+                count1++;
+                count2 = 0;
+                if (--len1 == 0) {
+                    goto done;
+                }
+            }
+            else {
+                wasm_array_obj_set_elem(arr, dest--, &elem2);
+                cursor2--;
+                count2++;
+                count1 = 0;
+                if (--len2 == 1) {
+                    goto first_one;
+                }
+            }
+        } while ((count1 | count2) < min_gallop);
 
+        min_gallop++;
         do {
-            occupied_slots = 0;
-            j--;
-
-            POPULATE_ENV_ARGS(argv, argv_bytes, occupied_slots, context, thiz);
-            /* arg2: pivot elem*/
-            bh_memcpy_s(argv + occupied_slots,
-                        argv_bytes - occupied_slots * sizeof(uint32),
-                        &pivot_elem.gc_obj, elem_slot * sizeof(uint32));
-            occupied_slots += elem_slot;
-            /* arg3: elem*/
-            wasm_array_obj_get_elem(arr, j, false, &elem);
-            bh_memcpy_s(argv + occupied_slots,
-                        argv_bytes - occupied_slots * sizeof(uint32),
-                        &elem.gc_obj, elem_slot * sizeof(uint32));
-            occupied_slots += elem_slot;
-
-            wasm_runtime_call_func_ref(exec_env, func, argc, argv);
-
-            bh_memcpy_s(&cmp_res, sizeof(cmp_res), argv, sizeof(double));
-        } while ((i < j) && (cmp_res < 0.0));
-
-        if (i < j) {
-            wasm_array_obj_get_elem(arr, i, false, &left_elem);
-            wasm_array_obj_get_elem(arr, j, false, &right_elem);
-            tmp_elem = left_elem;
-            wasm_array_obj_set_elem(arr, i, &right_elem);
-            wasm_array_obj_set_elem(arr, j, &tmp_elem);
+            min_gallop -= min_gallop > 1;
+            sc->min_gallop = min_gallop;
+
+            wasm_array_obj_get_elem(tmp, cursor2, false, &elem2);
+            k = gallop_right(sc, &elem2, arr, base1, len1, len1 - 1);
+            k = count1 = len1 - k;
+            if (k) {
+                dest -= k;
+                cursor1 -= k;
+                wasm_array_obj_copy(arr, dest + 1, arr, cursor1 + 1, k);
+                len1 -= k;
+                if (len1 == 0) {
+                    goto done;
+                }
+            }
+            sort_move(arr, dest--, tmp, cursor2--);
+            if (--len2 == 1) {
+                goto first_one;
+            }
+
+            wasm_array_obj_get_elem(arr, cursor1, false, &elem1);
+            k = gallop_left(sc, &elem1, tmp, 0, len2, len2 - 1);
+            k = count2 = len2 - k;
+            if (k) {
+                dest -= k;
+                cursor2 -= k;
+                wasm_array_obj_copy(arr, dest + 1, tmp, cursor2 + 1, k);
+                len2 -= k;
+                if (len2 == 1) {
+                    goto first_one;
+                }
+                /* only with an inconsistent comparator */
+                if (len2 == 0) {
+                    goto done;
+                }
+            }
+            sort_move(arr, dest--, arr, cursor1--);
+            if (--len1 == 0) {
+                goto done;
+            }
+        } while (count1 >= SORT_MIN_GALLOP || count2 >= SORT_MIN_GALLOP);
+        min_gallop++;
+        sc->min_gallop = min_gallop;
+    }
+
+done:
+    if (len2) {
+        wasm_array_obj_copy(arr, dest - len2 + 1, tmp, 0, len2);
+    }
+    return;
+
+first_one:
+    /* the first element of run2 is less than the rest of run1 */
+    dest -= len1;
+    cursor1 -= len1;
+    wasm_array_obj_copy(arr, dest + 1, arr, cursor1 + 1, len1);
+    sort_move(arr, dest, tmp, cursor2);
+}
+
+/* Merge the runs i and i + 1 of the stack */
+static void
+merge_at(SortContext *sc, int i)
+{
+    wasm_array_obj_t arr = sc->arr;
+    wasm_value_t elem;
+    int base1 = sc->runs[i].base, len1 = sc->runs[i].len;
+    int base2 = sc->runs[i + 1].base, len2 = sc->runs[i + 1].len;
+    int k;
+
+    sc->runs[i].len = len1 + len2;
+    if (i == sc->run_count - 3) {
+        sc->runs[i + 1] = sc->runs[i + 2];
+    }
+    sc->run_count--;
+
+    /* elements of run1 before run2[0] are already in place */
+    wasm_array_obj_get_elem(arr, base2, false, &elem);
+    k = gallop_right(sc, &elem, arr, base1, len1, 0);
+    base1 += k;
+    len1 -= k;
+    if (len1 == 0) {
+        return;
+    }
+
+    /* elements of run2 after the last of run1 are already in place */
+    wasm_array_obj_get_elem(arr, base1 + len1 - 1, false, &elem);
+    len2 = gallop_left(sc, &elem, arr, base2, len2, len2 - 1);
+    if (len2 == 0) {
+        return;
+    }
+
+    if (len1 <= len2) {
+        merge_lo(sc, base1, len1, base2, len2);
+    }
+    else {
+        merge_hi(sc, base1, len1, base2, len2);
+    }
+}
+
+/* Keep the run lengths decreasing faster than the Fibonacci numbers, which
+ * bounds the stack depth */
+static void
+merge_collapse(SortContext *sc)
+{
+    SortRun *runs = sc->runs;
+    int n;
+
+    while (sc->run_count > 1) {
+        n = sc->run_count - 2;
+        if ((n > 0 && runs[n - 1].len <= runs[n].len + runs[n + 1].len)
+            || (n > 1 && runs[n - 2].len <= runs[n - 1].len + runs[n].len)) {
+            if (runs[n - 1].len < runs[n + 1].len) {
+                n--;
+            }
         }
+        else if (runs[n].len > runs[n + 1].len) {
+            break;
+        }
+        merge_at(sc, n);
     }
+}
+
+static void
+merge_force_collapse(SortContext *sc)
+{
+    SortRun *runs = sc->runs;
+    int n;
 
-    quick_sort(exec_env, arr, l, j, closure);
-    quick_sort(exec_env, arr, j + 1, r, closure);
+    while (sc->run_count > 1) {
+        n = sc->run_count - 2;
+        if (n > 0 && runs[n - 1].len < runs[n + 1].len) {
+            n--;
+        }
+        merge_at(sc, n);
+    }
+}
+
+static int
+compute_min_run(int n)
+{
+    int r = 0;
+
+    while (n >= SORT_MIN_MERGE) {
+        r |= n & 1;
+        n >>= 1;
+    }
+
+    return n + r;
 }
 
 void *
 array_sort_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
                    void *closure)
+{
+    int len, lo = 0, min_run, run_len, force;
+    wasm_array_obj_t arr_ref = get_array_ref(obj);
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    wasm_value_t init = { .gc_obj = NULL };
+    wasm_local_obj_ref_t local_ref;
+    SortContext sc = { 0 };
+    uint32_t occupied_slots = 0, elem_size;
+
+    len = (int)get_array_length(obj);
+    if (len < 2) {
+        return obj;
+    }
+
+    GET_ELEM_FROM_CLOSURE(closure);
+
+    sc.exec_env = exec_env;
+    sc.arr = arr_ref;
+    sc.func = (wasm_func_obj_t)func_obj.gc_obj;
+    sc.min_gallop = SORT_MIN_GALLOP;
+
+    /* the arguments are formatted once, only the elements change */
+    POPULATE_ENV_ARGS(sc.env_argv, sizeof(sc.env_argv), occupied_slots,
+                      context, thiz);
+    bh_memcpy_s(sc.argv, sizeof(sc.argv), sc.env_argv,
+                occupied_slots * sizeof(uint32));
+    elem_size = 1 << wasm_array_obj_elem_size_log(arr_ref);
+    sc.elem_offset = occupied_slots;
+    sc.elem_slot = (elem_size + sizeof(uint32) - 1) / sizeof(uint32);
+    sc.argc = occupied_slots + sc.elem_slot * 2;
+
+    min_run = compute_min_run(len);
+    if (min_run < len) {
+        /* merging needs at most half of the elements */
+        sc.tmp = wasm_array_obj_new_with_type(
+            exec_env,
+            (wasm_array_type_t)wasm_obj_get_defined_type((wasm_obj_t)arr_ref),
+            len / 2 + 1, &init);
+        if (!sc.tmp) {
+            wasm_runtime_set_exception(module_inst, "alloc memory failed");
+            return obj;
+        }
+        wasm_runtime_push_local_obj_ref(exec_env, &local_ref);
+        local_ref.val = (wasm_obj_t)sc.tmp;
+    }
+
+    while (lo < len && !sc.failed) {
+        run_len = count_run(&sc, lo, len);
+        if (run_len < min_run) {
+            force = len - lo < min_run ? len - lo : min_run;
+            binary_insertion_sort(&sc, lo, lo + force, lo + run_len);
+            run_len = force;
+        }
+
+        sc.runs[sc.run_count].base = lo;
+        sc.runs[sc.run_count].len = run_len;
+        sc.run_count++;
+        merge_collapse(&sc);
+        lo += run_len;
+    }
+
+    /* after a throw the runs are still permutations, leave them unmerged */
+    if (!sc.failed) {
+        merge_force_collapse(&sc);
+    }
+
+    if (sc.tmp) {
+        wasm_runtime_pop_local_obj_ref(exec_env);
+    }
+
+    return obj;
+}
+
+/* Sort with the canonical (a, b) => a - b or b - a comparator, the compiler
+ * calls this instead of array_sort_generic. It is a stable LSD radix sort on
+ * order preserving keys, so elements comparing equal (like -0 and +0) keep
+ * their order as with the comparator.
+ * NaNs are placed last. This differs from the comparator path: there a NaN
+ * compares equal to every element, so where the NaNs end up depends on the
+ * runs found by the TimSort */
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_MIN_LEN 64
+
+static inline uint32_t
+i32_sort_key(int32_t value, bool descending)
+{
+    uint32_t key = (uint32_t)value ^ 0x80000000u;
+
+    return descending ? ~key : key;
+}
+
+static inline uint64_t
+f64_sort_key(double value, bool descending)
+{
+    uint64_t key;
+
+    if (value != value) {
+        return UINT64_MAX;
+    }
+    if (value == 0) {
+        /* -0 equals +0 */
+        value = 0;
+    }
+
+    bh_memcpy_s(&key, sizeof(key), &value, sizeof(value));
+    key = (key >> 63) ? ~key : key | ((uint64_t)1 << 63);
+    /* NaNs stay last when descending as ~key is never UINT64_MAX */
+    return descending ? ~key : key;
+}
+
+#define DEFINE_RADIX_SORT(elem_type, key_type, key_func)                      \
+    static bool radix_sort_##elem_type(elem_type *data, uint32_t len,         \
+                                       bool descending)                       \
+    {                                                                         \
+        uint32_t counts[sizeof(key_type)][RADIX_SIZE] = { 0 };                \
+        uint32_t i, j, pass, shift, offset, count, *digit_counts;             \
+        elem_type *src = data, *dst, *buf, *swap, tmp;                        \
+        key_type key, first_key;                                              \
+                                                                              \
+        if (len < RADIX_MIN_LEN) {                                            \
+            /* stable insertion sort */                                       \
+            for (i = 1; i < len; i++) {                                       \
+                tmp = data[i];                                                \
+                key = key_func(tmp, descending);                              \
+                for (j = i; j > 0 && key_func(data[j - 1], descending) > key; \
+                     j--) {                                                   \
+                    data[j] = data[j - 1];                                    \
+                }                                                             \
+                data[j] = tmp;                                                \
+            }                                                                 \
+            return true;                                                      \
+        }                                                                     \
+                                                                              \
+        if (!(buf = wasm_runtime_malloc(sizeof(elem_type) * len))) {          \
+            return false;                                                     \
+        }                                                                     \
+        dst = buf;                                                            \
+                                                                              \
+        /* histograms of all the digits in one pass */                        \
+        for (i = 0; i < len; i++) {                                           \
+            key = key_func(data[i], descending);                              \
+            for (pass = 0; pass < sizeof(key_type); pass++) {                 \
+                shift = pass * RADIX_BITS;                                    \
+                counts[pass][(key >> shift) & (RADIX_SIZE - 1)]++;            \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        first_key = key_func(data[0], descending);                            \
+        for (pass = 0; pass < sizeof(key_type); pass++) {                     \
+            digit_counts = counts[pass];                                      \
+            shift = pass * RADIX_BITS;                                        \
+                                                                              \
+            /* all the keys share this digit */                               \
+            if (digit_counts[(first_key >> shift) & (RADIX_SIZE - 1)]         \
+                == len) {                                                     \
+                continue;                                                     \
+            }                                                                 \
+                                                                              \
+            for (i = 0, offset = 0; i < RADIX_SIZE; i++) {                    \
+                count = digit_counts[i];                                      \
+                digit_counts[i] = offset;                                     \
+                offset += count;                                              \
+            }                                                                 \
+            for (i = 0; i < len; i++) {                                       \
+                key = key_func(src[i], descending);                           \
+                dst[digit_counts[(key >> shift) & (RADIX_SIZE - 1)]++] =      \
+                    src[i];                                                   \
+            }                                                                 \
+                                                                              \
+            swap = src;                                                       \
+            src = dst;                                                        \
+            dst = swap;                                                       \
+        }                                                                     \
+                                                                              \
+        if (src != data) {                                                    \
+            bh_memcpy_s(data, sizeof(elem_type) * len, src,                   \
+                        sizeof(elem_type) * len);                             \
+        }                                                                     \
+        wasm_runtime_free(buf);                                               \
+        return true;                                                          \
+    }
+
+DEFINE_RADIX_SORT(int32_t, uint32_t, i32_sort_key)
+DEFINE_RADIX_SORT(double, uint64_t, f64_sort_key)
+
+void *
+array_sort_numeric(wasm_exec_env_t exec_env, void *ctx, void *obj,
+                   int descending)
 {
     uint32_t len;
+    bool is_mut, ok = true;
     wasm_array_obj_t arr_ref = get_array_ref(obj);
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    wasm_array_type_t arr_type =
+        (wasm_array_type_t)wasm_obj_get_defined_type((wasm_obj_t)arr_ref);
+    wasm_ref_type_t arr_elem_ref_type =
+        wasm_array_type_get_elem_type(arr_type, &is_mut);
 
     len = get_array_length(obj);
+    if (len < 2) {
+        return obj;
+    }
 
-    quick_sort(exec_env, arr_ref, 0, len - 1, closure);
+    if (arr_elem_ref_type.value_type == VALUE_TYPE_F64) {
+        ok = radix_sort_double(wasm_array_obj_first_elem_addr(arr_ref), len,
+                               descending);
+    }
+    else if (arr_elem_ref_type.value_type == VALUE_TYPE_I32) {
+        ok = radix_sort_int32_t(wasm_array_obj_first_elem_addr(arr_ref), len,
+                                descending);
+    }
+    else {
+        wasm_runtime_set_exception(module_inst,
+                                   "array sort: not a numeric array");
+        return obj;
+    }
+
+    if (!ok) {
+        wasm_runtime_set_exception(module_inst, "alloc memory failed");
+    }
 
     return obj;
 }
@@ -508,7 +1217,7 @@ array_splice_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
 
     if (len - delete_count + value_len > capacity) {
         /* Current array space not enough, create new array */
-        new_len = len + value_len - delete_count + ARRAY_GROW_REDUNDANCE;
+        new_len = array_grow_capacity(capacity, len + value_len - delete_count);
         new_arr =
             wasm_array_obj_new_with_type(exec_env, arr_type, new_len, &init);
         if (!new_arr) {
@@ -588,17 +1297,13 @@ array_unshift_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
     arr_type =
         (wasm_array_type_t)wasm_obj_get_defined_type((wasm_obj_t)arr_ref);
 
-    if (len == 0 && value_len != 0) {
-        new_arr = value_arr_ref;
-        new_length = value_len;
-    }
-    else if (len != 0 && value_len == 0) {
+    if (value_len == 0) {
         new_arr = arr_ref;
         new_length = len;
     }
     else if (value_len >= capacity - len) {
         /* Current array space not enough, create new array */
-        uint32_t new_len = len + value_len + ARRAY_GROW_REDUNDANCE;
+        uint32_t new_len = array_grow_capacity(capacity, len + value_len);
         new_arr =
             wasm_array_obj_new_with_type(exec_env, arr_type, new_len, &init);
         if (!new_arr) {
@@ -622,6 +1327,193 @@ array_unshift_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
     return new_length;
 }
 
+/* Linear search kernels working directly on the element storage of a wasm
+ * array. The vector loops only locate the block holding the first match, the
+ * scalar loop then finds its exact position and handles the remainder. The
+ * vector compares follow the same IEEE semantics as the scalar ==, so NaN
+ * never matches and -0 matches +0, as required by indexOf and lastIndexOf */
+static int32
+array_find_i32(const uint32 *data, int32 from, int32 len, uint32 value)
+{
+    int32 i = from;
+
+#if defined(__AVX2__)
+    __m256i needle = _mm256_set1_epi32((int32)value);
+    for (; i + 8 <= len; i += 8) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(block, needle))) {
+            break;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128i needle = _mm_set1_epi32((int32)value);
+    for (; i + 4 <= len; i += 4) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(block, needle))) {
+            break;
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    uint32x4_t needle = vdupq_n_u32(value);
+    for (; i + 4 <= len; i += 4) {
+        if (vmaxvq_u32(vceqq_u32(vld1q_u32(data + i), needle))) {
+            break;
+        }
+    }
+#endif
+    for (; i < len; i++) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int32
+array_find_last_i32(const uint32 *data, int32 from, uint32 value)
+{
+    int32 i = from;
+
+#if defined(__AVX2__)
+    __m256i needle = _mm256_set1_epi32((int32)value);
+    for (; i >= 7; i -= 8) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(data + i - 7));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(block, needle))) {
+            break;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128i needle = _mm_set1_epi32((int32)value);
+    for (; i >= 3; i -= 4) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i - 3));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(block, needle))) {
+            break;
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    uint32x4_t needle = vdupq_n_u32(value);
+    for (; i >= 3; i -= 4) {
+        if (vmaxvq_u32(vceqq_u32(vld1q_u32(data + i - 3), needle))) {
+            break;
+        }
+    }
+#endif
+    for (; i >= 0; i--) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int32
+array_find_f64(const double *data, int32 from, int32 len, double value)
+{
+    int32 i = from;
+
+#if defined(__AVX2__)
+    __m256d needle = _mm256_set1_pd(value);
+    for (; i + 4 <= len; i += 4) {
+        __m256d block = _mm256_loadu_pd(data + i);
+        if (_mm256_movemask_pd(_mm256_cmp_pd(block, needle, _CMP_EQ_OQ))) {
+            break;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128d needle = _mm_set1_pd(value);
+    for (; i + 4 <= len; i += 4) {
+        __m128d lo = _mm_cmpeq_pd(_mm_loadu_pd(data + i), needle);
+        __m128d hi = _mm_cmpeq_pd(_mm_loadu_pd(data + i + 2), needle);
+        if (_mm_movemask_pd(_mm_or_pd(lo, hi))) {
+            break;
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    float64x2_t needle = vdupq_n_f64(value);
+    for (; i + 4 <= len; i += 4) {
+        uint64x2_t lo = vceqq_f64(vld1q_f64(data + i), needle);
+        uint64x2_t hi = vceqq_f64(vld1q_f64(data + i + 2), needle);
+        if (vmaxvq_u32(vreinterpretq_u32_u64(vorrq_u64(lo, hi)))) {
+            break;
+        }
+    }
+#endif
+    for (; i < len; i++) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int32
+array_find_last_f64(const double *data, int32 from, double value)
+{
+    int32 i = from;
+
+#if defined(__AVX2__)
+    __m256d needle = _mm256_set1_pd(value);
+    for (; i >= 3; i -= 4) {
+        __m256d block = _mm256_loadu_pd(data + i - 3);
+        if (_mm256_movemask_pd(_mm256_cmp_pd(block, needle, _CMP_EQ_OQ))) {
+            break;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128d needle = _mm_set1_pd(value);
+    for (; i >= 3; i -= 4) {
+        __m128d lo = _mm_cmpeq_pd(_mm_loadu_pd(data + i - 3), needle);
+        __m128d hi = _mm_cmpeq_pd(_mm_loadu_pd(data + i - 1), needle);
+        if (_mm_movemask_pd(_mm_or_pd(lo, hi))) {
+            break;
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    float64x2_t needle = vdupq_n_f64(value);
+    for (; i >= 3; i -= 4) {
+        uint64x2_t lo = vceqq_f64(vld1q_f64(data + i - 3), needle);
+        uint64x2_t hi = vceqq_f64(vld1q_f64(data + i - 1), needle);
+        if (vmaxvq_u32(vreinterpretq_u32_u64(vorrq_u64(lo, hi)))) {
+            break;
+        }
+    }
+#endif
+    for (; i >= 0; i--) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#define DEFINE_ARRAY_FIND(elem_type, wasm_type)                               \
+    static int32 array_find_##wasm_type(const elem_type *data, int32 from,    \
+                                        int32 len, elem_type value)           \
+    {                                                                         \
+        int32 i;                                                              \
+        for (i = from; i < len; i++) {                                        \
+            if (data[i] == value) {                                           \
+                return i;                                                     \
+            }                                                                 \
+        }                                                                     \
+        return -1;                                                            \
+    }                                                                         \
+                                                                              \
+    static int32 array_find_last_##wasm_type(const elem_type *data,           \
+                                             int32 from, elem_type value)     \
+    {                                                                         \
+        int32 i;                                                              \
+        for (i = from; i >= 0; i--) {                                         \
+            if (data[i] == value) {                                           \
+                return i;                                                     \
+            }                                                                 \
+        }                                                                     \
+        return -1;                                                            \
+    }
+
+DEFINE_ARRAY_FIND(float, f32)
+DEFINE_ARRAY_FIND(uint64, i64)
+
 /* set from_index_obj, reduce the number of comparisons, default index o start
  */
 #define ARRAY_INDEXOF_API(elem_type, wasm_type, wasm_field)               \
@@ -630,9 +1522,7 @@ array_unshift_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
                                      void *from_index_obj)                \
     {                                                                     \
         int32 len, idx = 0;                                               \
-        uint32_t i;                                                       \
         double idx_f = 0;                                                 \
-        wasm_value_t tmp_val = { 0 };                                     \
         wasm_array_obj_t arr_ref = get_array_ref(obj);                    \
         dyn_ctx_t dyn_ctx = dyntype_get_context();                        \
         len = get_array_length(obj);                                      \
@@ -654,13 +1544,8 @@ array_unshift_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
         else {                                                            \
             idx = idx < 0 ? (idx + len) : idx;                            \
         }                                                                 \
-        for (i = idx; i < len; i++) {                                     \
-            wasm_array_obj_get_elem(arr_ref, i, false, &tmp_val);         \
-            if (tmp_val.wasm_field == element) {                          \
-                return i;                                                 \
-            }                                                             \
-        }                                                                 \
-        return -1;                                                        \
+        return array_find_##wasm_type(                                    \
+            wasm_array_obj_first_elem_addr(arr_ref), idx, len, element);  \
     }
 
 ARRAY_INDEXOF_API(double, f64, f64)
@@ -769,8 +1654,7 @@ array_indexOf_anyref(wasm_exec_env_t exec_env, void *ctx, void *obj,
                                          void *obj, elem_type element,        \
                                          void *from_index_obj)                \
     {                                                                         \
-        int32 i, len, idx = 0;                                                \
-        wasm_value_t tmp_val = { 0 };                                         \
+        int32 len, idx = 0;                                                   \
         double idx_f = 0;                                                     \
         wasm_array_obj_t arr_ref = get_array_ref(obj);                        \
         dyn_ctx_t dyn_ctx = dyntype_get_context();                            \
@@ -793,13 +1677,8 @@ array_indexOf_anyref(wasm_exec_env_t exec_env, void *ctx, void *obj,
         else {                                                                \
             idx = idx < 0 ? (idx + len) : (idx >= len ? (len - 1) : idx);     \
         }                                                                     \
-        for (i = idx; i >= 0; i--) {                                          \
-            wasm_array_obj_get_elem(arr_ref, i, false, &tmp_val);             \
-            if (tmp_val.wasm_field == element) {                              \
-                return i;                                                     \
-            }                                                                 \
-        }                                                                     \
-        return -1;                                                            \
+        return array_find_last_##wasm_type(                                   \
+            wasm_array_obj_first_elem_addr(arr_ref), idx, element);           \
     }
 
 ARRAY_LAST_INDEXOF_API(double, f64, f64)
@@ -1542,9 +2421,8 @@ array_copyWithin_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
                                     void *from_obj)                            \
     {                                                                          \
         uint32_t len = get_array_length(obj);                                  \
-        elem_type element_value;                                               \
+        elem_type *data;                                                       \
         wasm_array_obj_t arr_ref = get_array_ref(obj);                         \
-        wasm_value_t value = { 0 };                                            \
         double from_idx_double;                                                \
         int from_idx = 0;                                                      \
         dyn_value_t const from_idx_value =                                     \
@@ -1568,16 +2446,18 @@ array_copyWithin_generic(wasm_exec_env_t exec_env, void *ctx, void *obj,
             return false;                                                      \
         }                                                                      \
                                                                                \
-        for (int i = from_idx; i < len; ++i) {                                 \
-            wasm_array_obj_get_elem(arr_ref, i, false, &value);                \
-            element_value = value.wasm_field;                                  \
-            /* If the element type is string, use strcmp to judge if the array \
-             * contains search_elem */                                         \
-            if (element_value == search_elem) {                                \
-                return true;                                                   \
+        data = wasm_array_obj_first_elem_addr(arr_ref);                        \
+        /* includes uses SameValueZero, so unlike indexOf a NaN search         \
+         * element matches any NaN in the array */                             \
+        if (isnan((double)search_elem)) {                                      \
+            for (int i = from_idx; i < len; ++i) {                             \
+                if (isnan((double)data[i])) {                                  \
+                    return true;                                               \
+                }                                                              \
             }                                                                  \
+            return false;                                                      \
         }                                                                      \
-        return false;                                                          \
+        return array_find_##wasm_type(data, from_idx, len, search_elem) >= 0;  \
     }
 
 static bool
@@ -1698,6 +2578,7 @@ static NativeSymbol native_symbols[] = {
     REG_NATIVE_FUNC(array_shift_anyref, "(rr)r"),
     REG_NATIVE_FUNC(array_slice_generic, "(rrrr)r"),
     REG_NATIVE_FUNC(array_sort_generic, "(rrr)r"),
+    REG_NATIVE_FUNC(array_sort_numeric, "(rri)r"),
     REG_NATIVE_FUNC(array_splice_generic, "(rrFrr)r"),
     REG_NATIVE_FUNC(array_unshift_generic, "(rrr)F"),
     REG_NATIVE_FUNC(array_indexOf_f64, "(rrFr)F"),
@@ -5,7 +5,9 @@
 
 #include "gc_export.h"
 #include "bh_platform.h"
+#include "libdyntype.h"
 #include "libdyntype_export.h"
+#include "type_utils.h"
 
 void *
 Console_constructor(wasm_exec_env_t exec_env, void *obj)
@@ -13,6 +15,24 @@ Console_constructor(wasm_exec_env_t exec_env, void *obj)
     return obj;
 }
 
+/* Static arrays of numbers and any can be printed as a dynamic copy, i32
+ * elements can't: boolean[] and int[] are both i32 arrays */
+static bool
+is_printable_static_array(dyn_ctx_t ctx, dyn_value_t value)
+{
+    void *handle = NULL;
+    WasmArrayInfo arr_info;
+
+    if (dyntype_to_extref(ctx, value, &handle) != ExtArray) {
+        return false;
+    }
+
+    get_static_array_info(ctx, (uint32_t)(uintptr_t)handle, &arr_info);
+
+    return arr_info.element_type.value_type == VALUE_TYPE_F64
+           || arr_info.element_type.value_type == REF_TYPE_ANYREF;
+}
+
 void
 Console_log(wasm_exec_env_t exec_env, void *thiz, void *obj)
 {
@@ -21,6 +41,7 @@ Console_log(wasm_exec_env_t exec_env, void *thiz, void *obj)
     wasm_struct_obj_t arr_struct_ref;
     wasm_array_obj_t arr_ref;
     wasm_obj_t obj_ref = (wasm_obj_t)obj;
+    dyn_ctx_t ctx = dyntype_get_context();
 
     assert(wasm_obj_is_struct_obj(obj_ref));
     arr_struct_ref = (wasm_struct_obj_t)obj_ref;
@@ -34,11 +55,25 @@ Console_log(wasm_exec_env_t exec_env, void *thiz, void *obj)
         wasm_anyref_obj_t anyref = *((wasm_anyref_obj_t *)addr);
         dyn_value_t dynamic_val =
             (dyn_value_t)wasm_anyref_obj_get_value(anyref);
-        if (dyntype_is_extref(dyntype_get_context(), dynamic_val)) {
+        if (dyntype_typeof(ctx, dynamic_val) == DynExtRefArray
+            && is_printable_static_array(ctx, dynamic_val)) {
+            /* copy the static array at once and print it as a dynamic one */
+            dyn_value_t elems =
+                dyntype_get_elems(ctx, dynamic_val, 0, INT32_MAX);
+
+            if (elems) {
+                dyntype_dump_value(ctx, elems);
+                dyntype_release(ctx, elems);
+            }
+            else {
+                printf("[wasm object]");
+            }
+        }
+        else if (dyntype_is_extref(ctx, dynamic_val)) {
             printf("[wasm object]");
         }
         else {
-            dyntype_dump_value(dyntype_get_context(), dynamic_val);
+            dyntype_dump_value(ctx, dynamic_val);
         }
 
         if (i < len - 1) {
@@ -19,7 +19,8 @@ wasm_string_destroy(WASMString str_obj)
 WASMString
 wasm_string_new_const(const char *content, uint32 length)
 {
-    return dyn_value_new_string(content, length);
+    /* literals are interned, equal literals compare by identity */
+    return dyn_string_new_interned(content, length);
 }
 
 /* string.new_xx8 */
@@ -62,7 +63,12 @@ wasm_string_encode(WASMString str_obj, uint32 pos, uint32 count, void *addr,
 
     /* If addr == NULL, just calculate the required length */
     if (addr) {
-        bh_memcpy_s(addr, len, dyn_str->data, len);
+        uint8_t *data = dyn_string_data(dyn_str);
+
+        if (!data) {
+            return -1;
+        }
+        bh_memcpy_s(addr, len, data, len);
     }
 
     if (next_pos) {
@@ -99,11 +105,7 @@ wasm_string_is_usv_sequence(WASMString str_obj)
 WASMString
 wasm_string_create_view(WASMString str_obj, StringViewType type)
 {
-    DyntypeString *dyn_str = (DyntypeString *)str_obj;
-
-    dyn_str->header.ref_count++;
-
-    return dyn_str;
+    return dyn_value_hold(str_obj);
 }
 
 /* stringview_wtf8.advance */
@@ -129,9 +131,9 @@ wasm_string_slice(WASMString str_obj, uint32 start, uint32 end,
 int16
 wasm_string_get_wtf16_codeunit(WASMString str_obj, int32 pos)
 {
-    DyntypeString *dyn_str = (DyntypeString *)str_obj;
+    uint8_t *data = dyn_string_data((DyntypeString *)str_obj);
 
-    return dyn_str->data[pos];
+    return data ? data[pos] : -1;
 }
 
 /* stringview_iter.next */
@@ -154,6 +156,9 @@ void
 wasm_string_dump(WASMString str_obj)
 {
     DyntypeString *dyn_str = (DyntypeString *)str_obj;
+    uint8_t *data = dyn_string_data(dyn_str);
 
-    fwrite(dyn_str->data, 1, dyn_str->length, stdout);
+    if (data) {
+        fwrite(data, 1, dyn_str->length, stdout);
+    }
 }
@@ -15,6 +15,7 @@
 #include "libdyntype_export.h"
 #include "pure_dynamic.h"
 #include "lib_struct_indirect.h"
+#include "extref/extref.h"
 
 void
 dynamic_object_finalizer(wasm_anyref_obj_t obj, void *data)
@@ -33,9 +34,12 @@ box_ptr_to_anyref(wasm_exec_env_t exec_env, dyn_ctx_t ctx, void *ptr)
                                    "alloc memory failed");
         return NULL;
     }
-    wasm_obj_set_gc_finalizer(exec_env, (wasm_obj_t)any_obj,
-                              (wasm_obj_finalizer_t)dynamic_object_finalizer,
-                              ctx);
+    /* immediate values are not reference counted */
+    if (!dyntype_is_immediate(ctx, ptr)) {
+        wasm_obj_set_gc_finalizer(
+            exec_env, (wasm_obj_t)any_obj,
+            (wasm_obj_finalizer_t)dynamic_object_finalizer, ctx);
+    }
     return any_obj;
 }
 
@@ -61,7 +65,6 @@ box_value_to_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, wasm_value_t *value,
     wasm_defined_type_t ret_defined_type = { 0 };
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     wasm_module_t module = wasm_runtime_get_module(module_inst);
-    wasm_function_inst_t alloc_extref_table_slot = NULL;
 
     if (type.value_type == VALUE_TYPE_I32) {
         /* boolean */
@@ -156,10 +159,7 @@ box_value_to_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, wasm_value_t *value,
             }
             else {
 #endif
-                wasm_value_t wasm_ret_value = { 0 };
-                uint32_t occupied_slots = 0;
-                uint32_t extref_argv[6] = { 0 };
-                uint32_t extref_agc = 6;
+                uint32_t handle;
                 int tag = 0;
 
                 if (is_ts_array_type(module, ret_defined_type)) {
@@ -167,29 +167,30 @@ box_value_to_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, wasm_value_t *value,
                 }
                 else if (is_ts_closure_type(module, ret_defined_type)) {
                     tag = ExtFunc;
+                    /* the same closure keeps the same wrapper */
+                    ret = extref_get_func_wrapper(ctx, ori_value);
+                    if (ret) {
+                        return ret;
+                    }
                 }
                 else {
                     tag = ExtObj;
                 }
 
-                alloc_extref_table_slot = wasm_runtime_lookup_function(
-                    module_inst, "allocExtRefTableSlot");
-                bh_assert(alloc_extref_table_slot);
-
-                bh_memcpy_s(extref_argv + occupied_slots,
-                            sizeof(wasm_anyref_obj_t), &ori_value,
-                            sizeof(wasm_anyref_obj_t));
-                occupied_slots += sizeof(wasm_anyref_obj_t) / sizeof(uint32);
-                extref_agc = occupied_slots;
-
-                if (!wasm_runtime_call_wasm(exec_env, alloc_extref_table_slot,
-                                            extref_agc, extref_argv)) {
+                handle = wamr_utils_new_extref_handle(exec_env, ctx,
+                                                      (wasm_obj_t)ori_value);
+                if (handle == EXTREF_INVALID_HANDLE) {
                     return NULL;
                 }
-                bh_memcpy_s(&wasm_ret_value, sizeof(wasm_anyref_obj_t),
-                            extref_argv, sizeof(wasm_anyref_obj_t));
-                ret = dyntype_new_extref(
-                    ctx, (void *)(uintptr_t)wasm_ret_value.i32, tag, NULL);
+                ret = dyntype_new_extref(ctx, (void *)(uintptr_t)handle, tag,
+                                         (void *)exec_env);
+                if (!ret) {
+                    wamr_utils_free_extref_handle(ctx, handle);
+                }
+                /* closures built for a method are new on every access */
+                if (ret && tag == ExtFunc && !new_closure_type) {
+                    extref_set_func_wrapper(ctx, ori_value, ret);
+                }
 #if WASM_ENABLE_STRINGREF == 0
             }
 #endif
@@ -320,16 +321,16 @@ unbox_value_from_any(wasm_exec_env_t exec_env, dyn_ctx_t ctx, dyn_value_t obj,
             else {
 #endif
                 void *ret_value;
-                uint32_t table_idx;
-                void *p_table_index;
-                int32_t tag = dynamic_to_extref(ctx, obj, &p_table_index);
+                uint32_t handle;
+                void *p_handle;
+                int32_t tag = dynamic_to_extref(ctx, obj, &p_handle);
 
                 if (tag == -DYNTYPE_TYPEERR) {
                     goto fail;
                 }
-                table_idx = (uint32_t)(uintptr_t)p_table_index;
+                handle = (uint32_t)(uintptr_t)p_handle;
 
-                ret_value = wamr_utils_get_table_element(exec_env, table_idx);
+                ret_value = wamr_utils_get_extref_obj(ctx, handle);
                 if (is_set_property) {
                     struct_set_indirect_anyref(
                         exec_env, (wasm_anyref_obj_t)unboxed_value->gc_obj,
@@ -26,6 +26,16 @@
 #define OFFSET_OF_FIELD_FLAG_AND_INDEX 4
 #define OFFSET_OF_FIELD_TYPE 8
 
+/* The property name hash table follows the meta fields, see meta.c */
+#define SIZEOF_META_HASH_MASK 4
+#define SIZEOF_META_HASH_SLOT 8
+#define OFFSET_OF_SLOT_HASH 0
+#define OFFSET_OF_SLOT_INDEX 4
+
+/* Must match META_VERSION of the compiler */
+#define META_VERSION 1
+#define META_VERSION_GLOBAL_NAME "meta_version"
+
 /** start type id of custom type */
 #define CUSTOM_TYPE_BEGIN 1052
 
@@ -1084,7 +1094,7 @@ fail:
 #endif /* end of WASM_ENABLE_STRINGREF != 0 */
 
 void
-get_static_array_info(wasm_exec_env_t exec_env, uint32_t tbl_idx,
+get_static_array_info(dyn_ctx_t ctx, uint32_t handle,
                       WasmArrayInfo *p_arr_info)
 {
     void *static_arr_struct = NULL;
@@ -1095,7 +1105,7 @@ get_static_array_info(wasm_exec_env_t exec_env, uint32_t tbl_idx,
     wasm_ref_type_t arr_elem_ref_type = { 0 };
 
     static_arr_struct =
-        (wasm_struct_obj_t)wamr_utils_get_table_element(exec_env, tbl_idx);
+        (wasm_struct_obj_t)wamr_utils_get_extref_obj(ctx, handle);
     arr_ref = get_array_ref(static_arr_struct);
     arr_len = get_array_length(static_arr_struct);
     static_arr_arr_type = wasm_obj_get_defined_type((wasm_obj_t)arr_ref);
@@ -1108,56 +1118,6 @@ get_static_array_info(wasm_exec_env_t exec_env, uint32_t tbl_idx,
     p_arr_info->lengh = arr_len;
 }
 
-int
-get_prop_index_of_struct(wasm_exec_env_t exec_env, const char *prop,
-                         wasm_obj_t *wasm_obj, wasm_ref_type_t *field_type)
-{
-    wasm_module_inst_t module_inst;
-    bool is_mut;
-    wasm_function_inst_t func;
-    wasm_struct_obj_t wasm_struct_obj;
-    WASMValue vtable_value = { 0 };
-    WASMValue meta = { 0 };
-    uint32_t argc = 3, argv[3] = { 0 }, offset;
-    wasm_struct_type_t struct_type;
-    wasm_struct_type_t vtable_type;
-    int property_flag = -1;
-    int property_index = -1;
-
-    module_inst = wasm_runtime_get_module_inst(exec_env);
-    wasm_struct_obj = (wasm_struct_obj_t)(*wasm_obj);
-    wasm_struct_obj_get_field(wasm_struct_obj, 0, false, &vtable_value);
-    wasm_struct_obj_get_field((wasm_struct_obj_t)vtable_value.gc_obj, 0, false,
-                              &meta);
-    struct_type = (wasm_struct_type_t)wasm_obj_get_defined_type(*wasm_obj);
-    func = wasm_runtime_lookup_function(module_inst,
-                                        "find_property_flag_and_index");
-    bh_assert(func);
-
-    argv[0] = meta.i32;
-    offset = wasm_runtime_addr_native_to_app(module_inst, (void *)prop);
-    argv[1] = offset;
-    argv[2] = ALL;
-
-    wasm_runtime_call_wasm(exec_env, func, argc, argv);
-    if (argv[0] != -1) {
-        property_flag = argv[0] & META_FLAG_MASK;
-        property_index = (argv[0] & META_INDEX_MASK) >> 4;
-        if (property_flag == METHOD) {
-            vtable_type = (wasm_struct_type_t)wasm_obj_get_defined_type(
-                vtable_value.gc_obj);
-            *field_type = wasm_struct_type_get_field_type(
-                vtable_type, property_index, &is_mut);
-        }
-        else if (property_flag == FIELD) {
-            *field_type = wasm_struct_type_get_field_type(
-                struct_type, property_index, &is_mut);
-        }
-    }
-
-    return property_index;
-}
-
 /**********Utils for search field value of object through meta
  * information*************/
 int32
@@ -1201,46 +1161,145 @@ get_meta_field_name(void *meta_field)
     return *((int32 *)meta_field);
 }
 
+/* FNV-1a, must be kept in sync with meta.c */
+static inline uint32
+hash_meta_field_name(const char *name)
+{
+    uint32 hash = 2166136261u;
+
+    while (*name) {
+        hash ^= (uint8)*name++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/* find the meta field of name through the hash table of meta, flag ALL
+ * matches any kind of field, return NULL if not found */
+static void *
+find_meta_field(wasm_module_inst_t module_inst, void *meta, const char *name,
+                enum field_flag flag)
+{
+    int32 count = get_meta_fields_count(meta);
+    void *hash_table = get_meta_field_by_index(meta, count);
+    uint32 hash_mask = *(uint32 *)hash_table;
+    void *slots = hash_table + SIZEOF_META_HASH_MASK;
+    uint32 hash = hash_meta_field_name(name);
+    uint32 i = hash & hash_mask;
+    void *slot, *meta_field;
+    int32 slot_index;
+    const char *meta_field_name;
+
+    /* the table is at most half full, an empty slot ends the probe */
+    while (true) {
+        slot = slots + i * SIZEOF_META_HASH_SLOT;
+        slot_index = *(int32 *)(slot + OFFSET_OF_SLOT_INDEX);
+        if (slot_index == 0) {
+            return NULL;
+        }
+
+        if (*(uint32 *)(slot + OFFSET_OF_SLOT_HASH) == hash) {
+            meta_field = get_meta_field_by_index(meta, slot_index - 1);
+            meta_field_name = wasm_runtime_addr_app_to_native(
+                module_inst, get_meta_field_name(meta_field));
+            if (meta_field_name && strcmp(name, meta_field_name) == 0
+                && (flag == ALL || get_meta_field_flag(meta_field) == flag)) {
+                return meta_field;
+            }
+        }
+
+        i = (i + 1) & hash_mask;
+    }
+}
+
+bool
+check_meta_version(wasm_module_inst_t module_inst)
+{
+    wasm_global_inst_t global;
+
+    if (!wasm_runtime_get_export_global_inst(
+            module_inst, META_VERSION_GLOBAL_NAME, &global)) {
+        return false;
+    }
+
+    return global.kind == WASM_I32 && !global.is_mutable
+           && *(int32 *)global.global_data == META_VERSION;
+}
+
+int
+get_prop_index_of_struct(wasm_exec_env_t exec_env, const char *prop,
+                         wasm_obj_t *wasm_obj, wasm_ref_type_t *field_type)
+{
+    wasm_module_inst_t module_inst;
+    bool is_mut;
+    wasm_struct_obj_t wasm_struct_obj;
+    WASMValue vtable_value = { 0 };
+    WASMValue meta = { 0 };
+    void *meta_addr, *meta_field;
+    wasm_struct_type_t struct_type;
+    wasm_struct_type_t vtable_type;
+    int property_flag = -1;
+    int property_index = -1;
+
+    module_inst = wasm_runtime_get_module_inst(exec_env);
+    wasm_struct_obj = (wasm_struct_obj_t)(*wasm_obj);
+    wasm_struct_obj_get_field(wasm_struct_obj, 0, false, &vtable_value);
+    wasm_struct_obj_get_field((wasm_struct_obj_t)vtable_value.gc_obj, 0, false,
+                              &meta);
+    struct_type = (wasm_struct_type_t)wasm_obj_get_defined_type(*wasm_obj);
+
+    /* read the meta directly instead of calling find_property_flag_and_index
+     * of the module, the name doesn't need to live in the linear memory */
+    meta_addr = wasm_runtime_addr_app_to_native(module_inst, meta.i32);
+    if (!meta_addr) {
+        return -2;
+    }
+
+    meta_field = find_meta_field(module_inst, meta_addr, prop, ALL);
+    if (meta_field) {
+        property_flag = get_meta_field_flag(meta_field);
+        property_index = get_meta_field_index(meta_field);
+        if (property_flag == METHOD) {
+            vtable_type = (wasm_struct_type_t)wasm_obj_get_defined_type(
+                vtable_value.gc_obj);
+            *field_type = wasm_struct_type_get_field_type(
+                vtable_type, property_index, &is_mut);
+        }
+        else if (property_flag == FIELD) {
+            *field_type = wasm_struct_type_get_field_type(
+                struct_type, property_index, &is_mut);
+        }
+    }
+
+    return property_index;
+}
+
 static int32
 get_object_field_index_by_mata(wasm_exec_env_t exec_env, void *meta,
                                const char *field_name, enum field_flag flag,
                                ts_value_type_t *field_type)
 {
-    int32 count;
     void *meta_field;
-    enum field_flag meta_field_flag;
-    int32 meta_field_name_offset;
-    const char *meta_field_name;
-    int32 meta_field_index;
     int32 field_type_id;
 
-    count = get_meta_fields_count(meta);
-    meta_field_index = -1;
-
-    for (int index = 0; index < count; index++) {
-        meta_field = get_meta_field_by_index(meta, index);
-        meta_field_flag = get_meta_field_flag(meta_field);
-        meta_field_name_offset = get_meta_field_name(meta_field);
-        meta_field_name = wasm_runtime_addr_app_to_native(
-            wasm_runtime_get_module_inst(exec_env), meta_field_name_offset);
+    meta_field = find_meta_field(wasm_runtime_get_module_inst(exec_env), meta,
+                                 field_name, flag);
+    if (!meta_field) {
+        return -1;
+    }
 
-        if (meta_field_flag == flag
-            && strcmp(field_name, meta_field_name) == 0) {
-            meta_field_index = get_meta_field_index(meta_field);
-            if (field_type) {
-                field_type_id = get_meta_field_type(meta_field);
-                if (field_type_id >= CUSTOM_TYPE_BEGIN) {
-                    *field_type = TS_OBJECT;
-                }
-                else {
-                    *field_type = (ts_value_type_t)field_type_id;
-                }
-            }
-            break;
+    if (field_type) {
+        field_type_id = get_meta_field_type(meta_field);
+        if (field_type_id >= CUSTOM_TYPE_BEGIN) {
+            *field_type = TS_OBJECT;
+        }
+        else {
+            *field_type = (ts_value_type_t)field_type_id;
         }
     }
 
-    return meta_field_index;
+    return get_meta_field_index(meta_field);
 }
 
 int
@@ -1288,23 +1347,27 @@ get_object_field(wasm_exec_env_t exec_env, wasm_obj_t obj,
     return 0;
 }
 
-void *
-get_meta_of_object(wasm_exec_env_t exec_env, wasm_obj_t obj)
+uint32_t
+get_meta_offset_of_object(wasm_obj_t obj)
 {
     wasm_struct_obj_t struct_obj;
     wasm_struct_obj_t vtable_struct;
     WASMValue vtable_value = { 0 };
     wasm_value_t meta = { 0 };
-    void *meta_addr;
 
-    /* get meta addr */
     struct_obj = (wasm_struct_obj_t)obj;
     wasm_struct_obj_get_field(struct_obj, 0, false, &vtable_value);
     vtable_struct = (wasm_struct_obj_t)vtable_value.gc_obj;
     wasm_struct_obj_get_field(vtable_struct, 0, false, &meta);
-    meta_addr = wasm_runtime_addr_app_to_native(
-        wasm_runtime_get_module_inst(exec_env), meta.i32);
-    return meta_addr;
+    return (uint32_t)meta.i32;
+}
+
+void *
+get_meta_of_object(wasm_exec_env_t exec_env, wasm_obj_t obj)
+{
+    /* get meta addr */
+    return wasm_runtime_addr_app_to_native(
+        wasm_runtime_get_module_inst(exec_env), get_meta_offset_of_object(obj));
 }
 
 const char *
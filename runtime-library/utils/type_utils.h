@@ -8,6 +8,7 @@
 
 #include "gc_export.h"
 #include "gc_object.h"
+#include "libdyntype_export.h"
 
 void
 dynamic_object_finalizer(wasm_anyref_obj_t obj, void *data);
@@ -15,16 +16,20 @@ dynamic_object_finalizer(wasm_anyref_obj_t obj, void *data);
 /* Convert host pointer to anyref */
 #define RETURN_BOX_ANYREF(ptr, dyn_ctx)                                        \
     do {                                                                       \
+        dyn_value_t boxed_value = (ptr);                                       \
         wasm_anyref_obj_t any_obj =                                            \
-            (wasm_anyref_obj_t)wasm_anyref_obj_new(exec_env, ptr);             \
+            (wasm_anyref_obj_t)wasm_anyref_obj_new(exec_env, boxed_value);     \
         if (!any_obj) {                                                        \
             wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env), \
                                        "alloc memory failed");                 \
             return NULL;                                                       \
         }                                                                      \
-        wasm_obj_set_gc_finalizer(                                             \
-            exec_env, (wasm_obj_t)any_obj,                                     \
-            (wasm_obj_finalizer_t)dynamic_object_finalizer, dyn_ctx);          \
+        /* immediate values are not reference counted */                       \
+        if (!dyntype_is_immediate(dyn_ctx, boxed_value)) {                     \
+            wasm_obj_set_gc_finalizer(                                         \
+                exec_env, (wasm_obj_t)any_obj,                                 \
+                (wasm_obj_finalizer_t)dynamic_object_finalizer, dyn_ctx);      \
+        }                                                                      \
         return any_obj;                                                        \
     } while (0)
 
@@ -179,11 +184,16 @@ typedef struct WasmArrayInfo {
 } WasmArrayInfo;
 
 void
-get_static_array_info(wasm_exec_env_t exec_env, uint32_t tbl_idx,
+get_static_array_info(dyn_ctx_t ctx, uint32_t handle,
                       WasmArrayInfo *p_arr_info);
 
+/* check if the Meta layout emitted into the module matches the one read by
+ * the runtime, must pass before any meta based lookup */
+bool
+check_meta_version(wasm_module_inst_t module_inst);
+
 /* get property of a struct
- * result: -2: not a static object, -1: error: else: static object index
+ * result: -1: not a static property, -2: error, else: static property index
  */
 int
 get_prop_index_of_struct(wasm_exec_env_t exec_env, const char *prop,
@@ -254,6 +264,15 @@ create_wasm_array_with_i32(wasm_exec_env_t exec_env, void *ptr,
 void *
 get_meta_of_object(wasm_exec_env_t exec_env, wasm_obj_t obj);
 
+/**
+ * @brief get the offset of the meta info in the linear memory, it doesn't
+ * change when the memory grows
+ * @param obj object
+ * @result : meta info offset
+ */
+uint32_t
+get_meta_offset_of_object(wasm_obj_t obj);
+
 /**
  * @brief get member count through meta info addr.
  * @param meta meta info addr.
@@ -3,40 +3,227 @@
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
  */
 
-/* This file provide APIs to access WAMR internal data structures, this should
- * be removed if these APIs are directly implemented in WAMR */
+/* This file provide APIs to manage the wasm objects referred to by extrefs,
+ * the objects are stored in the extref_slots array exported by the module */
 
-#include "wasm_exec_env.h"
-#include "wasm_runtime.h"
-#if WASM_ENABLE_AOT != 0
-#include "aot_runtime.h"
-#endif
-#include "wasm_runtime_common.h"
+#include "bh_platform.h"
+#include "pure_dynamic.h"
+#include "type_utils.h"
+#include "wamr_utils.h"
+
+#define EXTREF_SLOTS_GLOBAL_NAME "extref_slots"
+#define EXTREF_SLOTS_INIT_CAPACITY 64
+/* the last index is never used, with generation 255 its handle would be
+ * EXTREF_INVALID_HANDLE */
+#define EXTREF_SLOTS_MAX_CAPACITY EXTREF_INDEX_MASK
+
+/* Registry of the extref_slots array, kept in the host data of the dyntype
+ * context bound to the instance. The array is held by a global so the GC
+ * treats every slot as a root, freed slots are chained by next_free and
+ * reused */
+typedef struct ExtRefSlots {
+    wasm_module_inst_t module_inst;
+    /* address of the extref_slots global */
+    void *global_data;
+    wasm_array_type_t array_type;
+    uint32_t capacity;
+    uint32_t free_head;
+    uint32_t *next_free;
+    uint8_t *generations;
+} ExtRefSlots;
+
+static ExtRefSlots *
+get_extref_slots(dyn_ctx_t ctx, wasm_module_inst_t module_inst, bool create)
+{
+    DynHostData *host = dynamic_get_host_data(ctx);
+    ExtRefSlots *slots = (ExtRefSlots *)host->extref_slots;
+    wasm_module_t module;
+    wasm_global_inst_t global;
+    wasm_ref_type_t elem_type = { .value_type = REF_TYPE_ANYREF,
+                                  .nullable = true };
+
+    if (slots || !create) {
+        return slots;
+    }
+
+    if (!wasm_runtime_get_export_global_inst(
+            module_inst, EXTREF_SLOTS_GLOBAL_NAME, &global)) {
+        return NULL;
+    }
+
+    if (!(slots = wasm_runtime_malloc(sizeof(ExtRefSlots)))) {
+        return NULL;
+    }
+    memset(slots, 0, sizeof(ExtRefSlots));
+
+    module = wasm_runtime_get_module(module_inst);
+    get_array_type_by_element(module, &elem_type, true, &slots->array_type);
+    if (!slots->array_type) {
+        wasm_runtime_free(slots);
+        return NULL;
+    }
+
+    slots->module_inst = module_inst;
+    slots->global_data = global.global_data;
+    slots->free_head = EXTREF_INVALID_HANDLE;
+    host->extref_slots = slots;
+
+    return slots;
+}
+
+static bool
+grow_extref_slots(wasm_exec_env_t exec_env, ExtRefSlots *slots)
+{
+    uint32_t i, new_capacity;
+    uint32_t *next_free;
+    uint8_t *generations;
+    wasm_value_t init = { .gc_obj = NULL };
+    wasm_array_obj_t old_arr = *(wasm_array_obj_t *)slots->global_data;
+    wasm_array_obj_t new_arr;
+
+    if (slots->capacity >= EXTREF_SLOTS_MAX_CAPACITY) {
+        return false;
+    }
+
+    new_capacity = slots->capacity ? slots->capacity * 2
+                                   : EXTREF_SLOTS_INIT_CAPACITY;
+    if (new_capacity > EXTREF_SLOTS_MAX_CAPACITY) {
+        new_capacity = EXTREF_SLOTS_MAX_CAPACITY;
+    }
+
+    if (!(next_free = wasm_runtime_realloc(slots->next_free,
+                                           sizeof(uint32_t) * new_capacity))) {
+        return false;
+    }
+    slots->next_free = next_free;
+
+    if (!(generations = wasm_runtime_realloc(slots->generations,
+                                             sizeof(uint8_t) * new_capacity))) {
+        return false;
+    }
+    slots->generations = generations;
+
+    /* old_arr is rooted by the global until it is replaced */
+    new_arr = wasm_array_obj_new_with_type(exec_env, slots->array_type,
+                                           new_capacity, &init);
+    if (!new_arr) {
+        return false;
+    }
+
+    if (old_arr) {
+        wasm_array_obj_copy(new_arr, 0, old_arr, 0, slots->capacity);
+    }
+    *(wasm_array_obj_t *)slots->global_data = new_arr;
+
+    /* chain the new slots in index order */
+    for (i = new_capacity; i > slots->capacity; i--) {
+        slots->next_free[i - 1] = slots->free_head;
+        slots->generations[i - 1] = 1;
+        slots->free_head = i - 1;
+    }
+    slots->capacity = new_capacity;
+
+    return true;
+}
+
+uint32_t
+wamr_utils_new_extref_handle(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
+                             wasm_obj_t obj)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    ExtRefSlots *slots = get_extref_slots(ctx, module_inst, true);
+    wasm_local_obj_ref_t local_ref;
+    wasm_value_t value = { .gc_obj = obj };
+    uint32_t index;
+    bool grown = true;
+
+    if (!slots) {
+        wasm_runtime_set_exception(module_inst, "extref slots not found");
+        return EXTREF_INVALID_HANDLE;
+    }
+
+    if (slots->module_inst != module_inst) {
+        wasm_runtime_set_exception(
+            module_inst, "extref slots belong to another module instance");
+        return EXTREF_INVALID_HANDLE;
+    }
+
+    if (slots->free_head == EXTREF_INVALID_HANDLE) {
+        /* obj may not be referred to by anything else while growing */
+        wasm_runtime_push_local_obj_ref(exec_env, &local_ref);
+        local_ref.val = obj;
+        grown = grow_extref_slots(exec_env, slots);
+        wasm_runtime_pop_local_obj_ref(exec_env);
+    }
+
+    if (!grown) {
+        wasm_runtime_set_exception(module_inst, "alloc extref slot failed");
+        return EXTREF_INVALID_HANDLE;
+    }
+
+    index = slots->free_head;
+    slots->free_head = slots->next_free[index];
+    wasm_array_obj_set_elem(*(wasm_array_obj_t *)slots->global_data, index,
+                            &value);
+
+    return index | ((uint32_t)slots->generations[index] << EXTREF_INDEX_BITS);
+}
 
 void *
-wamr_utils_get_table_element(WASMExecEnv *exec_env, uint32_t index)
+wamr_utils_get_extref_obj(dyn_ctx_t ctx, uint32_t handle)
+{
+    ExtRefSlots *slots = get_extref_slots(ctx, NULL, false);
+    uint32_t index = handle & EXTREF_INDEX_MASK;
+    wasm_value_t value = { .gc_obj = NULL };
+
+    if (!slots || index >= slots->capacity
+        || slots->generations[index] != handle >> EXTREF_INDEX_BITS) {
+        return NULL;
+    }
+
+    wasm_array_obj_get_elem(*(wasm_array_obj_t *)slots->global_data, index,
+                            false, &value);
+    return value.gc_obj;
+}
+
+void
+wamr_utils_free_extref_handle(dyn_ctx_t ctx, uint32_t handle)
+{
+    ExtRefSlots *slots = get_extref_slots(ctx, NULL, false);
+    uint32_t index = handle & EXTREF_INDEX_MASK;
+    wasm_value_t value = { .gc_obj = NULL };
+
+    if (!slots || index >= slots->capacity
+        || slots->generations[index] != handle >> EXTREF_INDEX_BITS) {
+        return;
+    }
+
+    wasm_array_obj_set_elem(*(wasm_array_obj_t *)slots->global_data, index,
+                            &value);
+    /* generation 0 is skipped so a handle is never 0 */
+    if (++slots->generations[index] == 0) {
+        slots->generations[index] = 1;
+    }
+    slots->next_free[index] = slots->free_head;
+    slots->free_head = index;
+}
+
+void
+wamr_utils_destroy_extref_handles(dyn_ctx_t ctx)
 {
-    WASMModuleInstanceCommon *module_inst =
-        wasm_exec_env_get_module_inst(exec_env);
-
-#if WASM_ENABLE_INTERP != 0
-    if (module_inst->module_type == Wasm_Module_Bytecode) {
-        WASMModuleInstance *wasm_module_inst =
-            (WASMModuleInstance *)module_inst;
-        WASMTableInstance *table_inst = wasm_module_inst->tables[0];
-        return table_inst->elems[index];
-    }
-#endif
-#if WASM_ENABLE_AOT != 0
-    if (module_inst->module_type == Wasm_Module_AoT) {
-        WASMModuleInstance *aot_module_inst = (WASMModuleInstance *)module_inst;
-        AOTModule *module = (AOTModule *)aot_module_inst->module;
-        AOTTableInstance *table_inst =
-            (AOTTableInstance *)(aot_module_inst->global_data
-                                 + module->global_data_size);
-        return table_inst->elems[index];
-    }
-#endif
-
-    return NULL;
+    ExtRefSlots *slots = get_extref_slots(ctx, NULL, false);
+
+    if (!slots) {
+        return;
+    }
+
+    dynamic_get_host_data(ctx)->extref_slots = NULL;
+
+    if (slots->next_free) {
+        wasm_runtime_free(slots->next_free);
+    }
+    if (slots->generations) {
+        wasm_runtime_free(slots->generations);
+    }
+    wasm_runtime_free(slots);
 }
@@ -3,15 +3,63 @@
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
  */
 
-#include "wasm_export.h"
+#ifndef __WAMR_UTILS_H_
+#define __WAMR_UTILS_H_
+
+#include "gc_export.h"
+#include "libdyntype.h"
+
+/* An extref handle is the index of a slot in the exported extref_slots
+ * array (low 24 bits) and the generation of that slot (high 8 bits), so a
+ * stale handle is detected once its slot is reused */
+#define EXTREF_INDEX_BITS 24
+#define EXTREF_INDEX_MASK ((1u << EXTREF_INDEX_BITS) - 1)
+#define EXTREF_INVALID_HANDLE 0xFFFFFFFF
 
 /**
- * @brief Get element from wasm table by index
+ * @brief Allocate a slot in the extref_slots array and store a wasm object
+ * into it. The slots are registered in ctx the first time, ctx must then stay
+ * bound to the module instance of exec_env
  *
  * @param exec_env wasm execution environment
- * @param index element index
+ * @param ctx the dynamic type system context
+ * @param obj the wasm object referred to by the extref
+ *
+ * @return the handle of the slot, EXTREF_INVALID_HANDLE if failed
+ */
+uint32_t
+wamr_utils_new_extref_handle(wasm_exec_env_t exec_env, dyn_ctx_t ctx,
+                             wasm_obj_t obj);
+
+/**
+ * @brief Get the wasm object referred to by an extref handle
  *
- * @return the element stored in the table slot, for GC objects, it's wasm_obj_t
+ * @param ctx the dynamic type system context
+ * @param handle the extref handle
+ *
+ * @return the wasm object, NULL if the handle is stale
  */
 void *
-wamr_utils_get_table_element(wasm_exec_env_t exec_env, uint32_t index);
+wamr_utils_get_extref_obj(dyn_ctx_t ctx, uint32_t handle);
+
+/**
+ * @brief Release the slot of an extref handle, the object is no longer
+ * rooted by the slot and the slot can be reused
+ *
+ * @param ctx the dynamic type system context
+ * @param handle the extref handle
+ */
+void
+wamr_utils_free_extref_handle(dyn_ctx_t ctx, uint32_t handle);
+
+/**
+ * @brief Destroy the extref handle registry of a context, should be called
+ * before deinstantiating the module instance it is bound to. Handles released
+ * afterwards are ignored
+ *
+ * @param ctx the dynamic type system context
+ */
+void
+wamr_utils_destroy_extref_handles(dyn_ctx_t ctx);
+
+#endif /* end of __WAMR_UTILS_H_ */
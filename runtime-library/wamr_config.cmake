@@ -13,7 +13,6 @@ set (WAMR_BUILD_INTERP 1)
 set (WAMR_BUILD_LIBC_BUILTIN 1)
 set (WAMR_BUILD_GC 1)
 set (WAMR_BUILD_STRINGREF 1)
-add_definitions(-DWASM_TABLE_MAX_SIZE=10240)
 
 if (NOT DEFINED WAMR_BUILD_TARGET)
     set (WAMR_BUILD_TARGET X86_64)
@@ -19,7 +19,7 @@ import {
     generateGlobalContext,
     addItableFunc,
     generateGlobalJSObject,
-    generateExtRefTableMaskArr,
+    generateExtRefSlots,
     generateDynContext,
     importMemoryAPI,
 } from './lib/env_init.js';
@@ -29,7 +29,6 @@ import { WASMStatementGen } from './wasm_stmt_gen.js';
 import {
     initGlobalOffset,
     initDefaultMemory,
-    initDefaultTable,
 } from './memory.js';
 import { BuiltinNames } from '../../../lib/builtin/builtin_name.js';
 import { Ts2wasmBackend, ParserContext, DataSegmentContext } from '../index.js';
@@ -412,7 +411,6 @@ export class WASMGen extends Ts2wasmBackend {
         UtilFuncs.clearWasmStringMap();
         FunctionalFuncs.resetDynContextRef();
 
-        initDefaultTable(this.module);
         /* init builtin APIs */
         callBuiltInAPIs(this.module);
         /* init any lib APIs */
@@ -446,7 +444,7 @@ export class WASMGen extends Ts2wasmBackend {
         this.parseFuncs();
 
         generateGlobalContext(this.module);
-        generateExtRefTableMaskArr(this.module);
+        generateExtRefSlots(this.module);
         BuiltinNames.JSGlobalObjects.forEach((key) => {
             generateGlobalJSObject(this.module, key);
             /* Insert at the second slot (right after dyntype context initialized) */
@@ -1058,7 +1056,14 @@ export class WASMGen extends Ts2wasmBackend {
         const members = objType.meta.members;
         let dataLength = members.length;
         dataLength += members.filter((m) => m.hasSetter && m.hasGetter).length;
-        const buffer = new Uint32Array(3 + 3 * dataLength);
+        /* hash table slot count is a power of two and at least twice the
+            property count, so there is always an empty slot to end a probe */
+        let slotCount = 2;
+        while (slotCount < dataLength * 2) {
+            slotCount <<= 1;
+        }
+        const hashTableStart = 3 + 3 * dataLength;
+        const buffer = new Uint32Array(hashTableStart + 1 + 2 * slotCount);
         buffer[0] = objType.typeId;
         buffer[1] = objType.implId;
         buffer[2] = dataLength;
@@ -1068,10 +1073,12 @@ export class WASMGen extends Ts2wasmBackend {
         let memberMethodsCnt = 1;
         const cnt = Math.min(dataLength, members.length);
         let memberFieldsCnt = 1; // In obj, the first field is vtable.
+        const nameOfOffset = new Map<number, string>();
         for (let i = 0, j = 3; i < cnt; i++, j += 3) {
             const member = members[i];
             const memberName = member.name;
             buffer[j] = this.generateRawString(memberName);
+            nameOfOffset.set(buffer[j], memberName);
             if (member.type === MemberType.FIELD) {
                 const flag = ItableFlag.FIELD;
                 const index = memberFieldsCnt++;
@@ -1115,6 +1122,21 @@ export class WASMGen extends Ts2wasmBackend {
                 }
             }
         }
+        /* properties with the same name (getter and setter) are inserted in
+            order, so the probe sequence visits them in properties order */
+        const hashMask = slotCount - 1;
+        buffer[hashTableStart] = hashMask;
+        for (let i = 0, j = 3; i < dataLength; i++, j += 3) {
+            const hash = UtilFuncs.hashPropertyName(
+                nameOfOffset.get(buffer[j])!,
+            );
+            let slot = hash & hashMask;
+            while (buffer[hashTableStart + 1 + slot * 2 + 1] !== 0) {
+                slot = (slot + 1) & hashMask;
+            }
+            buffer[hashTableStart + 1 + slot * 2] = hash;
+            buffer[hashTableStart + 1 + slot * 2 + 1] = i + 1;
+        }
         const offset = this.dataSegmentContext!.addData(
             new Uint8Array(buffer.buffer),
         );
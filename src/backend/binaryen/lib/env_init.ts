@@ -8,10 +8,9 @@ import { dyntype, structdyn } from './dyntype/utils.js';
 import fs from 'fs';
 import path from 'path';
 import { fileURLToPath } from 'url';
-import { UtilFuncs } from '../utils.js';
+import { META_VERSION, UtilFuncs } from '../utils.js';
 import { BuiltinNames } from '../../../../lib/builtin/builtin_name.js';
-import { getBuiltInFuncName } from '../../../utils.js';
-import { i8ArrayTypeInfo } from '../glue/packType.js';
+import { anyArrayTypeInfo } from '../glue/packType.js';
 import { _BinaryenTypeStringref } from '../glue/binaryen.js';
 
 export function importAnyLibAPI(module: binaryen.Module) {
@@ -231,7 +230,7 @@ export function importAnyLibAPI(module: binaryen.Module) {
         dyntype.dyntype_new_extref,
         binaryen.createType([
             dyntype.dyn_ctx_t,
-            dyntype.pointer,
+            binaryen.anyref,
             dyntype.external_ref_tag,
         ]),
         dyntype.dyn_value_t,
@@ -499,14 +498,15 @@ export function generateGlobalJSObject(module: binaryen.Module, name: string) {
     );
 }
 
-export function generateExtRefTableMaskArr(module: binaryen.Module) {
-    const name = getBuiltInFuncName(BuiltinNames.extRefTableMaskArr);
+export function generateExtRefSlots(module: binaryen.Module) {
+    /* the slots are allocated and grown by the runtime, see wamr_utils.c */
     module.addGlobal(
-        name,
-        i8ArrayTypeInfo.typeRef,
+        BuiltinNames.extrefSlots,
+        anyArrayTypeInfo.typeRef,
         true,
-        module.ref.null(dyntype.dyn_ctx_t),
+        module.ref.null(anyArrayTypeInfo.typeRef),
     );
+    module.addGlobalExport(BuiltinNames.extrefSlots, BuiltinNames.extrefSlots);
 }
 
 export function generateDynContext(module: binaryen.Module) {
@@ -546,4 +546,11 @@ export function addItableFunc(module: binaryen.Module) {
     );
     UtilFuncs.addWatFuncs(watModule, BuiltinNames.findPropertyType, module);
     watModule.dispose();
+    module.addGlobal(
+        BuiltinNames.metaVersion,
+        binaryen.i32,
+        false,
+        module.i32.const(META_VERSION),
+    );
+    module.addGlobalExport(BuiltinNames.metaVersion, BuiltinNames.metaVersion);
 }
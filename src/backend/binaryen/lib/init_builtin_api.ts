@@ -64,17 +64,12 @@ function anyrefCond(module: binaryen.Module) {
         [dynCtx, ref],
         dyntype.bool,
     );
-    const index = module.call(
+    const handle = module.call(
         dyntype.dyntype_to_extref,
         [dynCtx, ref],
         dyntype.int,
     );
-    const extRef = binaryenCAPI._BinaryenTableGet(
-        module.ptr,
-        UtilFuncs.getCString(BuiltinNames.extrefTable),
-        index,
-        binaryen.anyref,
-    );
+    const extRef = FunctionalFuncs.getExtrefSlot(module, handle);
 
     const ifTrue = module.block(null, [
         module.return(
@@ -3245,162 +3240,12 @@ function Array_isArray(module: binaryen.Module) {
     return module.block(null, statementArray);
 }
 
-function allocExtRefTableSlot(module: binaryen.Module) {
-    const objIdx = 0;
-    const tableIdx = 1;
-    const loopIdx = 2;
-    const tmpMaskArrIdx = 3;
-
-    const arrName = getBuiltInFuncName(BuiltinNames.extRefTableMaskArr);
-    const maskArr = binaryenCAPI._BinaryenGlobalGet(
-        module.ptr,
-        UtilFuncs.getCString(arrName),
-        i8ArrayTypeInfo.typeRef,
-    );
-    const newArray = binaryenCAPI._BinaryenArrayNew(
-        module.ptr,
-        i8ArrayTypeInfo.heapTypeRef,
-        binaryenCAPI._BinaryenTableSize(
-            module.ptr,
-            UtilFuncs.getCString(BuiltinNames.extrefTable),
-        ),
-        module.i32.const(0),
-    );
-    const tableGrow = binaryenCAPI._BinaryenTableGrow(
-        module.ptr,
-        UtilFuncs.getCString(BuiltinNames.extrefTable),
-        FunctionalFuncs.getEmptyRef(module),
-        module.i32.const(BuiltinNames.tableGrowDelta),
-    );
-    const stmts: binaryen.ExpressionRef[] = [];
-    stmts.push(module.local.set(tableIdx, module.i32.const(-1)));
-    stmts.push(module.local.set(loopIdx, module.i32.const(0)));
-    stmts.push(
-        module.if(
-            module.ref.is_null(maskArr),
-            module.block(null, [
-                tableGrow,
-                binaryenCAPI._BinaryenGlobalSet(
-                    module.ptr,
-                    UtilFuncs.getCString(arrName),
-                    newArray,
-                ),
-            ]),
-        ),
-    );
-    const maskArrLen = binaryenCAPI._BinaryenArrayLen(module.ptr, maskArr);
-    const loopBlock = 'look_block';
-    const loopLabel = 'for_loop';
-    const loopBlockStmts: binaryen.ExpressionRef[] = [];
-    const loopStmts: binaryen.ExpressionRef[] = [];
-    const loopCond = module.i32.lt_u(
-        module.local.get(loopIdx, binaryen.i32),
-        maskArrLen,
-    );
-    const ifBlockStmts: binaryen.ExpressionRef[] = [];
-    ifBlockStmts.push(
-        module.if(
-            module.i32.eq(
-                binaryenCAPI._BinaryenArrayGet(
-                    module.ptr,
-                    maskArr,
-                    module.local.get(loopIdx, binaryen.i32),
-                    i8ArrayTypeInfo.typeRef,
-                    false,
-                ),
-                module.i32.const(0),
-            ),
-            module.block(null, [
-                module.local.set(
-                    tableIdx,
-                    module.local.get(loopIdx, binaryen.i32),
-                ),
-                module.br(loopBlock),
-            ]),
-        ),
-    );
-    loopStmts.push(module.block(null, ifBlockStmts));
-    loopStmts.push(
-        module.local.set(
-            loopIdx,
-            module.i32.add(
-                module.local.get(loopIdx, binaryen.i32),
-                module.i32.const(1),
-            ),
-        ),
-    );
-    loopStmts.push(module.br(loopLabel));
-    loopBlockStmts.push(
-        module.loop(
-            loopLabel,
-            module.if(loopCond, module.block(null, loopStmts)),
-        ),
-    );
-    stmts.push(module.block(loopBlock, loopBlockStmts));
-
-    const ifStmts2: binaryen.ExpressionRef[] = [];
-    ifStmts2.push(tableGrow);
-    ifStmts2.push(module.local.set(tableIdx, maskArrLen));
-    ifStmts2.push(module.local.set(tmpMaskArrIdx, newArray));
-    ifStmts2.push(
-        binaryenCAPI._BinaryenArrayCopy(
-            module.ptr,
-            module.local.get(tmpMaskArrIdx, i8ArrayTypeInfo.typeRef),
-            module.i32.const(0),
-            maskArr,
-            module.i32.const(0),
-            maskArrLen,
-        ),
-    );
-    ifStmts2.push(
-        binaryenCAPI._BinaryenGlobalSet(
-            module.ptr,
-            UtilFuncs.getCString(arrName),
-            module.local.get(tmpMaskArrIdx, i8ArrayTypeInfo.typeRef),
-        ),
-    );
-    stmts.push(
-        module.if(
-            module.i32.eq(
-                module.local.get(tableIdx, binaryen.i32),
-                module.i32.const(-1),
-            ),
-            module.block(null, ifStmts2),
-        ),
-    );
-    const tableSetOp = binaryenCAPI._BinaryenTableSet(
-        module.ptr,
-        UtilFuncs.getCString(BuiltinNames.extrefTable),
-        module.local.get(tableIdx, binaryen.i32),
-        module.local.get(objIdx, binaryen.anyref),
-    );
-    stmts.push(tableSetOp);
-    stmts.push(
-        binaryenCAPI._BinaryenArraySet(
-            module.ptr,
-            maskArr,
-            module.local.get(tableIdx, binaryen.i32),
-            module.i32.const(1),
-        ),
-    );
-
-    stmts.push(module.return(module.local.get(tableIdx, binaryen.i32)));
-    return module.block(null, stmts);
-}
-
-/** to extref with runtime getting table index */
+/** to extref, the runtime allocates the slot of the object */
 function newExtRef(module: binaryen.Module) {
     const _context_unused = 0;
     const objTagIdx = 1;
     const objIdx = 2;
 
-    /* alloc table slot */
-    const tableIdx = module.call(
-        getBuiltInFuncName(BuiltinNames.allocExtRefTableSlot),
-        [module.local.get(objIdx, binaryen.anyref)],
-        dyntype.int,
-    );
-
     /* create extref */
     const call = module.call(
         dyntype.dyntype_new_extref,
@@ -3410,7 +3255,7 @@ function newExtRef(module: binaryen.Module) {
                 UtilFuncs.getCString(dyntype.dyntype_context),
                 binaryen.anyref,
             ),
-            tableIdx,
+            module.local.get(objIdx, binaryen.anyref),
             module.local.get(objTagIdx, binaryen.i32),
         ],
         dyntype.dyn_value_t,
@@ -5269,13 +5114,6 @@ export function callBuiltInAPIs(module: binaryen.Module) {
         [],
         anyrefCond(module),
     );
-    module.addFunction(
-        getBuiltInFuncName(BuiltinNames.allocExtRefTableSlot),
-        binaryen.createType([binaryen.anyref]),
-        binaryen.i32,
-        [binaryen.i32, binaryen.i32, i8ArrayTypeInfo.typeRef],
-        allocExtRefTableSlot(module),
-    );
     module.addFunction(
         getBuiltInFuncName(BuiltinNames.newExtRef),
         binaryen.createType([
@@ -5287,10 +5125,6 @@ export function callBuiltInAPIs(module: binaryen.Module) {
         [],
         newExtRef(module),
     );
-    module.addFunctionExport(
-        getBuiltInFuncName(BuiltinNames.allocExtRefTableSlot),
-        BuiltinNames.allocExtRefTableSlot,
-    );
     module.addFunction(
         UtilFuncs.getFuncName(
             BuiltinNames.builtinModuleName,
@@ -5857,6 +5691,20 @@ export function callBuiltInAPIs(module: binaryen.Module) {
         [binaryen.anyref, binaryen.anyref],
         binaryen.anyref,
     );
+    module.addFunctionImport(
+        UtilFuncs.getFuncName(
+            BuiltinNames.builtinModuleName,
+            BuiltinNames.arraySortNumericFuncName,
+        ),
+        'env',
+        'array_sort_numeric',
+        binaryen.createType([
+            emptyStructType.typeRef,
+            binaryen.anyref,
+            binaryen.i32,
+        ]),
+        binaryen.anyref,
+    );
     addArrayMethod(
         module,
         'splice',
@@ -20,11 +20,29 @@ typedef struct MetaProperty {
     int type;
 } MetaProperty;
 
+/**
+ * MetaHashSlot is an entry of the property name hash table
+ * hash: FNV-1a hash of the property name
+ * index: index of the property in properties plus one, 0 means empty slot
+ */
+typedef struct MetaHashSlot {
+    unsigned int hash;
+    int index;
+} MetaHashSlot;
+
 /**
  * Meta record type id and the properties information of object
  * type_id: type id of the object
  * count: number of properties
  * properties: properties information
+ *
+ * The properties are followed by an open addressing hash table generated by
+ * the compiler:
+ *   int hash_mask;               slot count minus one, slot count is a power
+ *                                of two and at least twice the count
+ *   MetaHashSlot slots[hash_mask + 1];
+ * Properties with the same name are inserted in properties order, so the
+ * probe sequence finds them in that order too.
  */
 typedef struct Meta {
     int type_id;
@@ -45,42 +63,59 @@ enum propertyFlag {
 #define META_FLAG_MASK 0x0000000F
 #define META_INDEX_MASK 0xFFFFFFF0
 
-/* find property index based on prop_name*/
-int find_property_flag_and_index(Meta *meta, char *prop_name, enum propertyFlag flag) {
-    MetaProperty prop;
-    int target_flag = flag & META_FLAG_MASK;
-    int all_flag = ALL & META_FLAG_MASK;
+/* FNV-1a, must be kept in sync with the compiler */
+static inline unsigned int
+hash_property_name(const char *name)
+{
+    unsigned int hash = 2166136261u;
 
-    for (int i = 0; i < meta->count; i++) {
-        prop = meta->properties[i];
-        if (strcmp(prop.name, prop_name) == 0) {
-            if (target_flag == all_flag) {
-                return prop.flag_and_index;
-            } else if ((prop.flag_and_index & META_FLAG_MASK) == target_flag) {
-                return prop.flag_and_index;
-            }
-        }
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
     }
 
-    return -1;
+    return hash;
 }
 
-/* find property type based on prop_name*/
-int find_property_type(Meta *meta, char *prop_name, enum propertyFlag flag) {
-    MetaProperty prop;
+static inline MetaProperty *
+find_property(Meta *meta, char *prop_name, enum propertyFlag flag)
+{
+    int *hash_mask = (int *)&meta->properties[meta->count];
+    MetaHashSlot *slots = (MetaHashSlot *)(hash_mask + 1);
+    unsigned int hash = hash_property_name(prop_name);
+    unsigned int i = hash & *hash_mask;
     int target_flag = flag & META_FLAG_MASK;
     int all_flag = ALL & META_FLAG_MASK;
+    MetaProperty *prop;
 
-    for (int i = 0; i < meta->count; i++) {
-        prop = meta->properties[i];
-        if (strcmp(prop.name, prop_name) == 0) {
+    /* the table is at most half full, an empty slot ends the probe */
+    for (; slots[i].index != 0; i = (i + 1) & *hash_mask) {
+        if (slots[i].hash != hash) {
+            continue;
+        }
+        prop = &meta->properties[slots[i].index - 1];
+        if (strcmp(prop->name, prop_name) == 0) {
             if (target_flag == all_flag) {
-                return prop.type;
-            } else if ((prop.flag_and_index & META_FLAG_MASK) == target_flag) {
-                return prop.type;
+                return prop;
+            } else if ((prop->flag_and_index & META_FLAG_MASK) == target_flag) {
+                return prop;
             }
         }
     }
 
-    return -1;
+    return NULL;
+}
+
+/* find property index based on prop_name*/
+int find_property_flag_and_index(Meta *meta, char *prop_name, enum propertyFlag flag) {
+    MetaProperty *prop = find_property(meta, prop_name, flag);
+
+    return prop ? prop->flag_and_index : -1;
+}
+
+/* find property type based on prop_name*/
+int find_property_type(Meta *meta, char *prop_name, enum propertyFlag flag) {
+    MetaProperty *prop = find_property(meta, prop_name, flag);
+
+    return prop ? prop->type : -1;
 }
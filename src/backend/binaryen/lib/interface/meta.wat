@@ -11,185 +11,339 @@
   (local $4 i32)
   (local $5 i32)
   (local $6 i32)
+  (local $7 i32)
+  (local $8 i32)
+  (local $9 i32)
+  (local $10 i32)
+  (local.set $3
+   (i32.const -2128831035)
+  )
+  (local.set $7
+   (local.get $1)
+  )
   (block $label$1
-   (if
-    (i32.gt_s
-     (local.tee $4
-      (i32.load offset=8
-       (local.get $0)
+   (loop $label$2
+    (br_if $label$1
+     (i32.eqz
+      (local.tee $10
+       (i32.load8_u
+        (local.get $7)
+       )
       )
      )
-     (i32.const 0)
     )
-    (block
-     (local.set $0
-      (i32.add
-       (local.get $0)
-       (i32.const 16)
+    (local.set $3
+     (i32.mul
+      (i32.xor
+       (local.get $3)
+       (local.get $10)
       )
+      (i32.const 16777619)
      )
-     (local.set $6
-      (i32.eq
-       (local.tee $5
-        (i32.and
-         (local.get $2)
-         (i32.const 15)
+    )
+    (local.set $7
+     (i32.add
+      (local.get $7)
+      (i32.const 1)
+     )
+    )
+    (br $label$2)
+   )
+  )
+  (local.set $5
+   (i32.add
+    (local.tee $7
+     (i32.add
+      (local.get $0)
+      (i32.add
+       (i32.mul
+        (i32.load offset=8
+         (local.get $0)
         )
+        (i32.const 12)
        )
-       (i32.const 4)
+       (i32.const 12)
       )
      )
-     (loop $label$3
-      (local.set $2
-       (i32.load
-        (local.get $0)
-       )
-      )
-      (if
-       (i32.eqz
-        (call $strcmp
-         (i32.load
-          (i32.sub
-           (local.get $0)
-           (i32.const 4)
-          )
+    )
+    (i32.const 4)
+   )
+  )
+  (local.set $6
+   (i32.and
+    (local.get $3)
+    (local.tee $4
+     (i32.load
+      (local.get $7)
+     )
+    )
+   )
+  )
+  (local.set $8
+   (i32.eq
+    (local.tee $9
+     (i32.and
+      (local.get $2)
+      (i32.const 15)
+     )
+    )
+    (i32.const 4)
+   )
+  )
+  (loop $label$3
+   (if
+    (i32.eqz
+     (local.tee $10
+      (i32.load offset=4
+       (local.tee $7
+        (i32.add
+         (local.get $5)
+         (i32.shl
+          (local.get $6)
+          (i32.const 3)
          )
-         (local.get $1)
         )
        )
-       (block
-        (br_if $label$1
-         (local.get $6)
-        )
-        (br_if $label$1
-         (i32.eq
-          (i32.and
-           (local.get $2)
-           (i32.const 15)
+      )
+     )
+    )
+    (return
+     (i32.const -1)
+    )
+   )
+   (if
+    (i32.eq
+     (i32.load
+      (local.get $7)
+     )
+     (local.get $3)
+    )
+    (if
+     (i32.eqz
+      (call $strcmp
+       (i32.load
+        (local.tee $7
+         (i32.add
+          (local.get $0)
+          (i32.mul
+           (local.get $10)
+           (i32.const 12)
           )
-          (local.get $5)
          )
         )
        )
+       (local.get $1)
       )
-      (local.set $0
-       (i32.add
-        (local.get $0)
-        (i32.const 12)
+     )
+     (block
+      (if
+       (local.get $8)
+       (return
+        (i32.load offset=4
+         (local.get $7)
+        )
        )
       )
-      (br_if $label$3
-       (i32.lt_s
-        (local.tee $3
-         (i32.add
-          (local.get $3)
-          (i32.const 1)
+      (if
+       (i32.eq
+        (i32.and
+         (i32.load offset=4
+          (local.get $7)
          )
+         (i32.const 15)
+        )
+        (local.get $9)
+       )
+       (return
+        (i32.load offset=4
+         (local.get $7)
         )
-        (local.get $4)
        )
       )
      )
     )
    )
-   (local.set $2
-    (i32.const -1)
+   (local.set $6
+    (i32.and
+     (i32.add
+      (local.get $6)
+      (i32.const 1)
+     )
+     (local.get $4)
+    )
    )
+   (br $label$3)
   )
-  (local.get $2)
+  (unreachable)
  )
  (func $find_property_type (param $0 i32) (param $1 i32) (param $2 i32) (result i32)
   (local $3 i32)
   (local $4 i32)
   (local $5 i32)
+  (local $6 i32)
+  (local $7 i32)
+  (local $8 i32)
+  (local $9 i32)
+  (local $10 i32)
+  (local.set $3
+   (i32.const -2128831035)
+  )
+  (local.set $7
+   (local.get $1)
+  )
   (block $label$1
-   (if
-    (i32.gt_s
-     (local.tee $4
-      (i32.load offset=8
-       (local.get $0)
+   (loop $label$2
+    (br_if $label$1
+     (i32.eqz
+      (local.tee $10
+       (i32.load8_u
+        (local.get $7)
+       )
       )
      )
-     (i32.const 0)
     )
-    (block
-     (local.set $0
-      (i32.add
-       (local.get $0)
-       (i32.const 20)
+    (local.set $3
+     (i32.mul
+      (i32.xor
+       (local.get $3)
+       (local.get $10)
       )
+      (i32.const 16777619)
      )
-     (local.set $5
-      (i32.eq
-       (local.tee $2
-        (i32.and
-         (local.get $2)
-         (i32.const 15)
+    )
+    (local.set $7
+     (i32.add
+      (local.get $7)
+      (i32.const 1)
+     )
+    )
+    (br $label$2)
+   )
+  )
+  (local.set $5
+   (i32.add
+    (local.tee $7
+     (i32.add
+      (local.get $0)
+      (i32.add
+       (i32.mul
+        (i32.load offset=8
+         (local.get $0)
         )
+        (i32.const 12)
        )
-       (i32.const 4)
+       (i32.const 12)
       )
      )
-     (loop $label$3
-      (if
-       (i32.eqz
-        (call $strcmp
-         (i32.load
-          (i32.sub
-           (local.get $0)
-           (i32.const 8)
-          )
+    )
+    (i32.const 4)
+   )
+  )
+  (local.set $6
+   (i32.and
+    (local.get $3)
+    (local.tee $4
+     (i32.load
+      (local.get $7)
+     )
+    )
+   )
+  )
+  (local.set $8
+   (i32.eq
+    (local.tee $9
+     (i32.and
+      (local.get $2)
+      (i32.const 15)
+     )
+    )
+    (i32.const 4)
+   )
+  )
+  (loop $label$3
+   (if
+    (i32.eqz
+     (local.tee $10
+      (i32.load offset=4
+       (local.tee $7
+        (i32.add
+         (local.get $5)
+         (i32.shl
+          (local.get $6)
+          (i32.const 3)
          )
-         (local.get $1)
         )
        )
-       (block
-        (br_if $label$1
-         (local.get $5)
-        )
-        (br_if $label$1
-         (i32.eq
-          (i32.and
-           (i32.load
-            (i32.sub
-             (local.get $0)
-             (i32.const 4)
-            )
-           )
-           (i32.const 15)
+      )
+     )
+    )
+    (return
+     (i32.const -1)
+    )
+   )
+   (if
+    (i32.eq
+     (i32.load
+      (local.get $7)
+     )
+     (local.get $3)
+    )
+    (if
+     (i32.eqz
+      (call $strcmp
+       (i32.load
+        (local.tee $7
+         (i32.add
+          (local.get $0)
+          (i32.mul
+           (local.get $10)
+           (i32.const 12)
           )
-          (local.get $2)
          )
         )
        )
+       (local.get $1)
       )
-      (local.set $0
-       (i32.add
-        (local.get $0)
-        (i32.const 12)
+     )
+     (block
+      (if
+       (local.get $8)
+       (return
+        (i32.load offset=8
+         (local.get $7)
+        )
        )
       )
-      (br_if $label$3
-       (i32.lt_s
-        (local.tee $3
-         (i32.add
-          (local.get $3)
-          (i32.const 1)
+      (if
+       (i32.eq
+        (i32.and
+         (i32.load offset=4
+          (local.get $7)
          )
+         (i32.const 15)
+        )
+        (local.get $9)
+       )
+       (return
+        (i32.load offset=8
+         (local.get $7)
         )
-        (local.get $4)
        )
       )
      )
     )
    )
-   (return
-    (i32.const -1)
+   (local.set $6
+    (i32.and
+     (i32.add
+      (local.get $6)
+      (i32.const 1)
+     )
+     (local.get $4)
+    )
    )
+   (br $label$3)
   )
-  (i32.load
-   (local.get $0)
-  )
+  (unreachable)
  )
 )
-
@@ -140,6 +140,12 @@ export const enum NativeSignatureConversion {
 
 export const META_FLAG_MASK = 0x0000000f;
 export const META_INDEX_MASK = 0xfffffff0;
+/* layout version of the Meta data, the runtime reads the Meta directly and
+    rejects modules with another version, bump it when the layout changes */
+export const META_VERSION = 1;
+/* an extref handle is the index of its slot in the extref_slots array, the
+    high bits hold the generation of the slot, see wamr_utils.c */
+export const EXTREF_INDEX_MASK = 0x00ffffff;
 
 export namespace UtilFuncs {
     export function getFuncName(
@@ -250,6 +256,17 @@ export namespace UtilFuncs {
 
         return utf8String;
     }
+
+    /* FNV-1a of the utf8 bytes, must be kept in sync with meta.c */
+    export function hashPropertyName(name: string): number {
+        const utf8Str = utf16ToUtf8(name);
+        let hash = 0x811c9dc5;
+        for (let i = 0; i < utf8Str.length; i++) {
+            hash ^= utf8Str.charCodeAt(i);
+            hash = Math.imul(hash, 0x01000193);
+        }
+        return hash >>> 0;
+    }
 }
 
 export namespace FunctionalFuncs {
@@ -569,7 +586,7 @@ export namespace FunctionalFuncs {
         dynValue: binaryen.ExpressionRef,
         tagRef: binaryen.ExpressionRef,
     ) {
-        /* table type is anyref, no need to cast */
+        /* slot type is anyref, no need to cast */
         const dynFuncName: string = getBuiltInFuncName(BuiltinNames.newExtRef);
         /* call newExtRef */
         const newExternRef = module.call(
@@ -960,18 +977,29 @@ export namespace FunctionalFuncs {
         anyExprRef: binaryen.ExpressionRef,
     ) {
         /* unbox to externalRef */
-        const tableIndex = module.call(
+        const handle = module.call(
             dyntype.dyntype_to_extref,
             [getDynContextRef(module), anyExprRef],
             dyntype.int,
         );
-        const externalRef = module.table.get(
-            BuiltinNames.extrefTable,
-            tableIndex,
+
+        return getExtrefSlot(module, handle);
+    }
+
+    export function getExtrefSlot(
+        module: binaryen.Module,
+        handle: binaryen.ExpressionRef,
+    ) {
+        return binaryenCAPI._BinaryenArrayGet(
+            module.ptr,
+            module.global.get(
+                BuiltinNames.extrefSlots,
+                anyArrayTypeInfo.typeRef,
+            ),
+            module.i32.and(handle, module.i32.const(EXTREF_INDEX_MASK)),
             binaryen.anyref,
+            false,
         );
-
-        return externalRef;
     }
 
     export function unboxAnyToExtref(
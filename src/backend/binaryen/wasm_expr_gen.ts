@@ -99,6 +99,7 @@ import {
 import { UnimplementError } from '../../error.js';
 import {
     FunctionDeclareNode,
+    ReturnNode,
     SemanticsKind,
     VarDeclareNode,
 } from '../../semantics/semantics_nodes.js';
@@ -1311,6 +1312,89 @@ export class WASMExpressionGen {
         return this.callClosureInternal(closureRef, funcType, value.parameters);
     }
 
+    /** 1 for (a, b) => a - b, -1 for (a, b) => b - a, 0 for other comparators */
+    private getNumericComparatorOrder(
+        comparator: SemanticsValue,
+        elemType: ValueType,
+    ) {
+        if (
+            !(comparator instanceof NewClosureFunction) ||
+            (elemType.kind !== ValueTypeKind.NUMBER &&
+                elemType.kind !== ValueTypeKind.INT)
+        ) {
+            return 0;
+        }
+        const funcNode = comparator.funcNode;
+        const params = funcNode.parameters;
+        const stmts = funcNode.body.statements;
+        if (
+            !params ||
+            params.length !== 2 ||
+            params.some((p) => p.type.kind !== elemType.kind) ||
+            stmts.length !== 1 ||
+            !(stmts[0] instanceof ReturnNode)
+        ) {
+            return 0;
+        }
+        const expr = (stmts[0] as ReturnNode).expr;
+        if (
+            !(expr instanceof BinaryExprValue) ||
+            expr.opKind !== ts.SyntaxKind.MinusToken ||
+            !(expr.left instanceof VarValue) ||
+            !(expr.right instanceof VarValue)
+        ) {
+            return 0;
+        }
+        if (expr.left.ref === params[0] && expr.right.ref === params[1]) {
+            return 1;
+        }
+        if (expr.left.ref === params[1] && expr.right.ref === params[0]) {
+            return -1;
+        }
+        return 0;
+    }
+
+    private callArraySortNumeric(
+        calledName: string,
+        thisRef: binaryen.ExpressionRef,
+        valueType: ValueType,
+        args?: SemanticsValue[],
+    ) {
+        if (
+            calledName !==
+                UtilFuncs.getFuncName(
+                    BuiltinNames.builtinModuleName,
+                    BuiltinNames.arraySortFuncNames.generic,
+                ) ||
+            !(valueType instanceof ArrayType) ||
+            !args ||
+            args.length !== 1
+        ) {
+            return undefined;
+        }
+        const elemType =
+            valueType.specialTypeArguments &&
+            valueType.specialTypeArguments.length > 0
+                ? valueType.specialTypeArguments[0]
+                : valueType.element;
+        const order = this.getNumericComparatorOrder(args[0], elemType);
+        if (order === 0) {
+            return undefined;
+        }
+        return this.module.call(
+            UtilFuncs.getFuncName(
+                BuiltinNames.builtinModuleName,
+                BuiltinNames.arraySortNumericFuncName,
+            ),
+            [
+                this.wasmCompiler.emptyRef,
+                thisRef,
+                this.module.i32.const(order < 0 ? 1 : 0),
+            ],
+            binaryen.anyref,
+        );
+    }
+
     private callClassMethod(
         methodType: FunctionType,
         realReturnType: ValueType,
@@ -1319,6 +1403,14 @@ export class WASMExpressionGen {
         valueType: ValueType,
         args?: SemanticsValue[],
     ): binaryen.ExpressionRef {
+        /* sort natively without calling back for each comparison */
+        const sortNumeric = this.callArraySortNumeric(
+            calledName,
+            thisRef,
+            valueType,
+            args,
+        );
+
         if (BuiltinNames.genericBuiltinMethods.includes(calledName)) {
             if (valueType instanceof ArrayType) {
                 const methodSuffix =
@@ -1335,15 +1427,17 @@ export class WASMExpressionGen {
             methodType.returnType,
         );
 
-        let res = this.callFunc(
-            methodType,
-            calledName,
-            returnTypeRef,
-            args,
-            undefined,
-            undefined,
-            thisRef,
-        );
+        let res =
+            sortNumeric ??
+            this.callFunc(
+                methodType,
+                calledName,
+                returnTypeRef,
+                args,
+                undefined,
+                undefined,
+                thisRef,
+            );
 
         /* methodCallResultRef's type may not match the real return type
          * if real return type is not primitive type, we should do cast.
@@ -116,3 +116,12 @@ export function anyCmpNum() {
         console.log('Greater than 11');
     }
 }
+
+export function anyCmpNaN() {
+    const a: any = NaN;
+    const b: any = NaN;
+    console.log(a == b);
+    console.log(a === a);
+    console.log(a <= b);
+    console.log(a != a);
+}
@@ -65,4 +65,55 @@ export function array_includes_interface() {
      console.log(arr.includes(A3, 0));          // false
     console.log(arr.includes(A1, 0.5));         // true
     console.log(arr.includes(A1, undefined));   // true
-}
\ No newline at end of file
+}
+
+/* lengths around the vector widths (2, 4 and 8 elements) */
+export function array_includes_lengths() {
+    let ok = true;
+    for (let len = 0; len <= 17; len++) {
+        const nums: number[] = [];
+        const ints: i32[] = [];
+        for (let i = 0; i < len; i++) {
+            nums.push(i * 2);
+            ints.push(i * 2);
+        }
+        for (let i = 0; i < len; i++) {
+            if (
+                !nums.includes(i * 2, 0) ||
+                !ints.includes(i * 2, 0) ||
+                nums.includes(i * 2, i + 1) ||
+                ints.includes(i * 2, i + 1)
+            ) {
+                console.log(len, i);
+                ok = false;
+            }
+        }
+        if (nums.includes(1, 0) || ints.includes(1, 0)) {
+            console.log(len);
+            ok = false;
+        }
+    }
+    console.log(ok); // true
+}
+
+export function array_includes_nan_zero() {
+    /* SameValueZero: NaN finds NaN, -0 and +0 find each other */
+    const arr: number[] = [1, NaN, -0, 3, 5, 6, 7, 8, 9];
+    console.log(arr.includes(NaN, 0)); // true
+    console.log(arr.includes(NaN, 2)); // false
+    console.log(arr.includes(0, 0)); // true
+    console.log(arr.includes(-0, 0)); // true
+    console.log(arr.includes(0, 3)); // false
+
+    const long: number[] = [];
+    for (let i = 0; i < 20; i++) {
+        long.push(i + 1);
+    }
+    console.log(long.includes(NaN, 0)); // false
+    console.log(long.includes(0, 0)); // false
+    long[13] = NaN;
+    long[17] = -0;
+    console.log(long.includes(NaN, 0)); // true
+    console.log(long.includes(NaN, 14)); // false
+    console.log(long.includes(0, 14)); // true
+}
@@ -31,4 +31,55 @@ export function array_indexOf_class() {
     let array1: A[] = [a1, a2];
     let index: number = array1.indexOf(a2, 0);
     return index; // 1
-}
\ No newline at end of file
+}
+
+/* lengths around the vector widths (2, 4 and 8 elements) */
+export function array_indexOf_lengths() {
+    let ok = true;
+    for (let len = 0; len <= 17; len++) {
+        const nums: number[] = [];
+        const ints: i32[] = [];
+        const same: number[] = [];
+        for (let i = 0; i < len; i++) {
+            nums.push(i * 2);
+            ints.push(i * 2);
+            same.push(7);
+        }
+        for (let i = 0; i < len; i++) {
+            if (
+                nums.indexOf(i * 2, 0) !== i ||
+                ints.indexOf(i * 2, 0) !== i ||
+                nums.indexOf(i * 2, i + 1) !== -1 ||
+                ints.indexOf(i * 2, i + 1) !== -1 ||
+                same.indexOf(7, i) !== i
+            ) {
+                console.log(len, i);
+                ok = false;
+            }
+        }
+        if (nums.indexOf(1, 0) !== -1 || ints.indexOf(1, 0) !== -1) {
+            console.log(len);
+            ok = false;
+        }
+    }
+    console.log(ok); // true
+}
+
+export function array_indexOf_nan_zero() {
+    const arr: number[] = [1, NaN, -0, 3, NaN, 0, 5, 6, 7];
+    console.log(arr.indexOf(NaN, 0)); // -1
+    console.log(arr.indexOf(0, 0)); // 2
+    console.log(arr.indexOf(-0, 0)); // 2
+    console.log(arr.indexOf(0, 3)); // 5
+    console.log(arr.indexOf(-0, 3)); // 5
+
+    const long: number[] = [];
+    for (let i = 0; i < 20; i++) {
+        long.push(NaN);
+    }
+    console.log(long.indexOf(NaN, 0)); // -1
+    long[13] = -0;
+    console.log(long.indexOf(0, 0)); // 13
+    long[17] = 0;
+    console.log(long.indexOf(-0, 14)); // 17
+}
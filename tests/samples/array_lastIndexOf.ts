@@ -32,4 +32,57 @@ export function array_lastIndexOf_class() {
     let array1: A[] = [a1, a2, a3];
     let index: number = array1.lastIndexOf(a3, 0);
     return index; // 2
-}
\ No newline at end of file
+}
+
+/* lengths around the vector widths (2, 4 and 8 elements) */
+export function array_lastIndexOf_lengths() {
+    let ok = true;
+    for (let len = 0; len <= 17; len++) {
+        const nums: number[] = [];
+        const ints: i32[] = [];
+        const same: number[] = [];
+        for (let i = 0; i < len; i++) {
+            nums.push(i * 2);
+            ints.push(i * 2);
+            same.push(7);
+        }
+        for (let i = 0; i < len; i++) {
+            if (
+                nums.lastIndexOf(i * 2, -1) !== i ||
+                ints.lastIndexOf(i * 2, -1) !== i ||
+                same.lastIndexOf(7, i - len) !== i ||
+                /* a fromIndex of 0 searches the whole array here */
+                (i > 1 &&
+                    (nums.lastIndexOf(i * 2, i - 1) !== -1 ||
+                        ints.lastIndexOf(i * 2, i - 1) !== -1))
+            ) {
+                console.log(len, i);
+                ok = false;
+            }
+        }
+        if (nums.lastIndexOf(1, -1) !== -1 || ints.lastIndexOf(1, -1) !== -1) {
+            console.log(len);
+            ok = false;
+        }
+    }
+    console.log(ok); // true
+}
+
+export function array_lastIndexOf_nan_zero() {
+    const arr: number[] = [1, NaN, -0, 3, NaN, 0, 5, 6, 7];
+    console.log(arr.lastIndexOf(NaN, -1)); // -1
+    console.log(arr.lastIndexOf(0, -1)); // 5
+    console.log(arr.lastIndexOf(-0, -1)); // 5
+    console.log(arr.lastIndexOf(0, 4)); // 2
+    console.log(arr.lastIndexOf(-0, 4)); // 2
+
+    const long: number[] = [];
+    for (let i = 0; i < 20; i++) {
+        long.push(NaN);
+    }
+    console.log(long.lastIndexOf(NaN, -1)); // -1
+    long[3] = -0;
+    console.log(long.lastIndexOf(0, -1)); // 3
+    long[1] = 0;
+    console.log(long.lastIndexOf(-0, 2)); // 1
+}
@@ -13,4 +13,362 @@ export function array_sort_number() {
         console.log(idx, ":", val);
     });
 
-}
\ No newline at end of file
+}
+
+/* deterministic input large enough for the radix sort */
+function numberInput(len: number) {
+    const arr: number[] = [];
+    let seed = 1;
+    for (let i = 0; i < len; i++) {
+        seed = (seed * 75 + 74) % 65537;
+        /* duplicates, negatives and fractions */
+        arr.push((seed % 200) / 4 - 25);
+    }
+    return arr;
+}
+
+function intInput(len: number) {
+    const arr: i32[] = [];
+    let seed: i32 = 1;
+    for (let i = 0; i < len; i++) {
+        seed = (seed * 75 + 74) % 65537;
+        arr.push((seed % 200) - 100);
+    }
+    return arr;
+}
+
+function sameNumbers(a: number[], b: number[]) {
+    if (a.length !== b.length) {
+        return false;
+    }
+    for (let i = 0; i < a.length; i++) {
+        if (a[i] !== b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+function intsToNumbers(arr: i32[]) {
+    const res: number[] = [];
+    for (let i = 0; i < arr.length; i++) {
+        res.push(arr[i]);
+    }
+    return res;
+}
+
+/* 1 for +0, -1 for -0 */
+function zeroSigns(arr: number[]) {
+    const res: number[] = [];
+    for (let i = 0; i < arr.length; i++) {
+        if (arr[i] === 0) {
+            res.push(1 / arr[i] < 0 ? -1 : 1);
+        }
+    }
+    return res;
+}
+
+function nanCountAtEnd(arr: number[]) {
+    let count = 0;
+    for (let i = arr.length - 1; i >= 0 && arr[i] !== arr[i]; i--) {
+        count++;
+    }
+    return count;
+}
+
+export function array_sort_number_canonical() {
+    const small: number[] = [3, -1.5, 8, 3, 0, -7, 8, 2.25];
+    small.sort((a, b) => a - b);
+    console.log(small);
+    small.sort((a, b) => b - a);
+    console.log(small);
+
+    /* the reference comparators aren't canonical, they take the generic
+     * path */
+    const lens = [63, 64, 1000];
+    for (let j = 0; j < lens.length; j++) {
+        const len = lens[j];
+        const asc = numberInput(len);
+        const ascRef = numberInput(len);
+        asc.sort((a, b) => a - b);
+        ascRef.sort((a, b) => (a < b ? -1 : a > b ? 1 : 0));
+        const desc = numberInput(len);
+        const descRef = numberInput(len);
+        desc.sort((a, b) => b - a);
+        descRef.sort((a, b) => (a > b ? -1 : a < b ? 1 : 0));
+        console.log(
+            len,
+            sameNumbers(asc, ascRef),
+            sameNumbers(desc, descRef),
+            asc[0],
+            asc[len - 1],
+            desc[0],
+        );
+    }
+}
+
+export function array_sort_int_canonical() {
+    const small: i32[] = [3, -1, 8, 3, 0, -7, 8, 2];
+    small.sort((a, b) => a - b);
+    console.log(intsToNumbers(small));
+    small.sort((a, b) => b - a);
+    console.log(intsToNumbers(small));
+
+    const lens = [63, 64, 1000];
+    for (let j = 0; j < lens.length; j++) {
+        const len = lens[j];
+        const asc = intInput(len);
+        const ascRef = intInput(len);
+        asc.sort((a, b) => a - b);
+        ascRef.sort((a, b) => (a < b ? -1 : a > b ? 1 : 0));
+        const desc = intInput(len);
+        const descRef = intInput(len);
+        desc.sort((a, b) => b - a);
+        descRef.sort((a, b) => (a > b ? -1 : a < b ? 1 : 0));
+        console.log(
+            len,
+            sameNumbers(intsToNumbers(asc), intsToNumbers(ascRef)),
+            sameNumbers(intsToNumbers(desc), intsToNumbers(descRef)),
+            asc[0],
+            asc[len - 1],
+            desc[0],
+        );
+    }
+}
+
+export function array_sort_number_signed_zero() {
+    /* -0 and +0 compare equal and keep their order */
+    const small: number[] = [0, -0, 3, -0, 0, -1];
+    small.sort((a, b) => a - b);
+    console.log(small, zeroSigns(small));
+    small.sort((a, b) => b - a);
+    console.log(small, zeroSigns(small));
+
+    const large: number[] = [];
+    for (let i = 0; i < 100; i++) {
+        large.push(i % 3 === 0 ? -0 : i % 3 === 1 ? 0 : i - 50);
+    }
+    const before = zeroSigns(large);
+    large.sort((a, b) => a - b);
+    console.log(sameNumbers(zeroSigns(large), before));
+    large.sort((a, b) => b - a);
+    console.log(sameNumbers(zeroSigns(large), before));
+}
+
+export function array_sort_number_nan() {
+    /* NaNs are placed last in both orders */
+    const small: number[] = [3, NaN, 1, NaN, 2];
+    small.sort((a, b) => a - b);
+    console.log(small[0], small[1], small[2], nanCountAtEnd(small));
+    small.sort((a, b) => b - a);
+    console.log(small[0], small[1], small[2], nanCountAtEnd(small));
+
+    const large = numberInput(100);
+    for (let i = 0; i < large.length; i += 10) {
+        large[i] = NaN;
+    }
+    large.sort((a, b) => a - b);
+    console.log(nanCountAtEnd(large), large[0], large[89]);
+    large.sort((a, b) => b - a);
+    console.log(nanCountAtEnd(large), large[0], large[89]);
+}
+
+export function array_sort_number_other_comparator() {
+    /* not the canonical form, so the comparator is called */
+    const arr: number[] = [21, 12, 31, 2, 11];
+    arr.sort((a, b) => (a % 10) - (b % 10));
+    console.log(arr);
+
+    let calls = 0;
+    arr.sort((a, b) => {
+        calls++;
+        return a - b;
+    });
+    console.log(arr, calls > 0);
+
+    const ints: i32[] = [21, 12, 31, 2, 11];
+    ints.sort((a, b) => (a % 10) - (b % 10));
+    console.log(intsToNumbers(ints));
+}
+
+class SortItem {
+    key: number;
+    order: number;
+
+    constructor(key: number, order: number) {
+        this.key = key;
+        this.order = order;
+    }
+}
+
+/* keys ascending, equal keys in their original order */
+function isStablySorted(arr: SortItem[]) {
+    for (let i = 1; i < arr.length; i++) {
+        const prev = arr[i - 1];
+        const cur = arr[i];
+        if (
+            prev.key > cur.key ||
+            (prev.key === cur.key && prev.order > cur.order)
+        ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+function isSorted(arr: number[]) {
+    for (let i = 1; i < arr.length; i++) {
+        if (arr[i - 1] > arr[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+function sum(arr: number[]) {
+    let res = 0;
+    for (let i = 0; i < arr.length; i++) {
+        res += arr[i];
+    }
+    return res;
+}
+
+export function array_sort_stable() {
+    const lens = [10, 65, 1000];
+    for (let j = 0; j < lens.length; j++) {
+        const len = lens[j];
+        const items: SortItem[] = [];
+        let seed = 7;
+        for (let i = 0; i < len; i++) {
+            seed = (seed * 75 + 74) % 65537;
+            items.push(new SortItem(seed % 5, i));
+        }
+        let garbage = new SortItem(0, 0);
+        items.sort((a, b) => {
+            /* allocate while elements sit in the merge buffer */
+            garbage = new SortItem(a.key, b.key);
+            return a.key - b.key;
+        });
+        console.log(len, isStablySorted(items), garbage.order < 5);
+
+        /* descending in steps of 4, equal keys must not be reversed */
+        const desc: SortItem[] = [];
+        for (let i = 0; i < len; i++) {
+            desc.push(new SortItem(len - (i - (i % 4)) / 4, i));
+        }
+        desc.sort((a, b) => a.key - b.key);
+        console.log(len, isStablySorted(desc));
+    }
+}
+
+export function array_sort_patterns() {
+    const len = 1000;
+    let calls = 0;
+    /* a comparator variable, so the generic path is taken */
+    const cmp = (a: number, b: number) => {
+        calls++;
+        return a < b ? -1 : a > b ? 1 : 0;
+    };
+
+    const sorted: number[] = [];
+    for (let i = 0; i < len; i++) {
+        sorted.push(i);
+    }
+    sorted.sort(cmp);
+    /* a single run, found with len - 1 comparisons */
+    console.log(isSorted(sorted), calls === len - 1);
+
+    const reversed: number[] = [];
+    for (let i = 0; i < len; i++) {
+        reversed.push(len - i);
+    }
+    calls = 0;
+    reversed.sort(cmp);
+    console.log(
+        isSorted(reversed),
+        reversed[0],
+        reversed[len - 1],
+        calls === len - 1,
+    );
+
+    const dups: number[] = [];
+    let seed = 5;
+    for (let i = 0; i < len; i++) {
+        seed = (seed * 75 + 74) % 65537;
+        dups.push(seed % 4);
+    }
+    const dupsSum = sum(dups);
+    dups.sort(cmp);
+    console.log(isSorted(dups), sum(dups) === dupsSum, dups[0], dups[len - 1]);
+
+    /* descending with duplicates isn't a strictly descending run */
+    const reversedDups: number[] = [];
+    for (let i = 0; i < len; i++) {
+        reversedDups.push((len - i - ((len - i) % 2)) / 2);
+    }
+    reversedDups.sort(cmp);
+    console.log(isSorted(reversedDups), reversedDups[0], reversedDups[len - 1]);
+
+    /* ascending runs of 100 merged with galloping */
+    const sawtooth: number[] = [];
+    for (let i = 0; i < len; i++) {
+        sawtooth.push(i % 100);
+    }
+    sawtooth.sort(cmp);
+    console.log(isSorted(sawtooth), sawtooth[0], sawtooth[len - 1]);
+}
+
+export function array_sort_string() {
+    const words = [
+        'pear',
+        'fig',
+        'banana',
+        'kiwi',
+        'apple',
+        'plum',
+        'cherry',
+        'date',
+    ];
+    const arr: string[] = [];
+    let seed = 3;
+    for (let i = 0; i < 1000; i++) {
+        seed = (seed * 75 + 74) % 65537;
+        arr.push(words[seed % 8]);
+    }
+    const counts: number[] = [];
+    for (let i = 0; i < words.length; i++) {
+        let count = 0;
+        for (let j = 0; j < arr.length; j++) {
+            if (arr[j] === words[i]) {
+                count++;
+            }
+        }
+        counts.push(count);
+    }
+
+    arr.sort((a, b) => {
+        /* new strings while the elements sit in the merge buffer */
+        const x = a + '!';
+        const y = b + '!';
+        return x.length - y.length;
+    });
+
+    let ok = true;
+    for (let i = 1; i < arr.length; i++) {
+        if (arr[i - 1].length > arr[i].length) {
+            ok = false;
+        }
+    }
+    for (let i = 0; i < words.length; i++) {
+        let count = 0;
+        for (let j = 0; j < arr.length; j++) {
+            if (arr[j] === words[i]) {
+                count++;
+            }
+        }
+        if (count !== counts[i]) {
+            ok = false;
+        }
+    }
+    console.log(ok, arr[0], arr[arr.length - 1]);
+}
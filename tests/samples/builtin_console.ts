@@ -20,3 +20,16 @@ export function specialNum() {
     console.log(b);
     console.log(c);
 }
+
+export function logStaticArrays() {
+    const nums: number[] = [1, 2.5, -3];
+    const bools: boolean[] = [true, false];
+    const ints: i32[] = [1, 0, 2];
+    const anys: any[] = [1, 'hi', true];
+
+    console.log(nums);
+    console.log(bools);
+    console.log(ints);
+    console.log(anys);
+    console.log(nums, ints);
+}